@@ -16,7 +16,14 @@ const $loaded = Symbol('loaded')
  */
 
 /**
- * @typedef {{ abi: number, loaded: number }} ExtensionStats
+ * @typedef {{
+ *   releases: number,
+ *   allocations: number,
+ *   destructors: number,
+ *   bytes: number,
+ *   blocks: number
+ * }} ExtensionMemoryStats
+ * @typedef {{ abi: number, loaded: number, memory: ExtensionMemoryStats }} ExtensionStats
  */
 
 /**
@@ -36,6 +36,15 @@ export const kOpening = Symbol.for('fs.FileHandle.opening')
 export const kClosing = Symbol.for('fs.FileHandle.closing')
 export const kClosed = Symbol.for('fs.FileHandle.closed')
 
+// a `Buffer` view of the memory of `buffer`, which is not copied
+function toBufferView (buffer) {
+  if (Buffer.isBuffer(buffer) || buffer instanceof ArrayBuffer) {
+    return Buffer.from(buffer)
+  }
+
+  return Buffer.from(buffer.buffer, buffer.byteOffset, buffer.byteLength)
+}
+
 /**
  * A container for a descriptor tracked in `fds` and opened in the native layer.
  * This class implements the Node.js `FileHandle` interface
@@ -45,6 +54,8 @@ export class FileHandle extends EventEmitter {
   static get DEFAULT_ACCESS_MODE () { return F_OK }
   static get DEFAULT_OPEN_FLAGS () { return 'r' }
   static get DEFAULT_OPEN_MODE () { return 0o666 }
+  static get DEFAULT_WRITE_BEHIND_SIZE () { return 64 * 1024 }
+  static get DEFAULT_READ_AHEAD_CHUNKS () { return 4 }
 
   /**
    * Creates a `FileHandle` from a given `id` or `fd`
@@ -351,17 +362,26 @@ export class FileHandle extends EventEmitter {
   }
 
   /**
+   * Writes the data of the underlying file to its storage device. This is
+   * the same as `FileHandle#sync()`.
    * @param {object=} [options]
    */
-  async datasync () {
-    if (this.closing || this.closed) {
-      throw new Error('FileHandle is not opened')
-    }
+  async datasync (options) {
+    return await this.sync(options)
   }
 
   /**
    * Opens the underlying descriptor for the file handle.
    * @param {object=} [options]
+   * @param {boolean|object=} [options.writeBehind] - Hold small writes and
+   *   write those that follow each other together, see `fs.setWriteBehind`
+   * @param {number=} [options.writeBehind.size = 65536] - Bytes held before
+   *   they are written
+   * @param {number=} [options.writeBehind.delay] - Milliseconds a write is
+   *   held at most
+   * @param {boolean|number=} [options.readAhead] - Read chunks ahead once the
+   *   file is read sequentially, see `fs.setReadAhead`. A number is how many
+   *   chunks, 4 by default.
    */
   async open (options) {
     if (this.closing) {
@@ -403,6 +423,39 @@ export class FileHandle extends EventEmitter {
 
     fds.set(this.id, this.fd, 'file')
 
+    if (options?.writeBehind) {
+      const writeBehind = typeof options.writeBehind === 'object'
+        ? options.writeBehind
+        : {}
+
+      const params = {
+        id,
+        size: writeBehind.size ?? FileHandle.DEFAULT_WRITE_BEHIND_SIZE
+      }
+
+      if (typeof writeBehind.delay === 'number') {
+        params.delay = writeBehind.delay
+      }
+
+      const result = await ipc.request('fs.setWriteBehind', params, options)
+
+      if (result.err) {
+        return this[kOpening].reject(result.err)
+      }
+    }
+
+    if (options?.readAhead) {
+      const chunks = typeof options.readAhead === 'number'
+        ? options.readAhead
+        : FileHandle.DEFAULT_READ_AHEAD_CHUNKS
+
+      const result = await ipc.request('fs.setReadAhead', { id, chunks }, options)
+
+      if (result.err) {
+        return this[kOpening].reject(result.err)
+      }
+    }
+
     this[kOpening].resolve(true)
 
     this.emit('open', this.fd)
@@ -579,12 +632,91 @@ export class FileHandle extends EventEmitter {
   }
 
   /**
+   * Reads from the underlying file at `position` into each of `buffers`, in
+   * order, with one request.
+   * @param {Array<Buffer|TypedArray>} buffers
+   * @param {number=} [position]
    * @param {object=} [options]
+   * @param {number=} [options.timeout]
+   * @param {AbortSignal=} [options.signal]
+   * @return {Promise<{ bytesRead: number, buffers: Array<Buffer|TypedArray> }>}
    */
-  async readv (buffers, position) {
+  async readv (buffers, position, options) {
     if (this.closing || this.closed) {
       throw new Error('FileHandle is not opened')
     }
+
+    const { id } = this
+    const timeout = options?.timeout || null
+    const signal = options?.signal || null
+
+    let bytesRead = 0
+
+    if (signal?.aborted) {
+      throw new AbortError(signal)
+    }
+
+    if (!Array.isArray(buffers) || !buffers.every(isBufferLike)) {
+      throw new TypeError('Expecting buffers to be an array of Buffer or TypedArray.')
+    }
+
+    if (typeof position !== 'number') {
+      position = -1
+    }
+
+    if (buffers.length === 0) {
+      return { bytesRead, buffers }
+    }
+
+    const views = buffers.map(toBufferView)
+    const result = await ipc.request('fs.readv', {
+      id,
+      sizes: views.map((view) => view.byteLength).join(','),
+      offset: position
+    }, { signal, timeout, responseType: 'arraybuffer' })
+
+    if (result.err) {
+      throw result.err
+    }
+
+    if (isTypedArray(result.data) || result.data instanceof ArrayBuffer) {
+      const data = Buffer.from(result.data)
+
+      // the bytes fill the buffers in order, a short read leaves the last
+      // buffers as they were
+      for (const view of views) {
+        if (bytesRead >= data.byteLength) {
+          break
+        }
+
+        bytesRead += data.copy(view, 0, bytesRead, bytesRead + view.byteLength)
+      }
+
+      dc.channel('handle.read').publish({ handle: this, bytesRead })
+    } else if (!isEmptyObject(result.data)) {
+      throw new TypeError(
+        `Invalid response buffer from 'fs.readv' Received: ${typeof result.data}`
+      )
+    }
+
+    return { bytesRead, buffers }
+  }
+
+  /**
+   * Writes the underlying file to its storage device. Writes held with
+   * the `writeBehind` option are written first.
+   * @param {object=} [options]
+   */
+  async sync (options) {
+    if (this.closing || this.closed) {
+      throw new Error('FileHandle is not opened')
+    }
+
+    const result = await ipc.request('fs.fsync', { id: this.id }, options)
+
+    if (result.err) {
+      throw result.err
+    }
   }
 
   /**
@@ -767,9 +899,62 @@ export class FileHandle extends EventEmitter {
   }
 
   /**
+   * Writes each of `buffers`, in order, to the underlying file at
+   * `position` with one request.
+   * @param {Array<Buffer|TypedArray>} buffers
+   * @param {number=} [position]
    * @param {object=} [options]
+   * @param {number=} [options.timeout]
+   * @param {AbortSignal=} [options.signal]
+   * @return {Promise<{ bytesWritten: number, buffers: Array<Buffer|TypedArray> }>}
    */
-  async writev (buffers, position) {
+  async writev (buffers, position, options) {
+    if (this.closing || this.closed) {
+      throw new Error('FileHandle is not opened')
+    }
+
+    const timeout = options?.timeout || null
+    const signal = options?.signal || null
+
+    if (signal?.aborted) {
+      throw new AbortError(signal)
+    }
+
+    if (!Array.isArray(buffers) || !buffers.every(isBufferLike)) {
+      throw new TypeError('Expecting buffers to be an array of Buffer or TypedArray.')
+    }
+
+    if (typeof position !== 'number') {
+      position = -1
+    }
+
+    const views = buffers.map(toBufferView)
+    const data = Buffer.concat(views)
+
+    if (data.byteLength === 0) {
+      return { bytesWritten: 0, buffers }
+    }
+
+    const params = {
+      id: this.id,
+      sizes: views.map((view) => view.byteLength).join(','),
+      offset: position
+    }
+
+    const result = await ipc.write('fs.writev', params, data, {
+      timeout,
+      signal
+    })
+
+    if (result.err) {
+      throw result.err
+    }
+
+    const bytesWritten = parseInt(result.data.result) || 0
+
+    dc.channel('handle.write').publish({ handle: this, bytesWritten })
+
+    return { bytesWritten, buffers }
   }
 }
 
@@ -26,6 +26,7 @@
 import { Dir, Dirent, sortDirectoryEntries } from './dir.js'
 import { DirectoryHandle, FileHandle } from './handle.js'
 import { ReadStream, WriteStream } from './stream.js'
+import { Watcher } from './watcher.js'
 import { isBufferLike, isFunction, noop } from '../util.js'
 import * as constants from './constants.js'
 import * as promises from './promises.js'
@@ -271,6 +272,39 @@ export function fstat (fd, options, callback) {
   }
 }
 
+/**
+ * Writes the data of the file at `fd` to its storage device.
+ * @see {https://nodejs.org/api/fs.html#fsfdatasyncfd-callback}
+ * @param {number} fd
+ * @param {function(Error?)} callback
+ */
+export function fdatasync (fd, callback) {
+  fsync(fd, callback)
+}
+
+/**
+ * Writes the file at `fd` to its storage device. Writes held with the
+ * `writeBehind` option of `fs.open()` are written first.
+ * @see {https://nodejs.org/api/fs.html#fsfsyncfd-callback}
+ * @param {number} fd
+ * @param {function(Error?)} callback
+ */
+export function fsync (fd, callback) {
+  if (typeof callback !== 'function') {
+    throw new TypeError('callback must be a function.')
+  }
+
+  try {
+    FileHandle
+      .from(fd)
+      .sync()
+      .then(() => callback(null))
+      .catch((err) => callback(err))
+  } catch (err) {
+    callback(err)
+  }
+}
+
 /**
  * @ignore
  */
@@ -292,9 +326,25 @@ export function lutimes (path, atime, mtime, callback) {
 export function link (existingPath, newPath, callback) {
 }
 /**
- * @ignore
+ * @see {@link https://nodejs.org/api/fs.html#fslstatpath-options-callback}
+ * @param {string | Buffer | URL} path
+ * @param {object=} [options]
+ * @param {boolean=} [options.bigint = false]
+ * @param {function(Error?, Stats?)} callback
  */
 export function lstat (path, options, callback) {
+  if (typeof options === 'function') {
+    callback = options
+    options = {}
+  }
+
+  if (typeof callback !== 'function') {
+    throw new TypeError('callback must be a function.')
+  }
+
+  promises.lstat(path, options)
+    .then((stats) => callback(null, stats))
+    .catch((err) => callback(err))
 }
 /**
  * @ignore
@@ -437,6 +487,36 @@ export function read (fd, buffer, offset, length, position, options, callback) {
   }
 }
 
+/**
+ * Reads from the file at `fd` into each of `buffers`, in order, with one
+ * request.
+ * @see {https://nodejs.org/api/fs.html#fsreadvfd-buffers-position-callback}
+ * @param {number} fd
+ * @param {Array<Buffer|TypedArray>} buffers
+ * @param {number=} [position]
+ * @param {function(Error?, number, Array)} callback
+ */
+export function readv (fd, buffers, position, callback) {
+  if (typeof position === 'function') {
+    callback = position
+    position = null
+  }
+
+  if (typeof callback !== 'function') {
+    throw new TypeError('callback must be a function.')
+  }
+
+  try {
+    FileHandle
+      .from(fd)
+      .readv(buffers, position)
+      .then(({ bytesRead, buffers }) => callback(null, bytesRead, buffers))
+      .catch((err) => callback(err))
+  } catch (err) {
+    callback(err)
+  }
+}
+
 /**
  * Asynchronously read all entries in a directory.
  * @see {https://nodejs.org/dist/latest-v16.x/docs/api/fs.html#fsreaddirpath-options-callback}
@@ -516,23 +596,10 @@ export function readFile (path, options, callback) {
     throw new TypeError('callback must be a function.')
   }
 
-  visit(path, options, async (err, handle) => {
-    let buffer = null
-
-    if (err) {
-      callback(err)
-      return
-    }
-
-    try {
-      buffer = await handle.readFile(options)
-    } catch (err) {
-      callback(err)
-      return
-    }
-
-    callback(null, buffer)
-  })
+  promises.readFile(path, options).then(
+    (buffer) => callback(null, buffer),
+    (err) => callback(err)
+  )
 }
 
 /**
@@ -580,6 +647,14 @@ export function stat (path, options, callback) {
     throw new TypeError('callback must be a function.')
   }
 
+  // paths are stat'd without being opened
+  if (typeof path !== 'number') {
+    promises.stat(path, options)
+      .then((stats) => callback(null, stats))
+      .catch((err) => callback(err))
+    return
+  }
+
   visit(path, async (err, handle) => {
     let stats = null
 
@@ -619,9 +694,34 @@ export function unlink (path, callback) {
 export function utimes (path, atime, mtime, callback) {
 }
 /**
- * @ignore
+ * Watches `path` for changes. On Linux a recursive watch watches every
+ * directory under `path`.
+ * @see {@url https://nodejs.org/dist/latest-v16.x/docs/api/fs.html#fswatchfilename-options-listener}
+ * @param {string | Buffer | URL} path
+ * @param {object|string=} [options]
+ * @param {boolean=} [options.recursive = false]
+ * @param {number=} [options.window = 50] - Milliseconds to wait for more changes before they are emitted together
+ * @param {AbortSignal=} [options.signal]
+ * @param {function(string, string)=} [callback] - Called with the type (`'rename'` or `'change'`) and the path of every change
+ * @return {Watcher}
  */
 export function watch (path, options, callback) {
+  if (typeof options === 'function') {
+    callback = options
+    options = {}
+  }
+
+  if (typeof options === 'string') {
+    options = { encoding: options }
+  }
+
+  const watcher = new Watcher(path, options)
+
+  if (typeof callback === 'function') {
+    watcher.on('change', callback)
+  }
+
+  return watcher
 }
 /**
  * @ignore
@@ -677,7 +777,33 @@ export function writeFile (path, data, options, callback) {
   })
 }
 
+/**
+ * Writes each of `buffers`, in order, to the file at `fd` with one request.
+ * @see {https://nodejs.org/api/fs.html#fswritevfd-buffers-position-callback}
+ * @param {number} fd
+ * @param {Array<Buffer|TypedArray>} buffers
+ * @param {number=} [position]
+ * @param {function(Error?, number, Array)} callback
+ */
 export function writev (fd, buffers, position, callback) {
+  if (typeof position === 'function') {
+    callback = position
+    position = null
+  }
+
+  if (typeof callback !== 'function') {
+    throw new TypeError('callback must be a function.')
+  }
+
+  try {
+    FileHandle
+      .from(fd)
+      .writev(buffers, position)
+      .then(({ bytesWritten, buffers }) => callback(null, bytesWritten, buffers))
+      .catch((err) => callback(err))
+  } catch (err) {
+    callback(err)
+  }
 }
 
 // re-exports
@@ -691,6 +817,7 @@ export {
   promises,
   ReadStream,
   Stats,
+  Watcher,
   WriteStream
 }
 
@@ -23,7 +23,13 @@
  * ```
  */
 import { DirectoryHandle, FileHandle } from './handle.js'
-import { Dir, sortDirectoryEntries } from './dir.js'
+import { Dir, Dirent, sortDirectoryEntries } from './dir.js'
+import { Watcher } from './watcher.js'
+import { Stats } from './stats.js'
+import { isEmptyObject, isTypedArray } from '../util.js'
+import { AbortError } from '../errors.js'
+import { Buffer } from '../buffer.js'
+import { rand64 } from '../crypto.js'
 import console from '../console.js'
 import ipc from '../ipc.js'
 
@@ -52,6 +58,22 @@ async function visit (path, options, callback) {
   return value
 }
 
+/**
+ * Returns the stats of `path` with the `fs.stat` or `fs.lstat` route, which
+ * do not open the file and can be answered from the native stat cache, see
+ * `[filesystem] stat_cache`.
+ * @ignore
+ */
+async function statPath (source, path, options) {
+  const result = await ipc.request(source, { path: String(path) }, options)
+
+  if (result.err) {
+    throw result.err
+  }
+
+  return Stats.from(result.data, Boolean(options?.bigint))
+}
+
 /**
  * Asynchronously check access a file.
  * @see {@link https://nodejs.org/dist/latest-v16.x/docs/api/fs.html#fspromisesaccesspath-mode}
@@ -131,10 +153,14 @@ export async function link (existingPath, newPath) {
 }
 
 /**
- * @TODO
- * @ignore
+ * @see {@link https://nodejs.org/api/fs.html#fspromiseslstatpath-options}
+ * @param {string | Buffer | URL} path
+ * @param {object=} [options]
+ * @param {boolean=} [options.bigint = false]
+ * @return {Promise<Stats>}
  */
 export async function lstat (path, options) {
+  return await statPath('fs.lstat', path, options)
 }
 
 /**
@@ -167,10 +193,15 @@ export async function mkdir (path, options = {}) {
  * @param {string | Buffer | URL} path
  * @param {string} flags - default: 'r'
  * @param {string} mode - default: 0o666
+ * @param {object=} [options]
+ * @param {boolean|object=} [options.writeBehind] - Hold small writes and
+ *   write those that follow each other together
+ * @param {boolean|number=} [options.readAhead] - Read chunks ahead of
+ *   sequential reads
  * @return {Promise<FileHandle>}
  */
-export async function open (path, flags, mode) {
-  return await FileHandle.open(path, flags, mode)
+export async function open (path, flags, mode, options) {
+  return await FileHandle.open(path, flags, mode, options)
 }
 
 /**
@@ -234,6 +265,48 @@ export async function readFile (path, options) {
     flags: 'r',
     ...options
   }
+
+  // a path opened for reading is read natively with one request, a
+  // `FileHandle` or descriptor is read from its current position
+  if (
+    !(path instanceof FileHandle) &&
+    !path?.fd &&
+    (options.flags || options.flag) === 'r'
+  ) {
+    const signal = options?.signal
+
+    if (signal?.aborted) {
+      throw new AbortError(signal)
+    }
+
+    const result = await ipc.request('fs.readFile', {
+      path: String(path)
+    }, { signal, responseType: 'arraybuffer' })
+
+    if (result.err) {
+      throw result.err
+    }
+
+    let buffer = null
+
+    if (isTypedArray(result.data) || result.data instanceof ArrayBuffer) {
+      buffer = Buffer.from(result.data)
+    } else if (!result.data || isEmptyObject(result.data)) {
+      // an empty response from mac returns an empty object sometimes
+      buffer = Buffer.alloc(0)
+    } else {
+      throw new TypeError(
+        `Invalid response buffer from 'fs.readFile' Received: ${typeof result.data}`
+      )
+    }
+
+    if (typeof options.encoding === 'string') {
+      return buffer.toString(options.encoding)
+    }
+
+    return buffer
+  }
+
   return await visit(path, options, async (handle) => {
     return await handle.readFile(options)
   })
@@ -282,9 +355,13 @@ export async function rm (path, options) {
  * @return {Promise<Stats>}
  */
 export async function stat (path, options) {
-  return await visit(path, {}, async (handle) => {
-    return await handle.stat(options)
-  })
+  if (path instanceof FileHandle || path?.fd) {
+    return await visit(path, {}, async (handle) => {
+      return await handle.stat(options)
+    })
+  }
+
+  return await statPath('fs.stat', path, options)
 }
 
 /**
@@ -316,10 +393,101 @@ export async function utimes (path, atime, mtime) {
 }
 
 /**
- * @TODO
- * @ignore
+ * Walks the tree at `path`, yielding a `Dirent` for every entry under it.
+ * The tree is read natively, several directories at once, and entries
+ * arrive in batches, so a large tree is walked with a handful of requests
+ * instead of an `opendir()`, `readdir()` and `close()` per directory. The
+ * `name` of an entry is its path relative to `path` and symbolic links are
+ * not followed. Entries are not sorted.
+ * @param {string | Buffer | URL} path
+ * @param {object=} [options]
+ * @param {number=} [options.depth = -1] - Levels of directories below `path` to read, `0` for only the entries of `path` and `-1` for all of them
+ * @param {string[]=} [options.include] - Globs of the entries to yield, all of them when not given
+ * @param {string[]=} [options.ignore] - Globs of the entries to neither yield nor read
+ * @param {boolean=} [options.stat = false] - Yield every entry with its `lstat()` as `dirent.stats`
+ * @param {boolean=} [options.bigint = false]
+ * @return {AsyncGenerator<Dirent>}
+ */
+export async function * walk (path, options) {
+  const id = String(options?.id || rand64())
+  const batches = []
+  let expected = -1
+  let received = 0
+  let error = null
+  let wake = null
+
+  const ondata = ({ detail }) => {
+    const { source, data } = detail?.params || {}
+
+    if (source === 'fs.walk' && data?.id === id) {
+      batches.push(JSON.parse(new TextDecoder().decode(detail.data)))
+      received++
+      wake?.()
+    }
+  }
+
+  globalThis.addEventListener('data', ondata)
+
+  // posts may arrive after the reply, which gives how many were sent
+  ipc.request('fs.walk', {
+    id,
+    path: String(path),
+    depth: options?.depth ?? -1,
+    include: [].concat(options?.include || []).join(','),
+    ignore: [].concat(options?.ignore || []).join(','),
+    stat: Boolean(options?.stat)
+  }, options).then((result) => {
+    error = result.err
+    expected = result.data?.batches ?? 0
+    wake?.()
+  }, (err) => {
+    error = err
+    wake?.()
+  })
+
+  try {
+    while (true) {
+      while (batches.length > 0) {
+        for (const entry of batches.shift()) {
+          const dirent = Dirent.from(entry)
+
+          if (entry.stat) {
+            dirent.stats = Stats.from(entry.stat, Boolean(options?.bigint))
+          }
+
+          yield dirent
+        }
+      }
+
+      if (error) {
+        throw error
+      }
+
+      if (expected >= 0 && received >= expected) {
+        break
+      }
+
+      await new Promise((resolve) => { wake = resolve })
+      wake = null
+    }
+  } finally {
+    globalThis.removeEventListener('data', ondata)
+  }
+}
+
+/**
+ * Watches `path` for changes, yielding `{ eventType, filename }` for every
+ * change until `options.signal` is aborted.
+ * @see {@link https://nodejs.org/dist/latest-v16.x/docs/api/fs.html#fspromiseswatchfilename-options}
+ * @param {string | Buffer | URL} path
+ * @param {object=} [options]
+ * @param {boolean=} [options.recursive = false]
+ * @param {number=} [options.window = 50]
+ * @param {AbortSignal=} [options.signal]
+ * @return {AsyncGenerator<{ eventType: string, filename: string }>}
  */
-export async function watch (path, options) {
+export async function * watch (path, options) {
+  yield * new Watcher(path, options)
 }
 
 /**
@@ -0,0 +1,180 @@
+import { EventEmitter } from '../events.js'
+import { AbortError } from '../errors.js'
+import { rand64 } from '../crypto.js'
+import ipc from '../ipc.js'
+
+import * as exports from './watcher.js'
+
+// started watchers by id, changes arrive for all of them as `fs.watch` events
+const watchers = new Map()
+
+function onwatch (event) {
+  const { data } = event.detail || {}
+  const watcher = watchers.get(data?.id)
+
+  if (watcher && Array.isArray(data.events)) {
+    for (const { type, path } of data.events) {
+      watcher.emit('change', type, path)
+    }
+  }
+}
+
+/**
+ * A watcher of a file or directory started with `fs.watch()`. Changes are
+ * found natively and given to the WebView in batches, one for the changes
+ * made until `options.window` milliseconds pass without another one. A
+ * `'change'` event is emitted for every changed path of a batch.
+ * @see {https://nodejs.org/dist/latest-v16.x/docs/api/fs.html#class-fsfswatcher}
+ */
+export class Watcher extends EventEmitter {
+  static get DEFAULT_WINDOW () { return 50 }
+
+  /**
+   * `Watcher` class constructor.
+   * @param {string} path
+   * @param {object=} [options]
+   * @param {boolean=} [options.recursive = false]
+   * @param {number=} [options.window = 50]
+   * @param {AbortSignal=} [options.signal]
+   */
+  constructor (path, options) {
+    super()
+
+    this.id = String(options?.id || rand64())
+    this.path = String(path)
+    this.recursive = Boolean(options?.recursive)
+    this.window = options?.window ?? Watcher.DEFAULT_WINDOW
+    this.closed = false
+
+    const signal = options?.signal
+
+    if (signal?.aborted) {
+      throw new AbortError(signal)
+    }
+
+    signal?.addEventListener('abort', () => this.close(), { once: true })
+
+    if (watchers.size === 0) {
+      globalThis.addEventListener('fs.watch', onwatch)
+    }
+
+    watchers.set(this.id, this)
+    this.started = this.start()
+  }
+
+  /**
+   * Starts watching `path`, resolves when it is watched.
+   * @ignore
+   * @return {Promise<Watcher>}
+   */
+  async start () {
+    const result = await ipc.request('fs.watch', {
+      id: this.id,
+      path: this.path,
+      recursive: this.recursive,
+      window: this.window
+    })
+
+    if (result.err) {
+      this.emit('error', result.err)
+      this.close()
+    }
+
+    return this
+  }
+
+  /**
+   * Stops watching `path`. Changes not given to the WebView yet are
+   * emitted before the `'close'` event.
+   * @return {Promise}
+   */
+  async close () {
+    if (this.closed) {
+      return
+    }
+
+    this.closed = true
+
+    try {
+      await this.started
+      await ipc.send('fs.unwatch', { id: this.id })
+    } finally {
+      watchers.delete(this.id)
+
+      if (watchers.size === 0) {
+        globalThis.removeEventListener('fs.watch', onwatch)
+      }
+
+      this.emit('close')
+    }
+  }
+
+  /**
+   * Does nothing, watchers do not keep anything alive.
+   * @return {Watcher}
+   */
+  ref () {
+    return this
+  }
+
+  /**
+   * Does nothing, watchers do not keep anything alive.
+   * @return {Watcher}
+   */
+  unref () {
+    return this
+  }
+
+  /**
+   * Yields `{ eventType, filename }` for every change until the watcher is
+   * closed.
+   * @return {AsyncGenerator<{ eventType: string, filename: string }>}
+   */
+  async * [Symbol.asyncIterator] () {
+    const changes = []
+    let error = null
+    let wake = null
+
+    const onchange = (eventType, filename) => {
+      changes.push({ eventType, filename })
+      wake?.()
+    }
+
+    const onerror = (err) => {
+      error = err
+      wake?.()
+    }
+
+    const onclose = () => wake?.()
+
+    this.on('change', onchange)
+    this.on('error', onerror)
+    this.on('close', onclose)
+
+    try {
+      while (true) {
+        while (changes.length > 0) {
+          yield changes.shift()
+        }
+
+        if (error) {
+          throw error
+        }
+
+        if (this.closed) {
+          break
+        }
+
+        await new Promise((resolve) => { wake = resolve })
+        wake = null
+      }
+    } finally {
+      this.off('change', onchange)
+      this.off('error', onerror)
+      this.off('close', onclose)
+      await this.close()
+    }
+  }
+}
+
+export default exports
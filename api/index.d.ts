@@ -3851,7 +3851,14 @@ declare module "socket:extension" {
      * @typedef {{ abi: number, version: string, description: string }} ExtensionInfo
      */
     /**
-     * @typedef {{ abi: number, loaded: number }} ExtensionStats
+     * @typedef {{
+     *   releases: number,
+     *   allocations: number,
+     *   destructors: number,
+     *   bytes: number,
+     *   blocks: number
+     * }} ExtensionMemoryStats
+     * @typedef {{ abi: number, loaded: number, memory: ExtensionMemoryStats }} ExtensionStats
      */
     /**
      * A interface for a native extension.
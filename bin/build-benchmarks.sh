@@ -0,0 +1,74 @@
+#!/usr/bin/env bash
+
+# Builds the native benchmarks in `src/bench` against the runtime static
+# library. Run `./bin/install.sh` (or `./bin/build-runtime-library.sh`)
+# first. Benchmarks are written to `build/<arch>-desktop/bin/bench`.
+#
+# usage: ./bin/build-benchmarks.sh [--force] [name ...]
+
+declare root="$(cd "$(dirname "$(dirname "${BASH_SOURCE[0]}")")" && pwd)"
+declare clang="${CXX:-"${CLANG:-clang++}"}"
+
+source "$root/bin/functions.sh"
+
+declare arch="$(host_arch)"
+declare host=$(host_os)
+declare platform="desktop"
+declare force=0
+declare names=()
+
+declare d=""
+if [[ "$host" == "Win32" ]]; then
+  if [[ -n "$DEBUG" ]]; then
+    d="d"
+  fi
+fi
+
+while (( $# > 0 )); do
+  declare arg="$1"; shift
+  if [[ "$arg" = "--force" ]] || [[ "$arg" = "-f" ]]; then
+    force=1; continue
+  fi
+
+  names+=("$arg")
+done
+
+declare static_library="$root/build/$arch-$platform/lib$d/libsocket-runtime$d.a"
+declare output_directory="$root/build/$arch-$platform/bin/bench"
+
+if ! test -f "$static_library"; then
+  echo >&2 "not ok - missing $(basename "$static_library"), run './bin/install.sh' first"
+  exit 1
+fi
+
+declare sources=()
+if (( ${#names[@]} > 0 )); then
+  for name in "${names[@]}"; do
+    sources+=("$root/src/bench/$name.cc")
+  done
+else
+  sources=($(find "$root"/src/bench/*.cc))
+fi
+
+declare cflags=($("$root/bin/cflags.sh"))
+declare ldflags=($("$root/bin/ldflags.sh" --arch "$arch" --platform "$platform" -lsocket-runtime$d -luv))
+
+mkdir -p "$output_directory"
+
+for source in "${sources[@]}"; do
+  declare name="$(basename "$source" .cc)"
+  declare output="$output_directory/$name-benchmark$(use_bin_ext ".exe")"
+
+  if ! test -f "$source"; then
+    echo >&2 "not ok - unknown benchmark '$name'"
+    exit 1
+  fi
+
+  if (( force )) || ! test -f "$output" || (( $(stat_mtime "$source") > $(stat_mtime "$output") )) || (( $(stat_mtime "$static_library") > $(stat_mtime "$output") )); then
+    echo "# building benchmark ($arch-$platform) $name"
+    quiet "$clang" "${cflags[@]}" "$source" "${ldflags[@]}" -o "$output"
+    die $? "not ok - unable to build benchmark '$name'"
+  fi
+
+  echo "ok - built ${output/$root\//}"
+done
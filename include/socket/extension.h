@@ -574,6 +574,22 @@ extern "C" {
   SOCKET_RUNTIME_EXTENSION_EXPORT
   const char * sapi_json_stringify (const sapi_json_any_t*);
 
+  /**
+   * Parse JSON `source` into a JSON value. On failure, `NULL` is returned
+   * and the context error name, message, and location are set.
+   * @param context - A context associated with the extension
+   * @param source  - The JSON source string
+   * @param size    - The size in bytes of `source`, or `0` if `source` is
+   *                  null terminated
+   * @return The parsed JSON value or `NULL`
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  sapi_json_any_t* sapi_json_parse (
+    sapi_context_t* context,
+    const char* source,
+    const unsigned int size
+  );
+
 
   /**
    * Miscellaneous API
@@ -730,6 +746,35 @@ extern "C" {
     const sapi_ipc_router_t* router
   );
 
+  /**
+   * A callback called when a binary IPC route receives a request. Only the
+   * sequence and window index of `message` are set, any arguments are in
+   * `bytes`.
+   * @param context - The extension context for this request
+   * @param message - The IPC message for this request
+   * @param bytes   - The request body, `NULL` if empty
+   * @param size    - The size of the request body
+   * @param router  - The IPC router associated with the extension context
+   */
+  typedef void (*sapi_ipc_router_binary_callback_t)(
+    sapi_context_t* context,
+    sapi_ipc_message_t* message,
+    const unsigned char* bytes,
+    const unsigned int size,
+    const sapi_ipc_router_t* router
+  );
+
+  /**
+   * A callback that frees bytes given to `sapi_ipc_result_set_bytes_owned()`
+   * or `sapi_ipc_send_bytes_owned()`.
+   * @param bytes - The bytes
+   * @param data  - User data given with `bytes`
+   */
+  typedef void (*sapi_ipc_bytes_free_callback_t)(
+    unsigned char* bytes,
+    void* data
+  );
+
   /**
    * Get the window index the IPC message is associated with.
    * @param message The IPC message
@@ -909,7 +954,11 @@ extern "C" {
   );
 
   /**
-   * Set the IPC result bytes.
+   * Set the IPC result bytes. Ownership of `bytes`, which must be allocated
+   * with `new[]`, is transferred to the runtime, which frees them with
+   * `delete[]`. Use `sapi_ipc_result_set_bytes_copy()` for bytes the
+   * extension keeps or `sapi_ipc_result_set_bytes_owned()` for bytes freed
+   * another way.
    * @param result - An IPC request result
    * @param size   - The size of the bytes
    * @param bytes  - The bytes
@@ -921,6 +970,40 @@ extern "C" {
     const unsigned char* bytes
   );
 
+  /**
+   * Set the IPC result bytes to a copy of `bytes`, which stay owned by the
+   * extension.
+   * @param result - An IPC request result
+   * @param size   - The size of the bytes
+   * @param bytes  - The bytes
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  void sapi_ipc_result_set_bytes_copy (
+    sapi_ipc_result_t* result,
+    const unsigned int size,
+    const unsigned char* bytes
+  );
+
+  /**
+   * Set the IPC result bytes without copying them. Ownership of `bytes` is
+   * transferred to the runtime, which calls `free` with `bytes` and `data`
+   * once the WebView no longer needs them, possibly on another thread.
+   * `free` may be `NULL` if `bytes` outlive the extension.
+   * @param result - An IPC request result
+   * @param size   - The size of the bytes
+   * @param bytes  - The bytes
+   * @param free   - The callback that frees `bytes`
+   * @param data   - User data propagated to `free`
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  void sapi_ipc_result_set_bytes_owned (
+    sapi_ipc_result_t* result,
+    const unsigned int size,
+    unsigned char* bytes,
+    sapi_ipc_bytes_free_callback_t free,
+    void* data
+  );
+
   /**
    * Get the IPC result bytes.
    * @param result - An IPC request result
@@ -941,6 +1024,27 @@ extern "C" {
     const sapi_ipc_result_t* result
   );
 
+  /**
+   * Set the HTTP status of the IPC result response. The default is `200`.
+   * @param result - An IPC request result
+   * @param status - The HTTP status code
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  void sapi_ipc_result_set_status (
+    sapi_ipc_result_t* result,
+    const int status
+  );
+
+  /**
+   * Get the HTTP status of the IPC result response.
+   * @param result - An IPC request result
+   * @return The HTTP status code
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  const int sapi_ipc_result_get_status (
+    const sapi_ipc_result_t* result
+  );
+
   /**
    * Set an IPC result response header.
    * @param result - An IPC request result
@@ -1017,6 +1121,30 @@ extern "C" {
     const char* headers
   );
 
+  /**
+   * Send bytes to the bridge to propagate to the WebView without copying
+   * them. Ownership of `bytes` is transferred to the runtime as with
+   * `sapi_ipc_result_set_bytes_owned()`, even if sending fails.
+   * @param context - An extension context
+   * @param seq     - An IPC sequence value
+   * @param size    - The size of the bytes
+   * @param bytes   - The bytes
+   * @param headers - Optional HTTP response headers
+   * @param free    - The callback that frees `bytes`
+   * @param data    - User data propagated to `free`
+   * @return `true` if successful, otherwise `false`
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  bool sapi_ipc_send_bytes_owned (
+    sapi_context_t* context,
+    const char* seq,
+    const unsigned int size,
+    unsigned char* bytes,
+    const char* headers,
+    sapi_ipc_bytes_free_callback_t free,
+    void* data
+  );
+
   /**
    * Map a named route to a callback with optional use data for a given
    * extension context. Routes must "reply" with a result to respond to an
@@ -1034,6 +1162,24 @@ extern "C" {
     const void* data
   );
 
+  /**
+   * Map a named route to a callback that is given the request body as is
+   * and replies with bytes (`sapi_ipc_result_set_bytes()`) and a status
+   * (`sapi_ipc_result_set_status()`). The request URI is not parsed beyond
+   * its sequence and window index, so nothing is decoded or parsed as JSON.
+   * @param context  - An extension context
+   * @param route    - The route name to map
+   * @param callback - The callback called when an IPC route receives a request
+   * @param data     - User data propagated to `callback`
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  void sapi_ipc_router_map_binary (
+    sapi_context_t* context,
+    const char* route,
+    sapi_ipc_router_binary_callback_t callback,
+    const void* data
+  );
+
   /**
    * Unmap a named route for a given extension context.
    * incoming request.
@@ -1219,6 +1365,125 @@ extern "C" {
     const int code
   );
 
+  /**
+   * Work API
+   * The _Work API_ runs CPU heavy work for an extension on a pool of worker
+   * threads shared by all extensions, so it does not block the event loop.
+   * The size of the pool is the `[extensions] workers` config value, which
+   * defaults to the number of CPU cores.
+   */
+
+  /**
+   * An opaque pointer for a work queue. A work queue limits how many of its
+   * work items run at the same time.
+   */
+  typedef struct sapi_work_queue sapi_work_queue_t;
+
+  /**
+   * An opaque pointer for a work item submitted to a work queue. A work item
+   * is valid until its completion callback returns.
+   */
+  typedef struct sapi_work sapi_work_t;
+
+  /**
+   * A scalar type that represents how a work item finished.
+   */
+  typedef int sapi_work_status_t;
+
+  /**
+   * The work callback ran and was not cancelled.
+   */
+  #define SAPI_WORK_STATUS_COMPLETED 0
+
+  /**
+   * The work item was cancelled before or while its work callback ran.
+   */
+  #define SAPI_WORK_STATUS_CANCELLED 1
+
+  /**
+   * A callback called on a worker thread to do the work of a work item.
+   * @param work - The work item
+   * @param data - User data given to `sapi_work_submit()`
+   */
+  typedef void (*sapi_work_callback_t)(
+    sapi_work_t* work,
+    void* data
+  );
+
+  /**
+   * A callback called on the event loop when a work item has finished.
+   * @param context - The extension context of the work queue
+   * @param work    - The work item
+   * @param status  - `SAPI_WORK_STATUS_COMPLETED` or `SAPI_WORK_STATUS_CANCELLED`
+   * @param data    - User data given to `sapi_work_submit()`
+   */
+  typedef void (*sapi_work_complete_callback_t)(
+    sapi_context_t* context,
+    sapi_work_t* work,
+    sapi_work_status_t status,
+    void* data
+  );
+
+  /**
+   * Create a work queue that runs at most `concurrency` work items at the same
+   * time. The context must outlive the work queue.
+   * @param context     - An extension context
+   * @param concurrency - The maximum number of running work items, `0` for
+   *                      the size of the worker pool
+   * @return A work queue or `NULL` if not allowed
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  sapi_work_queue_t* sapi_work_queue_create (
+    sapi_context_t* context,
+    const unsigned int concurrency
+  );
+
+  /**
+   * Destroy a work queue. Work items that have not started are cancelled and
+   * running work items are asked to stop. Completion callbacks are still
+   * called for every work item.
+   * @param queue - A work queue
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  void sapi_work_queue_destroy (sapi_work_queue_t* queue);
+
+  /**
+   * Submit work to a work queue. `callback` is called on a worker thread
+   * and `oncomplete` is called on the event loop when it has finished.
+   * @param queue      - A work queue
+   * @param callback   - The callback that does the work
+   * @param oncomplete - An optional callback called when the work has finished
+   * @param data       - User data given to `callback` and `oncomplete`
+   * @return A work item or `NULL` if not allowed
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  sapi_work_t* sapi_work_submit (
+    sapi_work_queue_t* queue,
+    sapi_work_callback_t callback,
+    sapi_work_complete_callback_t oncomplete,
+    void* data
+  );
+
+  /**
+   * Cancel a work item. A work item that has not started will not run. A
+   * running work item should check `sapi_work_cancelled()` and return early.
+   * A work item is freed on the event loop once it has completed, right after
+   * `oncomplete` returns. It may be cancelled from any thread before that,
+   * including from `oncomplete`, but must not be used after it.
+   * @param work - A work item
+   * @return `true` if the work item had not finished, otherwise `false`
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  bool sapi_work_cancel (sapi_work_t* work);
+
+  /**
+   * Get whether a work item was cancelled. Safe to call from `callback`.
+   * @param work - A work item
+   * @return `true` if cancelled, otherwise `false`
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  bool sapi_work_cancelled (const sapi_work_t* work);
+
   /**
    * Config API
    * The _Config API_ provides an interface for getting and setting
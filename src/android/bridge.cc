@@ -99,7 +99,7 @@ extern "C" {
 
     auto routed = bridge->route(uri.str(), input, size, [=](auto result) mutable {
       if (result.seq == "-1") {
-        bridge->router.send(result.seq, result.str(), result.post);
+        bridge->router.send(result);
         return;
       }
 
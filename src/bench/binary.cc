@@ -0,0 +1,283 @@
+#include "../core/core.hh"
+#include "../ipc/ipc.hh"
+#include "../extension/extension.hh"
+
+//
+// Measures a native extension route that transforms a binary blob, once
+// mapped with `sapi_ipc_router_map()` (the blob is hex encoded in the URI
+// and the result is a hex encoded JSON string) and once mapped with
+// `sapi_ipc_router_map_binary()` (the blob is the request body and the
+// result is bytes). Each request is timed from `Router::invoke()` until the
+// reply is what the `ipc://` scheme handler would give the WebView.
+//
+// usage: binary-benchmark [--iterations <n>] [--json] [size ...]
+//
+
+using namespace SSC;
+
+// the benchmark is not an application, so there is no compiled user config
+const Map SSC::getUserConfig () {
+  return Map {};
+}
+
+bool SSC::isDebugEnabled () {
+  return DEBUG == 1;
+}
+
+struct Options {
+  uint64_t iterations = 1000;
+  bool json = false;
+  Vector<size_t> sizes;
+};
+
+struct Measurement {
+  size_t size = 0;
+  uint64_t json = 0; // nanoseconds, all iterations
+  uint64_t binary = 0; // nanoseconds, all iterations
+  uint64_t mismatches = 0;
+};
+
+static uint64_t now () {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count();
+}
+
+static void printUsage () {
+  std::cerr
+    << "usage: binary-benchmark [--iterations <n>] [--json] [size ...]"
+    << std::endl;
+}
+
+static bool parseOptions (int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    auto arg = String(argv[i]);
+
+    try {
+      if (arg == "--iterations") {
+        if (i + 1 >= argc) return false;
+        options.iterations = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--json") {
+        options.json = true;
+      } else if (arg.starts_with("--")) {
+        return false;
+      } else {
+        options.sizes.push_back(std::max((size_t) 1, (size_t) std::stoull(arg)));
+      }
+    } catch (...) {
+      return false;
+    }
+  }
+
+  if (options.sizes.size() == 0) {
+    options.sizes = { 256, 4 * 1024, 64 * 1024 };
+  }
+
+  return true;
+}
+
+// the work of the extension
+static void transform (const unsigned char* input, unsigned char* output, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    output[i] = input[i] ^ (unsigned char) (i * 13);
+  }
+}
+
+static String toHex (const unsigned char* bytes, size_t size) {
+  static const char digits[] = "0123456789abcdef";
+  String output(size * 2, '\0');
+
+  for (size_t i = 0; i < size; ++i) {
+    output[i * 2] = digits[bytes[i] >> 4];
+    output[i * 2 + 1] = digits[bytes[i] & 0x0F];
+  }
+
+  return output;
+}
+
+static Vector<unsigned char> fromHex (const String& hex) {
+  Vector<unsigned char> bytes(hex.size() / 2);
+
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = (unsigned char) std::stoi(hex.substr(i * 2, 2), nullptr, 16);
+  }
+
+  return bytes;
+}
+
+static void onJSONRequest (
+  sapi_context_t* context,
+  sapi_ipc_message_t* message,
+  const sapi_ipc_router_t* router
+) {
+  const auto input = fromHex(sapi_ipc_message_get_value(message));
+  Vector<unsigned char> output(input.size());
+  transform(input.data(), output.data(), input.size());
+
+  auto result = sapi_ipc_result_create(context, message);
+  auto hex = toHex(output.data(), output.size());
+  sapi_ipc_result_set_json_data(
+    result,
+    sapi_json_any(sapi_json_string_create(context, hex.c_str()))
+  );
+  sapi_ipc_reply(result);
+}
+
+static void onBinaryRequest (
+  sapi_context_t* context,
+  sapi_ipc_message_t* message,
+  const unsigned char* bytes,
+  const unsigned int size,
+  const sapi_ipc_router_t* router
+) {
+  auto output = new unsigned char[size];
+  transform(bytes, output, size);
+
+  auto result = sapi_ipc_result_create(context, message);
+  sapi_ipc_result_set_status(result, 200);
+  sapi_ipc_result_set_bytes_owned(
+    result,
+    size,
+    output,
+    [](unsigned char* bytes, void* data) { delete [] bytes; },
+    nullptr
+  );
+  sapi_ipc_reply(result);
+}
+
+static void report (const Options& options, const Vector<Measurement>& measurements) {
+  auto us = [&](uint64_t elapsed) {
+    return (double) elapsed / options.iterations / 1000.0;
+  };
+
+  if (options.json) {
+    JSON::Array results;
+
+    for (const auto& m : measurements) {
+      results.push(JSON::Object::Entries {
+        {"size", m.size},
+        {"json", us(m.json)},
+        {"binary", us(m.binary)},
+        {"mismatches", m.mismatches}
+      });
+    }
+
+    auto json = JSON::Object::Entries {
+      {"iterations", options.iterations},
+      {"unit", "us/op"},
+      {"results", results}
+    };
+
+    std::cout << JSON::Object(json).str() << std::endl;
+    return;
+  }
+
+  std::cout
+    << "# binary benchmark (" << options.iterations << " iterations)\n"
+    << std::left
+    << std::setw(10) << "bytes"
+    << std::setw(14) << "json us/op"
+    << std::setw(16) << "binary us/op"
+    << "mismatches\n";
+
+  for (const auto& m : measurements) {
+    std::cout
+      << std::setw(10) << m.size
+      << std::setw(14) << us(m.json)
+      << std::setw(16) << us(m.binary)
+      << m.mismatches << "\n";
+  }
+
+  std::cout << std::flush;
+}
+
+int main (int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  Core core;
+  IPC::Bridge bridge(&core);
+
+  // route handlers run on the benchmark thread in place of the UI thread
+  bridge.router.dispatchFunction = [](auto callback) {
+    callback();
+  };
+
+  sapi_context_t context;
+  context.router = &bridge.router;
+
+  sapi_ipc_router_map(&context, "bench.json", onJSONRequest, nullptr);
+  sapi_ipc_router_map_binary(&context, "bench.binary", onBinaryRequest, nullptr);
+
+  Vector<Measurement> measurements;
+  uint64_t mismatches = 0;
+  String buffer;
+
+  for (const auto size : options.sizes) {
+    Measurement measurement;
+    measurement.size = size;
+
+    Vector<unsigned char> input(size);
+    Vector<unsigned char> expected(size);
+
+    for (size_t i = 0; i < size; ++i) {
+      input[i] = (unsigned char) (i * 31 + 7);
+    }
+
+    transform(input.data(), expected.data(), size);
+
+    const auto jsonURI = "ipc://bench.json?seq=R0&value=" +
+      encodeURIComponent(toHex(input.data(), size));
+
+    const auto binaryURI = String("ipc://bench.binary?seq=R0");
+
+    // the JSON reply is serialized as the scheme handler would, parsing and
+    // decoding it in the WebView is not measured
+    auto startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      bridge.router.invoke(jsonURI, [&](auto result) {
+        buffer.clear();
+        result.writeTo(buffer);
+
+        if (i == 0) {
+          auto json = JSON::parse(buffer).as<JSON::Object>();
+          if (fromHex(String(json.get("data").stringView())) != expected) {
+            measurement.mismatches++;
+          }
+        }
+      });
+    }
+    measurement.json = now() - startedAt;
+
+    startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      bridge.router.invoke(
+        binaryURI,
+        reinterpret_cast<const char*>(input.data()),
+        input.size(),
+        [&](auto result) {
+          if (i == 0) {
+            const auto body = reinterpret_cast<unsigned char*>(result.post.body);
+            if (
+              result.post.length != size ||
+              !std::equal(expected.begin(), expected.end(), body)
+            ) {
+              measurement.mismatches++;
+            }
+          }
+        }
+      );
+    }
+    measurement.binary = now() - startedAt;
+
+    mismatches += measurement.mismatches;
+    measurements.push_back(measurement);
+  }
+
+  report(options, measurements);
+  return mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,255 @@
+#include "../core/core.hh"
+#include "../ipc/ipc.hh"
+#include "../extension/extension.hh"
+
+//
+// Measures a large binary response from a native extension route as it
+// travels from `sapi_ipc_reply()` to the `ipc://` scheme handler, once with
+// bytes copied by `sapi_ipc_result_set_bytes_copy()` and once with bytes
+// handed over by `sapi_ipc_result_set_bytes_owned()`. The scheme handler is
+// replaced by what it does with a binary result (keep the body as a post
+// until the WebView has consumed it), so the difference is the cost of the
+// copies a response makes on its way to the WebView.
+//
+// usage: bytes-benchmark [--iterations <n>] [--size <bytes>] [--json]
+//
+
+using namespace SSC;
+
+// the benchmark is not an application, so there is no compiled user config
+const Map SSC::getUserConfig () {
+  return Map {};
+}
+
+bool SSC::isDebugEnabled () {
+  return DEBUG == 1;
+}
+
+struct Options {
+  uint64_t iterations = 20;
+  uint64_t size = 64 * 1024 * 1024;
+  bool json = false;
+};
+
+struct Measurement {
+  String name;
+  uint64_t elapsed = 0; // nanoseconds, all iterations
+  uint64_t responses = 0;
+  uint64_t mismatches = 0;
+};
+
+// the bytes an extension serves, for example a cached file or a frame
+struct Source {
+  Vector<unsigned char> bytes;
+  std::atomic<uint64_t> freed = 0;
+};
+
+static uint64_t now () {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count();
+}
+
+static void printUsage () {
+  std::cerr
+    << "usage: bytes-benchmark [--iterations <n>] [--size <bytes>] [--json]"
+    << std::endl;
+}
+
+static bool parseOptions (int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    auto arg = String(argv[i]);
+
+    try {
+      if (arg == "--iterations") {
+        if (i + 1 >= argc) return false;
+        options.iterations = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--size") {
+        if (i + 1 >= argc) return false;
+        options.size = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--json") {
+        options.json = true;
+      } else {
+        return false;
+      }
+    } catch (...) {
+      return false;
+    }
+  }
+
+  return options.size <= UINT_MAX;
+}
+
+static void onCopyRequest (
+  sapi_context_t* context,
+  sapi_ipc_message_t* message,
+  const sapi_ipc_router_t* router
+) {
+  auto source = (Source*) context->data;
+  auto result = sapi_ipc_result_create(context, message);
+  sapi_ipc_result_set_bytes_copy(result, source->bytes.size(), source->bytes.data());
+  sapi_ipc_reply(result);
+}
+
+static void onOwnedRequest (
+  sapi_context_t* context,
+  sapi_ipc_message_t* message,
+  const sapi_ipc_router_t* router
+) {
+  auto source = (Source*) context->data;
+  auto result = sapi_ipc_result_create(context, message);
+  sapi_ipc_result_set_bytes_owned(
+    result,
+    source->bytes.size(),
+    source->bytes.data(),
+    [](unsigned char* bytes, void* data) {
+      reinterpret_cast<Source*>(data)->freed++;
+    },
+    source
+  );
+  sapi_ipc_reply(result);
+}
+
+static void report (const Options& options, const Vector<Measurement>& measurements) {
+  auto ms = [&](const Measurement& m) {
+    return m.responses > 0 ? (double) m.elapsed / m.responses / 1e6 : 0;
+  };
+
+  auto throughput = [&](const Measurement& m) {
+    const auto seconds = (double) m.elapsed / 1e9;
+    const auto megabytes = (double) options.size * m.responses / (1024 * 1024);
+    return seconds > 0 ? megabytes / seconds : 0;
+  };
+
+  if (options.json) {
+    JSON::Array results;
+
+    for (const auto& m : measurements) {
+      results.push(JSON::Object::Entries {
+        {"name", m.name},
+        {"responses", m.responses},
+        {"mismatches", m.mismatches},
+        {"ms", ms(m)},
+        {"throughput", throughput(m)}
+      });
+    }
+
+    auto json = JSON::Object::Entries {
+      {"iterations", options.iterations},
+      {"size", options.size},
+      {"unit", "MB/s"},
+      {"results", results}
+    };
+
+    std::cout << JSON::Object(json).str() << std::endl;
+    return;
+  }
+
+  std::cout
+    << "# bytes benchmark (" << options.iterations << " iterations of "
+    << options.size << " bytes)\n"
+    << std::left
+    << std::setw(10) << "route"
+    << std::setw(16) << "ms/response"
+    << std::setw(12) << "MB/s"
+    << "mismatches\n";
+
+  for (const auto& m : measurements) {
+    std::cout
+      << std::setw(10) << m.name
+      << std::setw(16) << ms(m)
+      << std::setw(12) << throughput(m)
+      << m.mismatches << "\n";
+  }
+
+  std::cout << std::flush;
+}
+
+int main (int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  Core core;
+  IPC::Bridge bridge(&core);
+  Source source;
+
+  source.bytes.resize(options.size);
+  for (size_t i = 0; i < source.bytes.size(); ++i) {
+    source.bytes[i] = (unsigned char) (i * 31 + 7);
+  }
+
+  // route handlers run on the benchmark thread in place of the UI thread
+  bridge.router.dispatchFunction = [](auto callback) {
+    callback();
+  };
+
+  sapi_context_t context;
+  context.router = &bridge.router;
+  context.data = &source;
+
+  sapi_ipc_router_map(&context, "bench.bytes.copy", onCopyRequest, &source);
+  sapi_ipc_router_map(&context, "bench.bytes.owned", onOwnedRequest, &source);
+
+  Vector<Measurement> measurements;
+
+  for (const auto& name : Vector<String> { "copy", "owned" }) {
+    Measurement measurement;
+    measurement.name = name;
+
+    const auto uri = "ipc://bench.bytes." + name + "?seq=R0";
+    const auto startedAt = now();
+
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      bridge.router.invoke(uri, [&](auto result) {
+        auto post = result.post;
+
+        // what the scheme handler does with a binary result: the body is
+        // kept as a post and handed to the WebView without a copy
+        if (post.body != nullptr && !core.hasPostBody(post.body)) {
+          if (post.id == 0) {
+            post.id = rand64();
+          }
+
+          core.putPost(post.id, post);
+        }
+
+        if (
+          post.body == nullptr ||
+          post.length != options.size ||
+          post.body[post.length - 1] != (char) source.bytes.back()
+        ) {
+          measurement.mismatches++;
+        }
+
+        measurement.responses++;
+
+        // the WebView has consumed the response
+        core.removePost(post.id);
+      });
+    }
+
+    measurement.elapsed = now() - startedAt;
+    measurements.push_back(measurement);
+  }
+
+  uint64_t mismatches = 0;
+
+  for (const auto& m : measurements) {
+    mismatches += m.mismatches;
+  }
+
+  // every owned response gives its bytes back exactly once
+  if (source.freed != options.iterations) {
+    std::cerr
+      << "error: " << source.freed << " of " << options.iterations
+      << " owned responses were freed" << std::endl;
+    mismatches++;
+  }
+
+  report(options, measurements);
+  return mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,319 @@
+#include "../core/core.hh"
+#include <filesystem>
+
+//
+// Measures the request contexts of a metadata heavy scan, a `uv_fs_stat()`
+// of every file in a directory with a window of requests in flight, as
+// `fs.stat` issues them on the core event loop. The scan runs once with a
+// context of the shape every `Core::FS` operation used to allocate (inline
+// `iov` and `dirents` arrays and an id, allocated and freed per request) and
+// once with contexts acquired from `core.fs.requestContexts`. Allocations
+// are counted per scan and RSS is sampled while requests are in flight.
+// Finally the files are scanned with `Core::FS::stat()` and the allocations
+// of its pool are reported.
+//
+// usage: fs-benchmark [--files <n>] [--concurrency <n>] [--json]
+//
+
+using namespace SSC;
+
+// the benchmark is not an application, so there is no compiled user config
+const Map SSC::getUserConfig () {
+  return Map {};
+}
+
+bool SSC::isDebugEnabled () {
+  return DEBUG == 1;
+}
+
+struct Options {
+  uint64_t files = 50000;
+  uint64_t concurrency = 32;
+  bool json = false;
+};
+
+struct Measurement {
+  String name;
+  size_t contextSize = 0;
+  uint64_t requests = 0;
+  uint64_t errors = 0;
+  uint64_t allocations = 0;
+  uint64_t elapsed = 0; // nanoseconds
+  uint64_t rss = 0; // bytes above the RSS before the scan
+};
+
+// the layout of `Core::FS::RequestContext` before it was split by operation
+struct LegacyRequestContext : Core::Module::RequestContext {
+  uint64_t id;
+  Core::FS::Descriptor *desc = nullptr;
+  uv_fs_t req;
+  uv_buf_t iov[16];
+  uv_dirent_t dirents[256];
+  int offset = 0;
+  int result = 0;
+
+  LegacyRequestContext () {
+    this->id = SSC::rand64();
+    this->req.data = (void *) this;
+  }
+
+  ~LegacyRequestContext () {
+    uv_fs_req_cleanup(&this->req);
+  }
+};
+
+struct Scan {
+  std::atomic<int64_t> pending = 0;
+  std::atomic<uint64_t> errors = 0;
+  uint64_t allocations = 0;
+};
+
+static void printUsage () {
+  std::cerr
+    << "usage: fs-benchmark [--files <n>] [--concurrency <n>] [--json]"
+    << std::endl;
+}
+
+static bool parseOptions (int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    auto arg = String(argv[i]);
+
+    try {
+      if (arg == "--files") {
+        if (i + 1 >= argc) return false;
+        options.files = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--concurrency") {
+        if (i + 1 >= argc) return false;
+        options.concurrency = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--json") {
+        options.json = true;
+      } else {
+        return false;
+      }
+    } catch (...) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static uint64_t rss () {
+  size_t bytes = 0;
+  uv_resident_set_memory(&bytes);
+  return bytes;
+}
+
+// drive the core event loop until `predicate()` is true
+template <typename Predicate>
+static void poll (Predicate predicate) {
+  while (!predicate()) {
+  #if defined(__linux__) && !defined(__ANDROID__)
+    // the core event loop is a source on the default GLib main context
+    g_main_context_iteration(nullptr, false);
+  #else
+    std::this_thread::yield();
+  #endif
+  }
+}
+
+// stats every path with at most `concurrency` requests in flight, `stat()`
+// is called on the event loop and each request decrements `state.pending`
+template <typename Stat>
+static Measurement scan (
+  Core& core,
+  const Options& options,
+  const Vector<String>& paths,
+  Scan& state,
+  Stat stat
+) {
+  Measurement measurement;
+  const auto before = rss();
+  const auto startedAt = uv_hrtime();
+  uint64_t peak = before;
+
+  for (size_t i = 0; i < paths.size(); ++i) {
+    poll([&]() {
+      return state.pending < (int64_t) options.concurrency;
+    });
+
+    if (i % 1000 == 0) {
+      peak = std::max(peak, rss());
+    }
+
+    state.pending++;
+    core.dispatchEventLoop([&, path = paths[i]]() {
+      stat(path);
+    });
+  }
+
+  poll([&]() { return state.pending <= 0; });
+
+  measurement.elapsed = uv_hrtime() - startedAt;
+  measurement.rss = std::max(peak, rss()) - before;
+  measurement.requests = paths.size();
+  measurement.errors = state.errors;
+  measurement.allocations = state.allocations;
+  return measurement;
+}
+
+static void report (const Options& options, const Vector<Measurement>& measurements) {
+  auto us = [](const Measurement& m) {
+    return m.requests > 0 ? (double) m.elapsed / m.requests / 1000.0 : 0;
+  };
+
+  if (options.json) {
+    JSON::Array results;
+
+    for (const auto& m : measurements) {
+      results.push(JSON::Object::Entries {
+        {"name", m.name},
+        {"contextSize", m.contextSize},
+        {"requests", m.requests},
+        {"errors", m.errors},
+        {"allocations", m.allocations},
+        {"allocatedBytes", m.allocations * m.contextSize},
+        {"rss", m.rss},
+        {"us", us(m)}
+      });
+    }
+
+    auto json = JSON::Object::Entries {
+      {"files", options.files},
+      {"concurrency", options.concurrency},
+      {"results", results}
+    };
+
+    std::cout << JSON::Object(json).str() << std::endl;
+    return;
+  }
+
+  std::cout
+    << "# fs benchmark (" << options.files << " files, concurrency "
+    << options.concurrency << ")\n"
+    << std::left
+    << std::setw(10) << "contexts"
+    << std::setw(14) << "bytes/context"
+    << std::setw(14) << "allocations"
+    << std::setw(18) << "allocated bytes"
+    << std::setw(12) << "RSS KB"
+    << std::setw(12) << "us/request"
+    << "errors\n";
+
+  for (const auto& m : measurements) {
+    std::cout
+      << std::setw(10) << m.name
+      << std::setw(14) << m.contextSize
+      << std::setw(14) << m.allocations
+      << std::setw(18) << m.allocations * m.contextSize
+      << std::setw(12) << m.rss / 1024
+      << std::setw(12) << us(m)
+      << m.errors << "\n";
+  }
+
+  std::cout << std::flush;
+}
+
+int main (int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  const auto directory = std::filesystem::temp_directory_path() /
+    ("socket-fs-benchmark-" + std::to_string(rand64()));
+
+  Vector<String> paths;
+  std::filesystem::create_directories(directory);
+
+  for (uint64_t i = 0; i < options.files; ++i) {
+    const auto path = directory / ("file-" + std::to_string(i));
+    std::ofstream(path.string()).put('\n');
+    paths.push_back(path.string());
+  }
+
+  Core core;
+  auto loop = core.getEventLoop();
+  Vector<Measurement> measurements;
+
+  do {
+    Scan state;
+    const Core::Module::Callback onstat = [&state](auto seq, auto json, auto post) {
+      if (json.template as<JSON::Number>().value() < 0) state.errors++;
+      state.pending--;
+    };
+
+    auto measurement = scan(core, options, paths, state, [&](const String& path) {
+      auto ctx = new LegacyRequestContext();
+      ctx->cb = onstat;
+      state.allocations++;
+
+      uv_fs_stat(loop, &ctx->req, path.c_str(), [](uv_fs_t* req) {
+        auto ctx = (LegacyRequestContext *) req->data;
+        ctx->cb(ctx->seq, JSON::Number((double) req->result), Post{});
+        delete ctx;
+      });
+    });
+
+    measurement.name = "legacy";
+    measurement.contextSize = sizeof(LegacyRequestContext);
+    measurements.push_back(measurement);
+  } while (0);
+
+  do {
+    Scan state;
+    auto& pool = core.fs.requestContexts;
+    const auto allocations = pool.allocations;
+    const Core::Module::Callback onstat = [&state](auto seq, auto json, auto post) {
+      if (json.template as<JSON::Number>().value() < 0) state.errors++;
+      state.pending--;
+    };
+
+    auto measurement = scan(core, options, paths, state, [&](const String& path) {
+      auto ctx = pool.acquire(nullptr, "", onstat);
+
+      uv_fs_stat(loop, &ctx->req, path.c_str(), [](uv_fs_t* req) {
+        auto ctx = (Core::FS::RequestContext *) req->data;
+        ctx->cb(ctx->seq, JSON::Number((double) req->result), Post{});
+        ctx->release();
+      });
+    });
+
+    measurement.name = "pooled";
+    measurement.contextSize = sizeof(Core::FS::RequestContext);
+    measurement.allocations = pool.allocations - allocations;
+    measurements.push_back(measurement);
+  } while (0);
+
+  do {
+    Scan state;
+    auto& pool = core.fs.requestContexts;
+    const auto allocations = pool.allocations;
+
+    // the route itself, including its JSON results
+    auto measurement = scan(core, options, paths, state, [&](const String& path) {
+      core.fs.stat("", path, [&state](auto seq, auto json, auto post) {
+        if (json.template as<JSON::Object>().has("err")) state.errors++;
+        state.pending--;
+      });
+    });
+
+    measurement.name = "fs.stat";
+    measurement.contextSize = sizeof(Core::FS::RequestContext);
+    measurement.allocations = pool.allocations - allocations;
+    measurements.push_back(measurement);
+  } while (0);
+
+  std::error_code error;
+  std::filesystem::remove_all(directory, error);
+
+  uint64_t errors = 0;
+  for (const auto& m : measurements) {
+    errors += m.errors;
+  }
+
+  report(options, measurements);
+  return errors > 0 ? 1 : 0;
+}
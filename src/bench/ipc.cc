@@ -0,0 +1,236 @@
+#include "../core/core.hh"
+#include "../ipc/ipc.hh"
+
+//
+// Replays a trace of `ipc://` invocations recorded by `IPC::Recorder` (see
+// `diagnostics.ipc?record=<path>` or the `[diagnostics] ipc_record` config
+// key) against a `Core` and `IPC::Bridge` without a WebView and reports
+// throughput and latency percentiles.
+//
+// usage: ipc-benchmark <trace> [--iterations <n>] [--concurrency <n>]
+//                              [--timeout <ms>] [--json]
+//
+
+using namespace SSC;
+
+// the benchmark is not an application, so there is no compiled user config
+const Map SSC::getUserConfig () {
+  return Map {};
+}
+
+bool SSC::isDebugEnabled () {
+  return DEBUG == 1;
+}
+
+struct Options {
+  String trace = "";
+  uint64_t iterations = 1;
+  uint64_t concurrency = 1;
+  uint64_t timeout = 5000;
+  bool json = false;
+};
+
+struct Stats {
+  std::atomic<int64_t> pending = 0;
+  std::atomic<uint64_t> completed = 0;
+  std::atomic<uint64_t> errors = 0;
+  std::atomic<uint64_t> missing = 0;
+  std::atomic<uint64_t> bytesOut = 0;
+  uint64_t timedOut = 0;
+  IPC::Histogram latency;
+};
+
+static void printUsage () {
+  std::cerr
+    << "usage: ipc-benchmark <trace> [--iterations <n>] [--concurrency <n>]\n"
+    << "                             [--timeout <ms>] [--json]"
+    << std::endl;
+}
+
+static bool parseOptions (int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    auto arg = String(argv[i]);
+    auto next = [&]() -> uint64_t {
+      if (i + 1 >= argc) throw std::invalid_argument(arg);
+      return std::stoull(argv[++i]);
+    };
+
+    try {
+      if (arg == "--iterations") {
+        options.iterations = next();
+      } else if (arg == "--concurrency") {
+        options.concurrency = std::max((uint64_t) 1, next());
+      } else if (arg == "--timeout") {
+        options.timeout = next();
+      } else if (arg == "--json") {
+        options.json = true;
+      } else if (arg.starts_with("--")) {
+        return false;
+      } else {
+        options.trace = arg;
+      }
+    } catch (...) {
+      return false;
+    }
+  }
+
+  return options.trace.size() > 0;
+}
+
+// drive the core event loop until `predicate()` is true or `timeout` elapses
+template <typename Predicate>
+static bool poll (Predicate predicate, uint64_t timeout) {
+  const auto deadline = uv_hrtime() + timeout * 1000000;
+
+  while (!predicate()) {
+    if (uv_hrtime() > deadline) {
+      return false;
+    }
+
+  #if defined(__linux__) && !defined(__ANDROID__)
+    // the core event loop is a source on the default GLib main context
+    g_main_context_iteration(nullptr, false);
+  #else
+    std::this_thread::yield();
+  #endif
+  }
+
+  return true;
+}
+
+static bool isErrorResult (const IPC::Result& result) {
+  if (!result.err.isNull()) {
+    return true;
+  }
+
+  if (result.value.isObject()) {
+    return result.value.as<JSON::Object>().has("err");
+  }
+
+  return false;
+}
+
+static void report (const Options& options, Stats& stats, uint64_t elapsed) {
+  const auto seconds = (double) elapsed / 1e9;
+  const auto throughput = seconds > 0 ? stats.completed / seconds : 0;
+  auto& latency = stats.latency;
+
+  if (options.json) {
+    auto json = JSON::Object::Entries {
+      {"trace", options.trace},
+      {"iterations", options.iterations},
+      {"concurrency", options.concurrency},
+      {"completed", stats.completed.load()},
+      {"errors", stats.errors.load()},
+      {"missing", stats.missing.load()},
+      {"timedOut", stats.timedOut},
+      {"bytesOut", stats.bytesOut.load()},
+      {"elapsed", elapsed},
+      {"throughput", throughput},
+      {"latency", latency.json()}
+    };
+
+    std::cout << JSON::Object(json).str() << std::endl;
+    return;
+  }
+
+  auto us = [](uint64_t ns) { return (double) ns / 1000.0; };
+
+  std::cout
+    << "# ipc benchmark: " << options.trace << "\n"
+    << "iterations:  " << options.iterations
+    << " (concurrency " << options.concurrency << ")\n"
+    << "completed:   " << stats.completed
+    << " (errors " << stats.errors
+    << ", not found " << stats.missing
+    << ", timed out " << stats.timedOut << ")\n"
+    << "elapsed:     " << us(elapsed) / 1000.0 << " ms\n"
+    << "throughput:  " << throughput << " ops/s\n"
+    << "bytes out:   " << stats.bytesOut << "\n"
+    << "latency us:  "
+    << "min " << us(latency.count > 0 ? latency.min.load() : 0)
+    << " p50 " << us(latency.percentile(0.50))
+    << " p90 " << us(latency.percentile(0.90))
+    << " p99 " << us(latency.percentile(0.99))
+    << " p999 " << us(latency.percentile(0.999))
+    << " max " << us(latency.max)
+    << std::endl;
+}
+
+int main (int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  const auto entries = IPC::Recorder::load(options.trace);
+
+  if (entries.size() == 0) {
+    std::cerr << "error: '" << options.trace << "' is not a valid trace" << std::endl;
+    return 1;
+  }
+
+  Core core;
+  IPC::Bridge bridge(&core);
+  Stats stats;
+
+  // route handlers run on the replaying thread in place of the UI thread
+  bridge.router.dispatchFunction = [](auto callback) {
+    callback();
+  };
+
+  // the WebView is replaced by a sink that only accounts for the bytes
+  // of JavaScript that would be evaluated
+  bridge.router.evaluateJavaScriptFunction = [&stats](auto js) {
+    stats.bytesOut += js.size();
+  };
+
+  const auto startedAt = uv_hrtime();
+
+  for (uint64_t i = 0; i < options.iterations; ++i) {
+    for (const auto& entry : entries) {
+      poll([&]() {
+        return stats.pending < (int64_t) options.concurrency;
+      }, options.timeout);
+
+      const auto invokedAt = uv_hrtime();
+      stats.pending++;
+
+      auto invoked = bridge.router.invoke(
+        entry.uri,
+        entry.bytes.data(),
+        entry.bytes.size(),
+        [&stats, &bridge, invokedAt](auto result) {
+          bridge.router.send(result);
+          stats.latency.record(uv_hrtime() - invokedAt);
+
+          if (isErrorResult(result)) {
+            stats.errors++;
+          }
+
+          stats.completed++;
+          stats.pending--;
+        }
+      );
+
+      if (!invoked) {
+        stats.missing++;
+        stats.pending--;
+      }
+    }
+
+    // routes that never reply (or reply more than once) are not waited on
+    if (!poll([&]() { return stats.pending <= 0; }, options.timeout)) {
+      stats.timedOut += (uint64_t) stats.pending.load();
+      stats.pending = 0;
+    }
+
+    // the WebView would have consumed these
+    core.removeAllPosts();
+  }
+
+  report(options, stats, uv_hrtime() - startedAt);
+  return 0;
+}
@@ -0,0 +1,261 @@
+#include "../core/json.hh"
+
+//
+// Measures `JSON::parse()` (with and without a `JSON::Arena`) and
+// `JSON::write()` throughput over payload shapes that are common on the IPC
+// bridge and in extensions.
+//
+// usage: json-benchmark [--iterations <n>] [--json] [name ...]
+//
+
+using namespace SSC;
+
+struct Options {
+  uint64_t iterations = 1000;
+  bool json = false;
+  Vector<String> names;
+};
+
+struct Payload {
+  String name;
+  String source;
+};
+
+struct Measurement {
+  String name;
+  size_t size = 0;
+  uint64_t parse = 0; // nanoseconds, all iterations
+  uint64_t parseArena = 0; // nanoseconds, all iterations
+  uint64_t serialize = 0; // nanoseconds, all iterations
+};
+
+static uint64_t now () {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count();
+}
+
+static void printUsage () {
+  std::cerr
+    << "usage: json-benchmark [--iterations <n>] [--json] [name ...]"
+    << std::endl;
+}
+
+static bool parseOptions (int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    auto arg = String(argv[i]);
+
+    try {
+      if (arg == "--iterations") {
+        if (i + 1 >= argc) return false;
+        options.iterations = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--json") {
+        options.json = true;
+      } else if (arg.starts_with("--")) {
+        return false;
+      } else {
+        options.names.push_back(arg);
+      }
+    } catch (...) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// an `fs.stat` style result
+static JSON::Any createStat (uint64_t i) {
+  return JSON::Object::Entries {
+    {"dev", 16777220},
+    {"mode", 33188},
+    {"nlink", 1},
+    {"uid", 501},
+    {"gid", 20},
+    {"rdev", 0},
+    {"blksize", 4096},
+    {"ino", 12884901888 + i},
+    {"size", 1024 * i},
+    {"blocks", 8},
+    {"atimeMs", 1681234567890.123},
+    {"mtimeMs", 1681234567890.456},
+    {"ctimeMs", 1681234567891.789},
+    {"birthtimeMs", 1681234560000}
+  };
+}
+
+static Vector<Payload> createPayloads () {
+  Vector<Payload> payloads;
+
+  payloads.push_back({
+    "stat",
+    JSON::Object(JSON::Object::Entries {
+      {"source", "fs.stat"},
+      {"data", createStat(0)}
+    }).str()
+  });
+
+  JSON::Array entries;
+  for (int i = 0; i < 1000; ++i) {
+    entries.push(JSON::Object::Entries {
+      {"name", "file-" + std::to_string(i) + ".txt"},
+      {"type", i % 7 == 0 ? 2 : 1}
+    });
+  }
+
+  payloads.push_back({
+    "readdir",
+    JSON::Object(JSON::Object::Entries {
+      {"source", "fs.readdir"},
+      {"data", entries}
+    }).str()
+  });
+
+  JSON::Array numbers;
+  for (int i = 0; i < 10000; ++i) {
+    if (i % 2 == 0) {
+      numbers.push(i * 7919);
+    } else {
+      numbers.push(i / 3.0);
+    }
+  }
+
+  payloads.push_back({"numbers", numbers.str()});
+
+  String text;
+  for (int i = 0; i < 2000; ++i) {
+    text += "line " + std::to_string(i) + "\t\"quoted\"\n";
+  }
+
+  payloads.push_back({
+    "strings",
+    JSON::Object(JSON::Object::Entries {
+      {"text", text},
+      {"plain", String(64 * 1024, 'x')}
+    }).str()
+  });
+
+  JSON::Any config = JSON::Object::Entries {{"value", true}};
+  for (int i = 0; i < 64; ++i) {
+    config = JSON::Object::Entries {
+      {"depth", i},
+      {"name", "section"},
+      {"enabled", i % 2 == 0},
+      {"children", JSON::Array::Entries { config, nullptr }}
+    };
+  }
+
+  payloads.push_back({"nested", config.str()});
+
+  return payloads;
+}
+
+static void report (const Options& options, const Vector<Measurement>& measurements) {
+  auto throughput = [&](size_t size, uint64_t elapsed) {
+    const auto seconds = (double) elapsed / 1e9;
+    const auto megabytes = (double) size * options.iterations / (1024 * 1024);
+    return seconds > 0 ? megabytes / seconds : 0;
+  };
+
+  if (options.json) {
+    JSON::Array results;
+
+    for (const auto& m : measurements) {
+      results.push(JSON::Object::Entries {
+        {"name", m.name},
+        {"size", m.size},
+        {"parse", throughput(m.size, m.parse)},
+        {"parseArena", throughput(m.size, m.parseArena)},
+        {"serialize", throughput(m.size, m.serialize)}
+      });
+    }
+
+    auto json = JSON::Object::Entries {
+      {"iterations", options.iterations},
+      {"unit", "MB/s"},
+      {"results", results}
+    };
+
+    std::cout << JSON::Object(json).str() << std::endl;
+    return;
+  }
+
+  std::cout
+    << "# json benchmark (" << options.iterations << " iterations)\n"
+    << std::left
+    << std::setw(10) << "payload"
+    << std::setw(12) << "bytes"
+    << std::setw(16) << "parse MB/s"
+    << std::setw(16) << "arena MB/s"
+    << "serialize MB/s\n";
+
+  for (const auto& m : measurements) {
+    std::cout
+      << std::setw(10) << m.name
+      << std::setw(12) << m.size
+      << std::setw(16) << throughput(m.size, m.parse)
+      << std::setw(16) << throughput(m.size, m.parseArena)
+      << throughput(m.size, m.serialize) << "\n";
+  }
+
+  std::cout << std::flush;
+}
+
+int main (int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  Vector<Measurement> measurements;
+  String buffer;
+
+  for (const auto& payload : createPayloads()) {
+    if (options.names.size() > 0) {
+      const auto& names = options.names;
+      if (std::find(names.begin(), names.end(), payload.name) == names.end()) {
+        continue;
+      }
+    }
+
+    Measurement measurement;
+    measurement.name = payload.name;
+    measurement.size = payload.source.size();
+
+    JSON::Any value;
+
+    try {
+      value = JSON::parse(payload.source);
+    } catch (const JSON::Error& error) {
+      std::cerr << "error: " << payload.name << ": " << error.str() << std::endl;
+      return 1;
+    }
+
+    auto startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      value = JSON::parse(payload.source);
+    }
+    measurement.parse = now() - startedAt;
+
+    startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      JSON::Arena::Scope arena;
+      value = JSON::parse(payload.source);
+    }
+    measurement.parseArena = now() - startedAt;
+
+    startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      buffer.clear();
+      JSON::write(buffer, value);
+    }
+    measurement.serialize = now() - startedAt;
+
+    measurements.push_back(measurement);
+  }
+
+  report(options, measurements);
+  return 0;
+}
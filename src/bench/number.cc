@@ -0,0 +1,201 @@
+#include "../core/json.hh"
+#include <random>
+
+//
+// Measures `JSON::Number` serialization over classes of numbers that are
+// common in IPC results (small integers, sizes and ids, millisecond
+// timestamps with a fraction, and arbitrary doubles) and verifies that
+// every formatted value reads back as the same double.
+//
+// usage: number-benchmark [--iterations <n>] [--json]
+//
+
+using namespace SSC;
+
+struct Options {
+  uint64_t iterations = 100;
+  bool json = false;
+};
+
+struct Sample {
+  String name;
+  Vector<double> values;
+};
+
+struct Measurement {
+  String name;
+  uint64_t count = 0;
+  uint64_t str = 0; // nanoseconds, all iterations
+  uint64_t write = 0; // nanoseconds, all iterations
+  uint64_t inexact = 0;
+};
+
+static uint64_t now () {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count();
+}
+
+static void printUsage () {
+  std::cerr << "usage: number-benchmark [--iterations <n>] [--json]" << std::endl;
+}
+
+static bool parseOptions (int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    auto arg = String(argv[i]);
+
+    try {
+      if (arg == "--iterations") {
+        if (i + 1 >= argc) return false;
+        options.iterations = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--json") {
+        options.json = true;
+      } else {
+        return false;
+      }
+    } catch (...) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static Vector<Sample> createSamples () {
+  static constexpr int count = 10000;
+  std::mt19937_64 random(0x5eed);
+  Vector<Sample> samples;
+
+  Sample small = { "small", {} };
+  Sample large = { "large", {} };
+  Sample timestamps = { "timestamps", {} };
+  Sample doubles = { "doubles", {} };
+
+  for (int i = 0; i < count; ++i) {
+    small.values.push_back((double) (random() % 4096));
+    large.values.push_back((double) (random() >> 11));
+    timestamps.values.push_back(
+      1681234567890.0 + (double) (random() % 100000000) / 1000.0
+    );
+
+    double value = 0;
+    do {
+      auto bits = random();
+      std::memcpy(&value, &bits, sizeof(value));
+    } while (!std::isfinite(value));
+
+    doubles.values.push_back(value);
+  }
+
+  samples.push_back(small);
+  samples.push_back(large);
+  samples.push_back(timestamps);
+  samples.push_back(doubles);
+
+  return samples;
+}
+
+static void report (const Options& options, const Vector<Measurement>& measurements) {
+  auto ns = [&](const Measurement& m, uint64_t elapsed) {
+    const auto operations = m.count * options.iterations;
+    return operations > 0 ? (double) elapsed / operations : 0;
+  };
+
+  if (options.json) {
+    JSON::Array results;
+
+    for (const auto& m : measurements) {
+      results.push(JSON::Object::Entries {
+        {"name", m.name},
+        {"count", m.count},
+        {"str", ns(m, m.str)},
+        {"write", ns(m, m.write)},
+        {"inexact", m.inexact}
+      });
+    }
+
+    auto json = JSON::Object::Entries {
+      {"iterations", options.iterations},
+      {"unit", "ns/op"},
+      {"results", results}
+    };
+
+    std::cout << JSON::Object(json).str() << std::endl;
+    return;
+  }
+
+  std::cout
+    << "# number benchmark (" << options.iterations << " iterations)\n"
+    << std::left
+    << std::setw(12) << "sample"
+    << std::setw(14) << "str() ns"
+    << std::setw(14) << "write() ns"
+    << "inexact\n";
+
+  for (const auto& m : measurements) {
+    std::cout
+      << std::setw(12) << m.name
+      << std::setw(14) << ns(m, m.str)
+      << std::setw(14) << ns(m, m.write)
+      << m.inexact << "\n";
+  }
+
+  std::cout << std::flush;
+}
+
+int main (int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  Vector<Measurement> measurements;
+  uint64_t inexact = 0;
+  uint64_t checksum = 0;
+  String buffer;
+
+  for (const auto& sample : createSamples()) {
+    Measurement measurement;
+    measurement.name = sample.name;
+    measurement.count = sample.values.size();
+
+    for (const auto value : sample.values) {
+      const auto output = JSON::Number(value).str();
+      if (std::strtod(output.c_str(), nullptr) != value) {
+        measurement.inexact++;
+      }
+    }
+
+    auto startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      for (const auto value : sample.values) {
+        checksum += JSON::Number(value).str().size();
+      }
+    }
+    measurement.str = now() - startedAt;
+
+    startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      for (const auto value : sample.values) {
+        buffer.clear();
+        JSON::write(buffer, value);
+        checksum += buffer.size();
+      }
+    }
+    measurement.write = now() - startedAt;
+
+    inexact += measurement.inexact;
+    measurements.push_back(measurement);
+  }
+
+  // keep the formatting from being optimized away
+  if (checksum == 0) {
+    std::cerr << "error: nothing was formatted" << std::endl;
+    return 1;
+  }
+
+  report(options, measurements);
+  return inexact > 0 ? 1 : 0;
+}
@@ -0,0 +1,286 @@
+#include "../core/core.hh"
+#include <filesystem>
+
+//
+// Measures streaming a file through `Core::FS::read()` the way a
+// `ReadStream` does: one chunk at a time at increasing offsets, each read
+// issued after the previous reply arrived. The file is streamed once without
+// read-ahead and once with the default number of chunks read ahead
+// (`Core::FS::setReadAhead()`). `--delay` simulates the time the
+// WebView takes between receiving a chunk and asking for the next one. On
+// Linux the file is dropped from the page cache before each pass with
+// `posix_fadvise(POSIX_FADV_DONTNEED)` unless `--warm` is given.
+//
+// usage: readahead-benchmark [--size <bytes>] [--chunk <bytes>] [--delay <us>] [--warm] [--json]
+//
+
+using namespace SSC;
+
+// the benchmark is not an application, so there is no compiled user config
+const Map SSC::getUserConfig () {
+  return Map {};
+}
+
+bool SSC::isDebugEnabled () {
+  return DEBUG == 1;
+}
+
+struct Options {
+  uint64_t size = 1024 * 1024 * 1024;
+  uint64_t chunk = 64 * 1024;
+  uint64_t delay = 0; // microseconds
+  bool warm = false;
+  bool json = false;
+};
+
+struct Measurement {
+  String name;
+  size_t chunks = 0;
+  uint64_t bytes = 0;
+  uint64_t reads = 0;
+  uint64_t hits = 0;
+  uint64_t errors = 0;
+  uint64_t elapsed = 0; // nanoseconds
+};
+
+static void printUsage () {
+  std::cerr
+    << "usage: readahead-benchmark [--size <bytes>] [--chunk <bytes>] [--delay <us>] [--warm] [--json]"
+    << std::endl;
+}
+
+static bool parseOptions (int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    auto arg = String(argv[i]);
+
+    try {
+      if (arg == "--size") {
+        if (i + 1 >= argc) return false;
+        options.size = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--chunk") {
+        if (i + 1 >= argc) return false;
+        options.chunk = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--delay") {
+        if (i + 1 >= argc) return false;
+        options.delay = std::stoull(argv[++i]);
+      } else if (arg == "--warm") {
+        options.warm = true;
+      } else if (arg == "--json") {
+        options.json = true;
+      } else {
+        return false;
+      }
+    } catch (...) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// drive the core event loop until `predicate()` is true
+template <typename Predicate>
+static void poll (Predicate predicate) {
+  while (!predicate()) {
+  #if defined(__linux__) && !defined(__ANDROID__)
+    // the core event loop is a source on the default GLib main context
+    g_main_context_iteration(nullptr, false);
+  #else
+    std::this_thread::yield();
+  #endif
+  }
+}
+
+// waits for the reply of a request made with `request(callback)`
+template <typename Request>
+static JSON::Any call (Post& post, Request request) {
+  std::atomic<bool> done = false;
+  JSON::Any result;
+
+  request([&](auto seq, auto json, auto reply) {
+    result = json;
+    post = reply;
+    done = true;
+  });
+
+  poll([&]() { return done.load(); });
+  return result;
+}
+
+static void evict (const String& path) {
+#if defined(__linux__)
+  auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+  }
+#endif
+}
+
+static Measurement stream (
+  Core& core,
+  const Options& options,
+  const String& path,
+  size_t chunks
+) {
+  Measurement measurement;
+  measurement.chunks = chunks;
+  measurement.name = chunks > 0 ? "read-ahead" : "on demand";
+
+  if (!options.warm) {
+    evict(path);
+  }
+
+  const auto id = rand64();
+  const auto hits = core.fs.readAheadHits;
+  Post post;
+
+  call(post, [&](auto cb) {
+    core.fs.open("", id, path, O_RDONLY, 0, cb);
+  });
+
+  call(post, [&](auto cb) {
+    core.fs.setReadAhead("", id, chunks, cb);
+  });
+
+  const auto startedAt = uv_hrtime();
+
+  while (true) {
+    auto json = call(post, [&](auto cb) {
+      core.fs.read("", id, options.chunk, measurement.bytes, cb);
+    });
+
+    measurement.reads++;
+
+    if (json.template as<JSON::Object>().has("err")) {
+      measurement.errors++;
+      break;
+    }
+
+    const auto length = post.body != nullptr ? (uint64_t) post.length : 0;
+    freePostBody(post);
+
+    if (length == 0) {
+      break;
+    }
+
+    measurement.bytes += length;
+
+    if (options.delay > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(options.delay));
+    }
+  }
+
+  measurement.elapsed = uv_hrtime() - startedAt;
+  measurement.hits = core.fs.readAheadHits - hits;
+
+  call(post, [&](auto cb) {
+    core.fs.close("", id, cb);
+  });
+
+  if (measurement.bytes != options.size) {
+    measurement.errors++;
+  }
+
+  return measurement;
+}
+
+static void report (const Options& options, const Vector<Measurement>& measurements) {
+  auto mbps = [](const Measurement& m) {
+    const auto seconds = (double) m.elapsed / 1e9;
+    return seconds > 0 ? (double) m.bytes / (1024 * 1024) / seconds : 0;
+  };
+
+  if (options.json) {
+    JSON::Array results;
+
+    for (const auto& m : measurements) {
+      results.push(JSON::Object::Entries {
+        {"name", m.name},
+        {"chunks", m.chunks},
+        {"bytes", m.bytes},
+        {"reads", m.reads},
+        {"hits", m.hits},
+        {"errors", m.errors},
+        {"mbps", mbps(m)}
+      });
+    }
+
+    auto json = JSON::Object::Entries {
+      {"size", options.size},
+      {"chunk", options.chunk},
+      {"delay", options.delay},
+      {"warm", options.warm},
+      {"results", results}
+    };
+
+    std::cout << JSON::Object(json).str() << std::endl;
+    return;
+  }
+
+  std::cout
+    << "# readahead benchmark (" << options.size << " bytes in "
+    << options.chunk << " byte chunks, " << options.delay << " us delay, "
+    << (options.warm ? "warm" : "cold") << " cache)\n"
+    << std::left
+    << std::setw(12) << "reads"
+    << std::setw(8) << "chunks"
+    << std::setw(10) << "MB/s"
+    << std::setw(10) << "hits"
+    << "errors\n";
+
+  for (const auto& m : measurements) {
+    std::cout
+      << std::setw(12) << m.name
+      << std::setw(8) << m.chunks
+      << std::setw(10) << (uint64_t) mbps(m)
+      << std::setw(10) << m.hits
+      << m.errors << "\n";
+  }
+
+  std::cout << std::flush;
+}
+
+int main (int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  const auto path = (
+    std::filesystem::temp_directory_path() /
+    ("socket-readahead-benchmark-" + std::to_string(rand64()))
+  ).string();
+
+  do {
+    std::ofstream file(path, std::ios::binary);
+    Vector<char> chunk(1024 * 1024);
+
+    for (size_t i = 0; i < chunk.size(); ++i) {
+      chunk[i] = (char) (i * 31 + 7);
+    }
+
+    for (uint64_t written = 0; written < options.size; written += chunk.size()) {
+      file.write(chunk.data(), std::min((uint64_t) chunk.size(), options.size - written));
+    }
+  } while (0);
+
+  Core core;
+  Vector<Measurement> measurements;
+  uint64_t errors = 0;
+
+  for (const auto chunks : { (size_t) 0, Core::FS::READ_AHEAD_CHUNKS }) {
+    auto measurement = stream(core, options, path, chunks);
+    errors += measurement.errors;
+    measurements.push_back(measurement);
+  }
+
+  std::error_code error;
+  std::filesystem::remove(path, error);
+
+  report(options, measurements);
+  return errors > 0 ? 1 : 0;
+}
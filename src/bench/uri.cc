@@ -0,0 +1,351 @@
+#include "../core/json.hh"
+#include <random>
+
+//
+// Measures `encodeURIComponent()` and `decodeURIComponent()` throughput over
+// payloads that are common on the IPC bridge and compares both against the
+// previous byte-at-a-time implementations, first over the payloads and then
+// over `--fuzz <n>` random inputs. Any difference is reported and fails the
+// benchmark.
+//
+// usage: uri-benchmark [--iterations <n>] [--fuzz <n>] [--json] [name ...]
+//
+
+using namespace SSC;
+
+struct Options {
+  uint64_t iterations = 1000;
+  uint64_t fuzz = 100000;
+  bool json = false;
+  Vector<String> names;
+};
+
+struct Payload {
+  String name;
+  String source;
+};
+
+struct Measurement {
+  String name;
+  size_t size = 0;
+  uint64_t encode = 0; // nanoseconds, all iterations
+  uint64_t encodeLegacy = 0; // nanoseconds, all iterations
+  uint64_t decode = 0; // nanoseconds, all iterations
+  uint64_t decodeLegacy = 0; // nanoseconds, all iterations
+};
+
+static uint64_t now () {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count();
+}
+
+static void printUsage () {
+  std::cerr
+    << "usage: uri-benchmark [--iterations <n>] [--fuzz <n>] [--json] [name ...]"
+    << std::endl;
+}
+
+static bool parseOptions (int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    auto arg = String(argv[i]);
+
+    try {
+      if (arg == "--iterations") {
+        if (i + 1 >= argc) return false;
+        options.iterations = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--fuzz") {
+        if (i + 1 >= argc) return false;
+        options.fuzz = std::stoull(argv[++i]);
+      } else if (arg == "--json") {
+        options.json = true;
+      } else if (arg.starts_with("--")) {
+        return false;
+      } else {
+        options.names.push_back(arg);
+      }
+    } catch (...) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// the implementations that walked `SAFE` and `HEX2DEC` one byte at a time
+static String legacyDecodeURIComponent (const String& sSrc) {
+  auto s = replace(sSrc, "\\+", " ");
+  const unsigned char* pSrc = (const unsigned char *) s.c_str();
+  const int SRC_LEN = (int) sSrc.length();
+  const unsigned char* const SRC_END = pSrc + SRC_LEN;
+  const unsigned char* const SRC_LAST_DEC = SRC_END - 2;
+
+  char* const pStart = new char[SRC_LEN];
+  char* pEnd = pStart;
+
+  while (pSrc < SRC_LAST_DEC) {
+    if (*pSrc == '%') {
+      char dec1, dec2;
+      if (-1 != (dec1 = HEX2DEC[*(pSrc + 1)])
+          && -1 != (dec2 = HEX2DEC[*(pSrc + 2)])) {
+
+          *pEnd++ = (dec1 << 4) + dec2;
+          pSrc += 3;
+          continue;
+      }
+    }
+    *pEnd++ = *pSrc++;
+  }
+
+  while (pSrc < SRC_END) {
+    *pEnd++ = *pSrc++;
+  }
+
+  String sResult(pStart, pEnd);
+  delete [] pStart;
+  return sResult;
+}
+
+static String legacyEncodeURIComponent (const String& sSrc) {
+  const char DEC2HEX[16 + 1] = "0123456789ABCDEF";
+  const unsigned char* pSrc = (const unsigned char*) sSrc.c_str();
+  const int SRC_LEN = (int) sSrc.length();
+  unsigned char* const pStart = new unsigned char[SRC_LEN* 3];
+  unsigned char* pEnd = pStart;
+  const unsigned char* const SRC_END = pSrc + SRC_LEN;
+
+  for (; pSrc < SRC_END; ++pSrc) {
+    if (SAFE[*pSrc]) {
+      *pEnd++ = *pSrc;
+    } else {
+      *pEnd++ = '%';
+      *pEnd++ = DEC2HEX[*pSrc >> 4];
+      *pEnd++ = DEC2HEX[*pSrc & 0x0F];
+    }
+  }
+
+  String sResult((char*) pStart, (char*) pEnd);
+  delete [] pStart;
+  return sResult;
+}
+
+static Vector<Payload> createPayloads () {
+  Vector<Payload> payloads;
+
+  // an `fs.readdir` style reply, mostly escaped punctuation
+  String readdir = "{\"source\":\"fs.readdir\",\"data\":[";
+  for (int i = 0; i < 1000; ++i) {
+    if (i > 0) readdir += ",";
+    readdir += "{\"name\":\"file-" + std::to_string(i) + ".txt\",\"type\":1}";
+  }
+  readdir += "]}";
+  payloads.push_back({"readdir", readdir});
+
+  // an `fs.read` style reply, long runs of base64
+  String base64;
+  std::mt19937 random(0x5eed);
+  static const char alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  for (int i = 0; i < 64 * 1024; ++i) {
+    base64 += alphabet[random() % 64];
+  }
+  payloads.push_back({"base64", "{\"data\":\"" + base64 + "\"}"});
+
+  // `ipc://` arguments, mostly plain words
+  String args;
+  for (int i = 0; i < 500; ++i) {
+    args += "seq=R" + std::to_string(i) + "&path=Documents/notes " + std::to_string(i) + "&";
+  }
+  payloads.push_back({"args", args});
+
+  String text;
+  for (int i = 0; i < 2000; ++i) {
+    text += "line " + std::to_string(i) + "\t\"quoted\" caf\xc3\xa9\n";
+  }
+  payloads.push_back({"text", text});
+
+  return payloads;
+}
+
+static String toHex (const String& input) {
+  return input.size() > 0 ? stringToHex(input) : String("(empty)");
+}
+
+// random inputs biased toward the bytes that either implementation treats
+// specially ('%', '+', hex digits) and toward sizes around the chunk sizes
+static uint64_t fuzz (uint64_t count) {
+  static const char special[] = "%+0123456789abcdefABCDEFgG%%+ ";
+  std::mt19937_64 random(0xf022);
+  uint64_t mismatches = 0;
+
+  for (uint64_t i = 0; i < count; ++i) {
+    const auto size = random() % 100;
+    String input(size, '\0');
+
+    for (auto& c : input) {
+      const auto r = random();
+      if (r % 4 == 0) {
+        c = (char) (r >> 8);
+      } else if (r % 4 == 1) {
+        c = (char) ('a' + (r >> 8) % 26);
+      } else {
+        c = special[(r >> 8) % (sizeof(special) - 1)];
+      }
+    }
+
+    const auto encoded = encodeURIComponent(input);
+
+    if (encoded != legacyEncodeURIComponent(input)) {
+      std::cerr << "error: encodeURIComponent differs for " << toHex(input) << std::endl;
+      mismatches++;
+    }
+
+    if (decodeURIComponent(input) != legacyDecodeURIComponent(input)) {
+      std::cerr << "error: decodeURIComponent differs for " << toHex(input) << std::endl;
+      mismatches++;
+    }
+
+    if (decodeURIComponent(encoded) != input) {
+      std::cerr << "error: decodeURIComponent does not round trip " << toHex(input) << std::endl;
+      mismatches++;
+    }
+  }
+
+  return mismatches;
+}
+
+static void report (
+  const Options& options,
+  const Vector<Measurement>& measurements,
+  uint64_t mismatches
+) {
+  auto throughput = [&](size_t size, uint64_t elapsed) {
+    const auto seconds = (double) elapsed / 1e9;
+    const auto megabytes = (double) size * options.iterations / (1024 * 1024);
+    return seconds > 0 ? megabytes / seconds : 0;
+  };
+
+  if (options.json) {
+    JSON::Array results;
+
+    for (const auto& m : measurements) {
+      results.push(JSON::Object::Entries {
+        {"name", m.name},
+        {"size", m.size},
+        {"encode", throughput(m.size, m.encode)},
+        {"encodeLegacy", throughput(m.size, m.encodeLegacy)},
+        {"decode", throughput(m.size, m.decode)},
+        {"decodeLegacy", throughput(m.size, m.decodeLegacy)}
+      });
+    }
+
+    auto json = JSON::Object::Entries {
+      {"iterations", options.iterations},
+      {"fuzz", options.fuzz},
+      {"mismatches", mismatches},
+      {"unit", "MB/s"},
+      {"results", results}
+    };
+
+    std::cout << JSON::Object(json).str() << std::endl;
+    return;
+  }
+
+  std::cout
+    << "# uri benchmark (" << options.iterations << " iterations, "
+    << options.fuzz << " fuzzed inputs, " << mismatches << " mismatches)\n"
+    << std::left
+    << std::setw(10) << "payload"
+    << std::setw(10) << "bytes"
+    << std::setw(14) << "encode MB/s"
+    << std::setw(14) << "(legacy)"
+    << std::setw(14) << "decode MB/s"
+    << "(legacy)\n";
+
+  for (const auto& m : measurements) {
+    std::cout
+      << std::setw(10) << m.name
+      << std::setw(10) << m.size
+      << std::setw(14) << throughput(m.size, m.encode)
+      << std::setw(14) << throughput(m.size, m.encodeLegacy)
+      << std::setw(14) << throughput(m.size, m.decode)
+      << throughput(m.size, m.decodeLegacy) << "\n";
+  }
+
+  std::cout << std::flush;
+}
+
+int main (int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  Vector<Measurement> measurements;
+  uint64_t mismatches = 0;
+  uint64_t checksum = 0;
+
+  for (const auto& payload : createPayloads()) {
+    if (options.names.size() > 0) {
+      const auto& names = options.names;
+      if (std::find(names.begin(), names.end(), payload.name) == names.end()) {
+        continue;
+      }
+    }
+
+    Measurement measurement;
+    measurement.name = payload.name;
+    measurement.size = payload.source.size();
+
+    const auto encoded = legacyEncodeURIComponent(payload.source);
+
+    if (encodeURIComponent(payload.source) != encoded) {
+      std::cerr << "error: " << payload.name << ": encodeURIComponent differs" << std::endl;
+      mismatches++;
+    }
+
+    if (decodeURIComponent(encoded) != legacyDecodeURIComponent(encoded)) {
+      std::cerr << "error: " << payload.name << ": decodeURIComponent differs" << std::endl;
+      mismatches++;
+    }
+
+    auto startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      checksum += encodeURIComponent(payload.source).size();
+    }
+    measurement.encode = now() - startedAt;
+
+    startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      checksum += legacyEncodeURIComponent(payload.source).size();
+    }
+    measurement.encodeLegacy = now() - startedAt;
+
+    startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      checksum += decodeURIComponent(encoded).size();
+    }
+    measurement.decode = now() - startedAt;
+
+    startedAt = now();
+    for (uint64_t i = 0; i < options.iterations; ++i) {
+      checksum += legacyDecodeURIComponent(encoded).size();
+    }
+    measurement.decodeLegacy = now() - startedAt;
+
+    measurements.push_back(measurement);
+  }
+
+  mismatches += fuzz(options.fuzz);
+
+  // keep the conversions from being optimized away
+  if (checksum == 0 && measurements.size() > 0) {
+    std::cerr << "error: nothing was converted" << std::endl;
+    return 1;
+  }
+
+  report(options, measurements, mismatches);
+  return mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,292 @@
+#include "../core/core.hh"
+#include <filesystem>
+#include <random>
+
+//
+// Measures random 4 KB reads from a file at several queue depths, once
+// through the libuv threadpool (`uv_fs_read()`) and once through the
+// io_uring backend of `Core::FS` (`Core::FS::URing::read()`). Each read is
+// issued from the completion of the previous one on its slot, so `depth`
+// reads are in flight at all times. The file is written before it is read
+// and is likely in the page cache, so the difference is the cost of
+// getting a read to the kernel and its result back to the loop.
+//
+// usage: uring-benchmark [--size <bytes>] [--reads <n>] [--json] [depth ...]
+//
+
+using namespace SSC;
+
+// the benchmark is not an application, the io_uring backend is enabled as
+// `[linux] io_uring = true` would
+const Map SSC::getUserConfig () {
+  return Map {{"linux_io_uring", "true"}};
+}
+
+bool SSC::isDebugEnabled () {
+  return DEBUG == 1;
+}
+
+static constexpr size_t READ_SIZE = 4096;
+
+struct Options {
+  uint64_t size = 256 * 1024 * 1024;
+  uint64_t reads = 100000;
+  bool json = false;
+  Vector<uint64_t> depths;
+};
+
+struct Measurement {
+  String backend;
+  uint64_t depth = 0;
+  uint64_t reads = 0;
+  uint64_t errors = 0;
+  uint64_t elapsed = 0; // nanoseconds
+};
+
+struct Scan;
+
+struct Read {
+  uv_fs_t req;
+  uv_buf_t buffer;
+  char bytes[READ_SIZE];
+  Scan *scan = nullptr;
+};
+
+struct Scan {
+  uv_loop_t *loop = nullptr;
+  Core::FS::URing *uring = nullptr;
+  uv_file fd = -1;
+  uint64_t blocks = 0;
+  uint64_t remaining = 0;
+  uint64_t errors = 0;
+  std::mt19937_64 random { 0x5eed };
+};
+
+static void printUsage () {
+  std::cerr
+    << "usage: uring-benchmark [--size <bytes>] [--reads <n>] [--json] [depth ...]"
+    << std::endl;
+}
+
+static bool parseOptions (int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    auto arg = String(argv[i]);
+
+    try {
+      if (arg == "--size") {
+        if (i + 1 >= argc) return false;
+        options.size = std::max((uint64_t) READ_SIZE, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--reads") {
+        if (i + 1 >= argc) return false;
+        options.reads = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--json") {
+        options.json = true;
+      } else if (arg.starts_with("--")) {
+        return false;
+      } else {
+        options.depths.push_back(std::max((uint64_t) 1, (uint64_t) std::stoull(arg)));
+      }
+    } catch (...) {
+      return false;
+    }
+  }
+
+  if (options.depths.size() == 0) {
+    options.depths = { 1, 32, 128 };
+  }
+
+  return true;
+}
+
+static void onread (uv_fs_t* req);
+
+static void submit (Read* read) {
+  auto scan = read->scan;
+  const auto offset = (int64_t) ((scan->random() % scan->blocks) * READ_SIZE);
+
+  scan->remaining--;
+  uv_fs_req_cleanup(&read->req);
+
+  if (scan->uring != nullptr) {
+    scan->uring->read(scan->loop, &read->req, scan->fd, &read->buffer, 1, offset, onread);
+  } else {
+    uv_fs_read(scan->loop, &read->req, scan->fd, &read->buffer, 1, offset, onread);
+  }
+}
+
+static void onread (uv_fs_t* req) {
+  auto read = (Read *) req->data;
+
+  if (req->result != (ssize_t) READ_SIZE) {
+    read->scan->errors++;
+  }
+
+  if (read->scan->remaining > 0) {
+    submit(read);
+  }
+}
+
+static Measurement measure (
+  const Options& options,
+  const String& path,
+  uint64_t depth,
+  bool useURing
+) {
+  Measurement measurement;
+  measurement.backend = useURing ? "io_uring" : "threadpool";
+  measurement.depth = depth;
+  measurement.reads = options.reads;
+
+  // a ring cannot be detached from its loop, so both are kept for the
+  // lifetime of the benchmark when io_uring is measured
+  auto loop = new uv_loop_t;
+  auto uring = new Core::FS::URing();
+  uv_loop_init(loop);
+
+  Scan scan;
+  scan.loop = loop;
+  scan.uring = useURing ? uring : nullptr;
+  scan.blocks = options.size / READ_SIZE;
+  scan.remaining = options.reads;
+
+  uv_fs_t req;
+  scan.fd = uv_fs_open(nullptr, &req, path.c_str(), UV_FS_O_RDONLY, 0, nullptr);
+  uv_fs_req_cleanup(&req);
+
+  if (useURing && !uring->init(loop)) {
+    std::cerr << "warning: io_uring is not available, reads use the threadpool" << std::endl;
+  }
+
+  Vector<Read*> reads;
+  const auto startedAt = uv_hrtime();
+
+  for (uint64_t i = 0; i < depth && scan.remaining > 0; ++i) {
+    auto read = new Read();
+    read->scan = &scan;
+    read->req.data = read;
+    read->buffer = uv_buf_init(read->bytes, READ_SIZE);
+    reads.push_back(read);
+    submit(read);
+  }
+
+  uv_run(loop, UV_RUN_DEFAULT);
+
+  measurement.elapsed = uv_hrtime() - startedAt;
+  measurement.errors = scan.errors;
+
+  for (auto read : reads) {
+    uv_fs_req_cleanup(&read->req);
+    delete read;
+  }
+
+  uv_fs_close(nullptr, &req, scan.fd, nullptr);
+  uv_fs_req_cleanup(&req);
+
+  if (!useURing) {
+    uv_loop_close(loop);
+    delete uring;
+    delete loop;
+  }
+
+  return measurement;
+}
+
+static void report (const Options& options, const Vector<Measurement>& measurements) {
+  auto iops = [](const Measurement& m) {
+    const auto seconds = (double) m.elapsed / 1e9;
+    return seconds > 0 ? m.reads / seconds : 0;
+  };
+
+  auto us = [](const Measurement& m) {
+    return m.reads > 0 ? (double) m.elapsed / m.reads / 1000.0 : 0;
+  };
+
+  if (options.json) {
+    JSON::Array results;
+
+    for (const auto& m : measurements) {
+      results.push(JSON::Object::Entries {
+        {"backend", m.backend},
+        {"depth", m.depth},
+        {"reads", m.reads},
+        {"errors", m.errors},
+        {"iops", iops(m)},
+        {"us", us(m)}
+      });
+    }
+
+    auto json = JSON::Object::Entries {
+      {"size", options.size},
+      {"readSize", READ_SIZE},
+      {"results", results}
+    };
+
+    std::cout << JSON::Object(json).str() << std::endl;
+    return;
+  }
+
+  std::cout
+    << "# uring benchmark (" << options.reads << " random " << READ_SIZE
+    << " byte reads from " << options.size << " bytes)\n"
+    << std::left
+    << std::setw(8) << "depth"
+    << std::setw(12) << "backend"
+    << std::setw(14) << "reads/s"
+    << std::setw(12) << "us/read"
+    << "errors\n";
+
+  for (const auto& m : measurements) {
+    std::cout
+      << std::setw(8) << m.depth
+      << std::setw(12) << m.backend
+      << std::setw(14) << (uint64_t) iops(m)
+      << std::setw(12) << us(m)
+      << m.errors << "\n";
+  }
+
+  std::cout << std::flush;
+}
+
+int main (int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  const auto path = (
+    std::filesystem::temp_directory_path() /
+    ("socket-uring-benchmark-" + std::to_string(rand64()))
+  ).string();
+
+  do {
+    std::ofstream file(path, std::ios::binary);
+    Vector<char> chunk(1024 * 1024);
+
+    for (size_t i = 0; i < chunk.size(); ++i) {
+      chunk[i] = (char) (i * 31 + 7);
+    }
+
+    for (uint64_t written = 0; written < options.size; written += chunk.size()) {
+      file.write(chunk.data(), std::min((uint64_t) chunk.size(), options.size - written));
+    }
+  } while (0);
+
+  Vector<Measurement> measurements;
+  uint64_t errors = 0;
+
+  for (const auto depth : options.depths) {
+    for (const auto useURing : { false, true }) {
+      auto measurement = measure(options, path, depth, useURing);
+      errors += measurement.errors;
+      measurements.push_back(measurement);
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::remove(path, error);
+
+  report(options, measurements);
+  return errors > 0 ? 1 : 0;
+}
@@ -0,0 +1,291 @@
+#include "../core/core.hh"
+#include <filesystem>
+
+//
+// Measures indexing a tree of files, once the way the WebView does it with
+// `fs.opendir`, `fs.readdir` (256 entries at a time, which is
+// `DirectoryHandle.MAX_BUFFER_SIZE`) and `fs.closedir` for every directory,
+// one request at a time, and once with `Core::FS::walk()`, without and with
+// a stat of every entry. The tree has `--files` files in directories of
+// `--per-directory` files, 50 directories to a parent. It is written before
+// it is walked and is likely in the page cache.
+//
+// usage: walk-benchmark [--files <n>] [--per-directory <n>] [--json]
+//
+
+using namespace SSC;
+
+// the benchmark is not an application, so there is no compiled user config
+const Map SSC::getUserConfig () {
+  return Map {};
+}
+
+bool SSC::isDebugEnabled () {
+  return DEBUG == 1;
+}
+
+struct Options {
+  uint64_t files = 200000;
+  uint64_t perDirectory = 100;
+  bool json = false;
+};
+
+struct Measurement {
+  String name;
+  uint64_t entries = 0;
+  uint64_t requests = 0;
+  uint64_t errors = 0;
+  uint64_t elapsed = 0; // nanoseconds
+};
+
+static void printUsage () {
+  std::cerr
+    << "usage: walk-benchmark [--files <n>] [--per-directory <n>] [--json]"
+    << std::endl;
+}
+
+static bool parseOptions (int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    auto arg = String(argv[i]);
+
+    try {
+      if (arg == "--files") {
+        if (i + 1 >= argc) return false;
+        options.files = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--per-directory") {
+        if (i + 1 >= argc) return false;
+        options.perDirectory = std::max((uint64_t) 1, (uint64_t) std::stoull(argv[++i]));
+      } else if (arg == "--json") {
+        options.json = true;
+      } else {
+        return false;
+      }
+    } catch (...) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// drive the core event loop until `predicate()` is true
+template <typename Predicate>
+static void poll (Predicate predicate) {
+  while (!predicate()) {
+  #if defined(__linux__) && !defined(__ANDROID__)
+    // the core event loop is a source on the default GLib main context
+    g_main_context_iteration(nullptr, false);
+  #else
+    std::this_thread::yield();
+  #endif
+  }
+}
+
+// waits for the reply of a request made with `request(callback)`
+template <typename Request>
+static JSON::Any call (Request request) {
+  std::atomic<bool> done = false;
+  JSON::Any result;
+
+  request([&](auto seq, auto json, auto post) {
+    result = json;
+    done = true;
+  });
+
+  poll([&]() { return done.load(); });
+  return result;
+}
+
+static bool isError (const JSON::Any& json) {
+  return json.as<JSON::Object>().has("err");
+}
+
+static Measurement readdirs (Core& core, const String& root) {
+  Measurement measurement;
+  measurement.name = "readdir";
+
+  Vector<String> directories = { root };
+  const auto startedAt = uv_hrtime();
+
+  while (directories.size() > 0) {
+    const auto path = directories.back();
+    const auto id = rand64();
+    directories.pop_back();
+
+    measurement.requests++;
+    auto opened = call([&](auto cb) {
+      core.fs.opendir("", id, path, cb);
+    });
+
+    if (isError(opened)) {
+      measurement.errors++;
+      continue;
+    }
+
+    while (true) {
+      measurement.requests++;
+      auto json = call([&](auto cb) {
+        core.fs.readdir("", id, 256, cb);
+      });
+
+      if (isError(json)) {
+        measurement.errors++;
+        break;
+      }
+
+      const auto entries = json.as<JSON::Object>()["data"].as<JSON::Array>();
+
+      if (entries.size() == 0) {
+        break;
+      }
+
+      for (size_t i = 0; i < entries.size(); ++i) {
+        const auto entry = entries[i].as<JSON::Object>();
+        const auto type = (int) entry["type"].as<JSON::Number>().value();
+
+        if (type == UV_DIRENT_DIR) {
+          directories.push_back(path + "/" + entry["name"].as<JSON::String>().value());
+        }
+      }
+
+      measurement.entries += entries.size();
+    }
+
+    measurement.requests++;
+    call([&](auto cb) {
+      core.fs.closedir("", id, cb);
+    });
+  }
+
+  measurement.elapsed = uv_hrtime() - startedAt;
+  return measurement;
+}
+
+static Measurement walk (Core& core, const String& root, bool stat) {
+  Measurement measurement;
+  measurement.name = stat ? "walk+stat" : "walk";
+
+  Core::FS::WalkOptions options;
+  options.stat = stat;
+
+  std::atomic<bool> done = false;
+  const auto startedAt = uv_hrtime();
+
+  measurement.requests++;
+  core.fs.walk("1", rand64(), root, options, [&](auto seq, auto json, auto post) {
+    if (seq == "-1") {
+      const auto data = json.template as<JSON::Object>()["data"].template as<JSON::Object>();
+      measurement.entries += (uint64_t) data["entries"].template as<JSON::Number>().value();
+      freePostBody(post);
+      return;
+    }
+
+    if (isError(json)) {
+      measurement.errors++;
+    }
+
+    done = true;
+  });
+
+  poll([&]() { return done.load(); });
+
+  measurement.elapsed = uv_hrtime() - startedAt;
+  return measurement;
+}
+
+static void report (const Options& options, const Vector<Measurement>& measurements) {
+  auto ms = [](const Measurement& m) {
+    return (double) m.elapsed / 1e6;
+  };
+
+  if (options.json) {
+    JSON::Array results;
+
+    for (const auto& m : measurements) {
+      results.push(JSON::Object::Entries {
+        {"name", m.name},
+        {"entries", m.entries},
+        {"requests", m.requests},
+        {"errors", m.errors},
+        {"ms", ms(m)}
+      });
+    }
+
+    auto json = JSON::Object::Entries {
+      {"files", options.files},
+      {"perDirectory", options.perDirectory},
+      {"results", results}
+    };
+
+    std::cout << JSON::Object(json).str() << std::endl;
+    return;
+  }
+
+  std::cout
+    << "# walk benchmark (" << options.files << " files, "
+    << options.perDirectory << " per directory)\n"
+    << std::left
+    << std::setw(12) << "walk"
+    << std::setw(10) << "entries"
+    << std::setw(10) << "requests"
+    << std::setw(10) << "ms"
+    << "errors\n";
+
+  for (const auto& m : measurements) {
+    std::cout
+      << std::setw(12) << m.name
+      << std::setw(10) << m.entries
+      << std::setw(10) << m.requests
+      << std::setw(10) << (uint64_t) ms(m)
+      << m.errors << "\n";
+  }
+
+  std::cout << std::flush;
+}
+
+int main (int argc, char** argv) {
+  Options options;
+
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 1;
+  }
+
+  const auto root = (
+    std::filesystem::temp_directory_path() /
+    ("socket-walk-benchmark-" + std::to_string(rand64()))
+  );
+
+  const auto directories = (options.files + options.perDirectory - 1) / options.perDirectory;
+
+  for (uint64_t d = 0, written = 0; d < directories; ++d) {
+    const auto directory = root / std::to_string(d / 50) / std::to_string(d);
+    std::filesystem::create_directories(directory);
+
+    for (uint64_t i = 0; i < options.perDirectory && written < options.files; ++i, ++written) {
+      std::ofstream(directory / std::to_string(i));
+    }
+  }
+
+  Core core;
+  Vector<Measurement> measurements;
+  uint64_t errors = 0;
+
+  measurements.push_back(readdirs(core, root.string()));
+  measurements.push_back(walk(core, root.string(), false));
+  measurements.push_back(walk(core, root.string(), true));
+
+  for (const auto& measurement : measurements) {
+    errors += measurement.errors;
+
+    if (measurement.entries != measurements[0].entries) {
+      errors++;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::remove_all(root, error);
+
+  report(options, measurements);
+  return errors > 0 ? 1 : 0;
+}
@@ -1409,6 +1409,41 @@ output = "build"
 flags = "-g"
 
 
+[diagnostics]
+
+; Collect per route IPC metrics (calls, errors, bytes and latency histograms) from startup.
+; default value: false
+ipc = false
+
+; A file path IPC metrics are periodically written to as JSON.
+ipc_dump = ""
+
+; The interval in milliseconds IPC metrics are written to `ipc_dump`.
+; default value: 1000
+ipc_dump_interval = 1000
+
+; A file path a replayable trace of IPC invocations is recorded to.
+ipc_record = ""
+
+
+[extensions]
+
+; The number of worker threads shared by native extensions for work submitted with `sapi_work_submit()`.
+; default value: the number of CPU cores
+; workers = 4
+
+
+[filesystem]
+
+; The number of paths whose `fs.stat()`, `fs.lstat()` and `fs.access()` results are kept until the path, its directory or, for a directory, its entries change. Results found through a symbolic link are not kept. 0 keeps none.
+; default value: 0
+stat_cache = 0
+
+; Map files of 1 MB or more into memory for `fs.readFile()` instead of reading them into a buffer. Saves a copy, but the application crashes if another process truncates a file while it is being read.
+; default value: false
+map_read_files = false
+
+
 [meta]
 
 ; A unique ID that identifies the bundle (used by all app stores).
@@ -1484,6 +1519,10 @@ cmd = "beepboop"
 ; The icon to use for identifying your app in Linux desktop environments.
 icon = "src/icon.png"
 
+; Use io_uring for file system opens, closes, reads, writes and stats when the kernel supports it.
+; default value: false
+io_uring = false
+
 
 [mac]
 
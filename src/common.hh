@@ -123,15 +123,28 @@ static os_log_t SSC_OS_LOG_DEBUG_BUNDLE = nullptr;
 #include <unistd.h>
 #endif
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include <any>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <exception>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <list>
 #include <map>
 #include <mutex>
 #include <queue>
@@ -140,6 +153,8 @@ static os_log_t SSC_OS_LOG_DEBUG_BUNDLE = nullptr;
 #include <sstream>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #ifndef DEBUG
@@ -546,16 +561,97 @@ namespace SSC {
     return str;
   }
 
-  inline String tmpl (const String s, Map pairs) {
-    String output = s;
+  //
+  // A template parsed once into literal and placeholder segments. A
+  // placeholder is a key between one or more '{' and one or more '}', like
+  // `{{name}}`, and renders as the value of that key. Placeholders without
+  // a value are rendered as they were written.
+  //
+  class Template {
+    public:
+      struct Segment {
+        String text; // the literal, or the placeholder as it was written
+        String key; // empty for literals
+      };
+
+      Vector<Segment> segments;
+      size_t literalSize = 0;
+
+      Template () = default;
+      Template (const String& source) {
+        const auto size = source.size();
+        size_t literal = 0;
+        size_t i = 0;
+
+        auto append = [this, &source](size_t start, size_t end, String key) {
+          if (end > start) {
+            this->segments.push_back({ source.substr(start, end - start), key });
+
+            if (key.size() == 0) {
+              this->literalSize += end - start;
+            }
+          }
+        };
 
-    for (auto item : pairs) {
-      auto key = String("[{]+(" + item.first + ")[}]+");
-      auto value = item.second;
-      output = std::regex_replace(output, std::regex(key), value);
-    }
+        while ((i = source.find('{', i)) != String::npos) {
+          const auto start = i;
 
-    return output;
+          while (i < size && source[i] == '{') {
+            i++;
+          }
+
+          const auto keyStart = i;
+
+          while (i < size && source[i] != '{' && source[i] != '}') {
+            i++;
+          }
+
+          // not a placeholder (yet), a '{' after the key starts over
+          if (i == keyStart || i == size || source[i] == '{') {
+            continue;
+          }
+
+          const auto keyEnd = i;
+
+          while (i < size && source[i] == '}') {
+            i++;
+          }
+
+          append(literal, start, "");
+          append(start, i, source.substr(keyStart, keyEnd - keyStart));
+          literal = i;
+        }
+
+        append(literal, size, "");
+      }
+
+      String render (const Map& pairs) const {
+        Vector<const String*> values(this->segments.size(), nullptr);
+        auto size = this->literalSize;
+
+        for (size_t i = 0; i < this->segments.size(); ++i) {
+          const auto& segment = this->segments[i];
+
+          if (segment.key.size() > 0) {
+            const auto it = pairs.find(segment.key);
+            values[i] = it != pairs.end() ? &it->second : &segment.text;
+            size += values[i]->size();
+          }
+        }
+
+        String output;
+        output.reserve(size);
+
+        for (size_t i = 0; i < this->segments.size(); ++i) {
+          output += values[i] != nullptr ? *values[i] : this->segments[i].text;
+        }
+
+        return output;
+      }
+  };
+
+  inline String tmpl (const String s, Map pairs) {
+    return Template(s).render(pairs);
   }
 
   inline uint64_t rand64 (void) {
@@ -889,43 +985,155 @@ namespace SSC {
     return output;
   }
 
-  inline String decodeURIComponent (const String& sSrc) {
+#if defined(__AVX2__)
+  #define SSC_URI_COMPONENT_SIMD 1
+  static constexpr size_t URI_COMPONENT_CHUNK_SIZE = 32;
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(__ARM_NEON) && defined(__aarch64__))
+  #define SSC_URI_COMPONENT_SIMD 1
+  static constexpr size_t URI_COMPONENT_CHUNK_SIZE = 16;
+#endif
+
+#if defined(SSC_URI_COMPONENT_SIMD)
+  // Returns true if any of the `URI_COMPONENT_CHUNK_SIZE` bytes at `p` is
+  // a '%' or a '+', that is, if `decodeURIComponent()` can't copy the
+  // chunk as is.
+  inline bool hasURIComponentEscapes (const unsigned char* p) {
+  #if defined(__AVX2__)
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const auto mask = _mm256_or_si256(
+      _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('%')),
+      _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('+'))
+    );
+
+    return _mm256_movemask_epi8(mask) != 0;
+  #elif defined(__SSE2__) || defined(_M_X64)
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const auto mask = _mm_or_si128(
+      _mm_cmpeq_epi8(chunk, _mm_set1_epi8('%')),
+      _mm_cmpeq_epi8(chunk, _mm_set1_epi8('+'))
+    );
+
+    return _mm_movemask_epi8(mask) != 0;
+  #else
+    const auto chunk = vld1q_u8(p);
+    const auto mask = vorrq_u8(
+      vceqq_u8(chunk, vdupq_n_u8('%')),
+      vceqq_u8(chunk, vdupq_n_u8('+'))
+    );
+
+    return vmaxvq_u8(mask) != 0;
+  #endif
+  }
+
+  // Returns a mask of the `URI_COMPONENT_CHUNK_SIZE` bytes at `p` with a
+  // bit set for each byte that `encodeURIComponent()` escapes, which is
+  // anything that is not in `SAFE` ([0-9A-Za-z]). Unsigned
+  // `c - lo <= hi - lo` tests a range.
+  inline uint32_t getURIComponentEscapeMask (const unsigned char* p) {
+  #if defined(__AVX2__)
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const auto digit = _mm256_sub_epi8(chunk, _mm256_set1_epi8('0'));
+    const auto alpha = _mm256_sub_epi8(
+      _mm256_or_si256(chunk, _mm256_set1_epi8(0x20)),
+      _mm256_set1_epi8('a')
+    );
+
+    const auto safe = _mm256_or_si256(
+      _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit),
+      _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(25)), alpha)
+    );
+
+    return ~(uint32_t) _mm256_movemask_epi8(safe);
+  #elif defined(__SSE2__) || defined(_M_X64)
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const auto digit = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+    const auto alpha = _mm_sub_epi8(
+      _mm_or_si128(chunk, _mm_set1_epi8(0x20)),
+      _mm_set1_epi8('a')
+    );
+
+    const auto safe = _mm_or_si128(
+      _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit),
+      _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(25)), alpha)
+    );
+
+    return ~(uint32_t) _mm_movemask_epi8(safe) & 0xffff;
+  #else
+    static const uint8_t weights[16] = {
+      1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+    };
+
+    const auto chunk = vld1q_u8(p);
+    const auto digit = vsubq_u8(chunk, vdupq_n_u8('0'));
+    const auto alpha = vsubq_u8(vorrq_u8(chunk, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    const auto safe = vorrq_u8(
+      vcleq_u8(digit, vdupq_n_u8(9)),
+      vcleq_u8(alpha, vdupq_n_u8(25))
+    );
 
+    // there is no `movemask`, so each lane keeps its own bit and the
+    // halves are summed into a byte each
+    const auto bits = vandq_u8(vmvnq_u8(safe), vld1q_u8(weights));
+    return vaddv_u8(vget_low_u8(bits)) | (uint32_t) vaddv_u8(vget_high_u8(bits)) << 8;
+  #endif
+  }
+#endif
+
+  inline String decodeURIComponent (const String& input) {
     // Note from RFC1630:  "Sequences which start with a percent sign
     // but are not followed by two hexadecimal characters (0-9, A-F) are reserved
     // for future extension"
+    //
+    // '+' decodes to ' ', an invalid or truncated sequence is copied as is.
+    // The output is never larger than the input, so it is allocated once
+    // and chunks without a '%' or '+' are copied whole.
+    const auto begin = reinterpret_cast<const unsigned char*>(input.data());
+    const auto end = begin + input.size();
+
+    String output(input.size(), '\0');
+    auto out = output.data();
+    auto p = begin;
+
+    while (p < end) {
+    #if defined(SSC_URI_COMPONENT_SIMD)
+      if ((size_t) (end - p) >= URI_COMPONENT_CHUNK_SIZE) {
+        if (!hasURIComponentEscapes(p)) {
+          std::memcpy(out, p, URI_COMPONENT_CHUNK_SIZE);
+          out += URI_COMPONENT_CHUNK_SIZE;
+          p += URI_COMPONENT_CHUNK_SIZE;
+          continue;
+        }
+      }
 
-    auto s = replace(sSrc, "\\+", " ");
-    const unsigned char* pSrc = (const unsigned char *) s.c_str();
-    const int SRC_LEN = (int) sSrc.length();
-    const unsigned char* const SRC_END = pSrc + SRC_LEN;
-    const unsigned char* const SRC_LAST_DEC = SRC_END - 2;
+      const auto stop = std::min(p + URI_COMPONENT_CHUNK_SIZE, end);
+    #else
+      const auto stop = end;
+    #endif
 
-    char* const pStart = new char[SRC_LEN];
-    char* pEnd = pStart;
+      while (p < stop) {
+        if (*p == '+') {
+          *out++ = ' ';
+          p++;
+          continue;
+        }
 
-    while (pSrc < SRC_LAST_DEC) {
-      if (*pSrc == '%') {
-        char dec1, dec2;
-        if (-1 != (dec1 = HEX2DEC[*(pSrc + 1)])
-            && -1 != (dec2 = HEX2DEC[*(pSrc + 2)])) {
+        if (*p == '%' && end - p > 2) {
+          const auto hi = HEX2DEC[p[1]];
+          const auto lo = HEX2DEC[p[2]];
 
-            *pEnd++ = (dec1 << 4) + dec2;
-            pSrc += 3;
+          if (hi != -1 && lo != -1) {
+            *out++ = (char) ((hi << 4) + lo);
+            p += 3;
             continue;
+          }
         }
-      }
-      *pEnd++ = *pSrc++;
-    }
 
-    // the last 2- chars
-    while (pSrc < SRC_END) {
-      *pEnd++ = *pSrc++;
+        *out++ = (char) *p++;
+      }
     }
 
-    String sResult(pStart, pEnd);
-    delete [] pStart;
-    return sResult;
+    output.resize(out - output.data());
+    return output;
   }
 
   static const char SAFE[256] = {
@@ -951,28 +1159,133 @@ namespace SSC {
       /* F */ 0,0,0,0, 0,0,0,0, 0,0,0,0, 0,0,0,0
   };
 
-  inline String encodeURIComponent (const String& sSrc) {
-    const char DEC2HEX[16 + 1] = "0123456789ABCDEF";
-    const unsigned char* pSrc = (const unsigned char*) sSrc.c_str();
-    const int SRC_LEN = (int) sSrc.length();
-    unsigned char* const pStart = new unsigned char[SRC_LEN* 3];
-    unsigned char* pEnd = pStart;
-    const unsigned char* const SRC_END = pSrc + SRC_LEN;
-
-    for (; pSrc < SRC_END; ++pSrc) {
-      if (SAFE[*pSrc]) {
-        *pEnd++ = *pSrc;
+  // the "%XX" escape of each byte, padded to 4 bytes so that an escape is
+  // written with a single copy
+  static const auto URI_COMPONENT_ESCAPES = []() {
+    static constexpr char DEC2HEX[16 + 1] = "0123456789ABCDEF";
+    std::array<std::array<char, 4>, 256> table = {};
+
+    for (int c = 0; c < 256; ++c) {
+      table[c] = { '%', DEC2HEX[c >> 4], DEC2HEX[c & 0x0F], 0 };
+    }
+
+    return table;
+  }();
+
+  inline String encodeURIComponent (const String& input) {
+    const auto begin = reinterpret_cast<const unsigned char*>(input.data());
+    const auto end = begin + input.size();
+
+    // escapes are counted first so the output is allocated once at its
+    // exact size
+    auto size = input.size();
+    auto p = begin;
+
+  #if defined(SSC_URI_COMPONENT_SIMD)
+    for (; (size_t) (end - p) >= URI_COMPONENT_CHUNK_SIZE; p += URI_COMPONENT_CHUNK_SIZE) {
+      size += 2 * std::popcount(getURIComponentEscapeMask(p));
+    }
+  #endif
+
+    for (; p < end; ++p) {
+      size += SAFE[*p] ? 0 : 2;
+    }
+
+    if (size == input.size()) {
+      return input;
+    }
+
+    // one byte of room for the padding of an escape written last
+    String output(size + 1, '\0');
+    auto out = output.data();
+    auto escape = [&out](unsigned char c) {
+      std::memcpy(out, URI_COMPONENT_ESCAPES[c].data(), 4);
+      out += 3;
+    };
+
+    p = begin;
+
+  #if defined(SSC_URI_COMPONENT_SIMD)
+    // SIMD only finds chunks without escapes, which are copied whole. The
+    // bytes of any other chunk are written one at a time as the mask says.
+    for (; (size_t) (end - p) >= URI_COMPONENT_CHUNK_SIZE; p += URI_COMPONENT_CHUNK_SIZE) {
+      auto mask = getURIComponentEscapeMask(p);
+
+      if (mask == 0) {
+        std::memcpy(out, p, URI_COMPONENT_CHUNK_SIZE);
+        out += URI_COMPONENT_CHUNK_SIZE;
+        continue;
+      }
+
+      for (size_t i = 0; i < URI_COMPONENT_CHUNK_SIZE; ++i, mask >>= 1) {
+        if (mask & 1) {
+          escape(p[i]);
+        } else {
+          *out++ = (char) p[i];
+        }
+      }
+    }
+  #endif
+
+    for (; p < end; ++p) {
+      if (SAFE[*p]) {
+        *out++ = (char) *p;
+      } else {
+        escape(*p);
+      }
+    }
+
+    output.resize(size);
+    return output;
+  }
+
+  //
+  // Escapes `input` for the body of a JavaScript template literal so that
+  // the literal evaluates to `input` exactly. This lets replies that are
+  // already JSON be embedded in scripts as is instead of percent-encoding
+  // them and decoding them again in the WebView.
+  //
+  inline String encodeTemplateLiteral (const String& input) {
+    static constexpr char DEC2HEX[16 + 1] = "0123456789ABCDEF";
+    const auto begin = reinterpret_cast<const unsigned char*>(input.data());
+    const auto end = begin + input.size();
+
+    // '\\', '`' and '$' (which may start a substitution) are escaped, '\r'
+    // would otherwise be normalized to '\n' and '\0' may end the script
+    // early where it is passed as a C string
+    auto isSpecial = [](unsigned char c) {
+      return c == '\\' || c == '`' || c == '$' || c == '\r' || c == '\0';
+    };
+
+    String output;
+    output.reserve(input.size() + input.size() / 16 + 16);
+
+    for (auto p = begin; p < end;) {
+      auto run = p;
+
+      while (run < end && !isSpecial(*run)) {
+        run++;
+      }
+
+      output.append(reinterpret_cast<const char*>(p), run - p);
+
+      if (run == end) {
+        break;
+      }
+
+      if (*run == '\r' || *run == '\0') {
+        output += "\\x";
+        output += DEC2HEX[*run >> 4];
+        output += DEC2HEX[*run & 0x0F];
       } else {
-        // escape this char
-        *pEnd++ = '%';
-        *pEnd++ = DEC2HEX[*pSrc >> 4];
-        *pEnd++ = DEC2HEX[*pSrc & 0x0F];
+        output += '\\';
+        output += (char) *run;
       }
+
+      p = run + 1;
     }
 
-    String sResult((char*) pStart, (char*) pEnd);
-    delete [] pStart;
-    return sResult;
+    return output;
   }
 
   inline auto toBytes (uint64_t n) {
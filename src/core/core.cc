@@ -102,11 +102,7 @@ namespace SSC {
     Lock lock(postsMutex);
     if (posts->find(id) == posts->end()) return;
     auto post = getPost(id);
-
-    if (post.body) {
-      delete [] post.body;
-    }
-
+    freePostBody(post);
     posts->erase(id);
   }
 
@@ -161,6 +157,43 @@ namespace SSC {
     }
   }
 
+  struct CPUTimesJSON {
+    uint64_t user;
+    uint64_t nice;
+    uint64_t sys;
+    uint64_t idle;
+    uint64_t irq;
+
+    using Shape = JSON::Shape<
+      JSON::Field<"user", &CPUTimesJSON::user>,
+      JSON::Field<"nice", &CPUTimesJSON::nice>,
+      JSON::Field<"sys", &CPUTimesJSON::sys>,
+      JSON::Field<"idle", &CPUTimesJSON::idle>,
+      JSON::Field<"irq", &CPUTimesJSON::irq>
+    >;
+  };
+
+  struct CPUJSON {
+    String model;
+    int speed;
+    CPUTimesJSON times;
+
+    using Shape = JSON::Shape<
+      JSON::Field<"model", &CPUJSON::model>,
+      JSON::Field<"speed", &CPUJSON::speed>,
+      JSON::Field<"times", &CPUJSON::times>
+    >;
+  };
+
+  struct CPUsJSON {
+    Vector<CPUJSON> data;
+
+    using Shape = JSON::Shape<
+      JSON::Constant<"source", "os.cpus">,
+      JSON::Field<"data", &CPUsJSON::data>
+    >;
+  };
+
   void Core::OS::cpus (
     const String seq,
     Module::Callback cb
@@ -194,27 +227,24 @@ namespace SSC {
         return;
       }
 
-      JSON::Array::Entries entries(count);
+      CPUsJSON json;
+      json.data.reserve(count);
+
       for (int i = 0; i < count; ++i) {
-        auto info = infos[i];
-        entries[i] = JSON::Object::Entries {
-          {"model", info.model},
-          {"speed", info.speed},
-          {"times", JSON::Object::Entries {
-            {"user", info.cpu_times.user},
-            {"nice", info.cpu_times.nice},
-            {"sys", info.cpu_times.sys},
-            {"idle", info.cpu_times.idle},
-            {"irq", info.cpu_times.irq}
-          }}
-        };
+        const auto& info = infos[i];
+        json.data.push_back(CPUJSON {
+          info.model,
+          info.speed,
+          {
+            info.cpu_times.user,
+            info.cpu_times.nice,
+            info.cpu_times.sys,
+            info.cpu_times.idle,
+            info.cpu_times.irq
+          }
+        });
       }
 
-      auto json = JSON::Object::Entries {
-        {"source", "os.cpus"},
-        {"data", entries}
-      };
-
       uv_free_cpu_info(infos, count);
       cb(seq, json, Post{});
     });
@@ -488,14 +518,12 @@ namespace SSC {
       if (event == "domcontentloaded") {
         Lock lock(this->core->fs.mutex);
 
-        for (auto const &tuple : this->core->fs.descriptors) {
-          auto desc = tuple.second;
-          if (desc != nullptr) {
-            desc->stale = true;
-          } else {
-            this->core->fs.descriptors.erase(tuple.first);
-          }
+        for (auto const desc : this->core->fs.descriptors.slots) {
+          this->core->fs.descriptors.markStale(desc);
         }
+
+        // the page that started them is gone
+        this->core->fs.closeWatchers();
       }
 
       auto json = JSON::Object::Entries {
@@ -983,26 +1011,12 @@ namespace SSC {
     .timeout = 256, // in milliseconds
     .invoke = [](uv_timer_t *handle) {
       auto core = reinterpret_cast<Core *>(handle->data);
-      Vector<uint64_t> ids;
-      String msg = "";
 
+      // only descriptors in the stale list are visited, they are taken
+      // out of it as they are closed
       Lock lock(core->fs.mutex);
-      for (auto const &tuple : core->fs.descriptors) {
-        ids.push_back(tuple.first);
-      }
-
-      for (auto const id : ids) {
-        Lock lock(core->fs.mutex);
-        auto desc = core->fs.descriptors.at(id);
-
-        if (desc == nullptr) {
-          core->fs.descriptors.erase(id);
-          continue;
-        }
-
-        if (desc->isRetained() || !desc->isStale()) {
-          continue;
-        }
+      for (auto const desc : core->fs.descriptors.releaseStale()) {
+        const auto id = desc->id;
 
         if (desc->isDirectory()) {
           core->fs.closedir("", id, [](auto seq, auto msg, auto post) {});
@@ -1010,7 +1024,7 @@ namespace SSC {
           core->fs.close("", id, [](auto seq, auto msg, auto post) {});
         } else {
           // free
-          core->fs.descriptors.erase(id);
+          core->fs.descriptors.remove(id);
           delete desc;
         }
       }
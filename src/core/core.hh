@@ -156,8 +156,24 @@ namespace SSC {
     char* body = nullptr;
     size_t length = 0;
     String headers = "";
+    // frees a `body` that was handed over by its owner instead of being
+    // allocated with `new char[]`, see `freePostBody()`
+    void (*deallocate)(char* body, void* data) = nullptr;
+    void* deallocateData = nullptr;
   };
 
+  inline void freePostBody (const Post& post) {
+    if (post.body == nullptr) {
+      return;
+    }
+
+    if (post.deallocate != nullptr) {
+      post.deallocate(post.body, post.deallocateData);
+    } else {
+      delete [] post.body;
+    }
+  }
+
   using Posts = std::map<uint64_t, Post>;
   using EventLoopDispatchCallback = std::function<void()>;
 
@@ -428,6 +444,104 @@ namespace SSC {
         public:
           FS (auto core) : Module(core) {}
 
+          struct Descriptor;
+
+          // Chunks read ahead of a descriptor that is read sequentially, so
+          // the next `read()` is replied to from memory, once enabled with
+          // `setReadAhead()`. Only used on the event loop thread, see
+          // `Core::FS::read()`.
+          struct ReadAhead {
+            struct Chunk {
+              Descriptor *desc = nullptr;
+              uint64_t id = 0;
+              size_t offset = 0;
+              size_t size = 0;
+              uv_fs_t req {};
+              uv_buf_t buffer;
+              Post post;
+              bool pending = true;
+              // the descriptor no longer wants the chunk, it is freed (or
+              // given to `cb`) when its read completes
+              bool abandoned = false;
+              // a read that asked for the chunk while it was in flight
+              String seq;
+              size_t length = 0;
+              Module::Callback cb = nullptr;
+
+              Chunk () {
+                this->req.data = (void *) this;
+              }
+
+              ~Chunk () {
+                uv_fs_req_cleanup(&this->req);
+              }
+            };
+
+            // chunks kept in flight or ready, 0 when not reading ahead
+            size_t depth = 0;
+            // chunks in file order, in flight or ready
+            Vector<Chunk*> chunks;
+            // the file when the chunks were read ahead, a ready chunk is
+            // only replied with while its size and modification time match
+            uv_stat_t stat {};
+            // where the next sequential read starts and how large it is
+            size_t next = 0;
+            size_t size = 0;
+            // reads in a row that started where the previous one ended
+            unsigned int sequential = 0;
+            bool advised = false;
+
+            ~ReadAhead ();
+            // frees ready chunks and abandons chunks in flight
+            uint64_t discard ();
+          };
+
+          // Writes to a descriptor that are held and then given to the file
+          // together with one vectored write, see `setWriteBehind()`. Only
+          // used on the event loop thread.
+          struct WriteBehind {
+            struct Write {
+              String source;
+              String seq;
+              Module::Callback cb;
+              size_t size = 0;
+            };
+
+            struct Batch {
+              Descriptor *desc = nullptr;
+              uint64_t id = 0;
+              uv_fs_t req {};
+              int64_t offset = -1;
+              size_t size = 0;
+              bool flushing = false;
+              // something waits for the batch, later writes go in the next
+              bool sealed = false;
+              Vector<Write> writes;
+              // the request bodies of `writes`, they are not copied
+              Vector<uv_buf_t> buffers;
+              // called once the batch is written and its writes replied to
+              Vector<std::function<void()>> after;
+
+              Batch () {
+                this->req.data = (void *) this;
+              }
+
+              ~Batch () {
+                uv_fs_req_cleanup(&this->req);
+              }
+            };
+
+            // bytes held before they are written, 0 when writes are not held
+            size_t size = 0;
+            // milliseconds a write is held at most
+            uint64_t delay = 0;
+            // batches in file order, the first one may be in flight
+            Vector<Batch*> batches;
+            uv_timer_t *timer = nullptr;
+
+            ~WriteBehind ();
+          };
+
           struct Descriptor {
             uint64_t id;
             std::atomic<bool> retained = false;
@@ -436,6 +550,16 @@ namespace SSC {
             uv_dir_t *dir = nullptr;
             uv_file fd = 0;
             Core *core;
+            ReadAhead readAhead;
+            WriteBehind writeBehind;
+            // the path a file was opened with, its stats are dropped from
+            // `FS::stats` when it is written
+            String path;
+            // position in `FS::descriptors` and its links in the stale list
+            size_t slot = 0;
+            Descriptor *staleNext = nullptr;
+            Descriptor *stalePrev = nullptr;
+            bool isStaleLinked = false;
 
             Descriptor (Core *core, uint64_t id);
             bool isDirectory ();
@@ -444,40 +568,498 @@ namespace SSC {
             bool isStale ();
           };
 
+          // Open descriptors by id. Descriptors are kept in a dense table
+          // of slots found through an index of ids, removing one moves the
+          // last slot into its place. Descriptors marked stale that are not
+          // retained are also linked into a list, so releasing them only
+          // visits those. Guarded by `FS::mutex`.
+          struct DescriptorTable {
+            Vector<Descriptor*> slots;
+            std::unordered_map<uint64_t, size_t> index;
+            Descriptor *stale = nullptr;
+            size_t staleCount = 0;
+            uint64_t released = 0;
+
+            Descriptor * get (uint64_t id);
+            void insert (Descriptor *desc);
+            void remove (uint64_t id);
+            size_t size ();
+            void markStale (Descriptor *desc);
+            void unlinkStale (Descriptor *desc);
+            Vector<Descriptor*> releaseStale ();
+            JSON::Object json ();
+          };
+
+          // Size classed buffers for `fs.read()` results. Buffers are not
+          // zero filled. A buffer is acquired on the event loop and given
+          // back by `freePostBody()` when its post has been consumed, which
+          // can be on any thread.
+          struct BufferPool {
+            struct SizeClass {
+              BufferPool *pool = nullptr;
+              size_t size = 0;
+              size_t capacity = 0;
+              Vector<char*> buffers;
+              uint64_t allocations = 0;
+              uint64_t reuses = 0;
+              uint64_t used = 0;
+            };
+
+            // 4 KB to 1 MB in powers of two, larger reads are not pooled
+            static constexpr size_t MIN_BUFFER_SIZE = 4 * 1024;
+            static constexpr size_t MAX_BUFFER_SIZE = 1024 * 1024;
+            static constexpr size_t SIZE_CLASSES = 9;
+            // bytes of free buffers kept per size class
+            static constexpr size_t MAX_FREE_BYTES = 1024 * 1024;
+
+            SizeClass classes[SIZE_CLASSES];
+            uint64_t unpooled = 0;
+            Mutex mutex;
+
+            BufferPool ();
+            ~BufferPool ();
+            Post acquire (size_t size);
+            static void release (char *body, void *data);
+            JSON::Object json ();
+          };
+
+          // An io_uring backend for `open()`, `close()`, `read()`, `write()`
+          // and `stat()` on Linux, enabled with `[linux] io_uring`. Requests
+          // queued during a loop iteration are submitted together when the
+          // loop is about to poll and again after it has polled, and their
+          // completions are reaped when the ring's eventfd is readable. Each
+          // method completes `req` like its `uv_fs_*()` counterpart and falls
+          // back to it when the ring is unavailable or full.
+          class URing {
+            public:
+              struct Operation;
+              struct Ring;
+
+              Ring *ring = nullptr;
+              bool initialized = false;
+              uint64_t submitted = 0;
+              uint64_t completed = 0;
+              uint64_t fallbacks = 0;
+
+              URing () = default;
+              URing (const URing&) = delete;
+              ~URing ();
+
+              bool init (uv_loop_t *loop);
+              bool isAvailable ();
+              JSON::Object json ();
+
+              int open (
+                uv_loop_t *loop,
+                uv_fs_t *req,
+                const char *path,
+                int flags,
+                int mode,
+                uv_fs_cb cb
+              );
+
+              int close (uv_loop_t *loop, uv_fs_t *req, uv_file fd, uv_fs_cb cb);
+
+              int read (
+                uv_loop_t *loop,
+                uv_fs_t *req,
+                uv_file fd,
+                const uv_buf_t bufs[],
+                unsigned int nbufs,
+                int64_t offset,
+                uv_fs_cb cb
+              );
+
+              int write (
+                uv_loop_t *loop,
+                uv_fs_t *req,
+                uv_file fd,
+                const uv_buf_t bufs[],
+                unsigned int nbufs,
+                int64_t offset,
+                uv_fs_cb cb
+              );
+
+              int stat (uv_loop_t *loop, uv_fs_t *req, const char *path, uv_fs_cb cb);
+          };
+
+          // The results of `stat()`, `lstat()` and `access()` by path,
+          // enabled with `[filesystem] stat_cache` (the number of paths
+          // kept). A path is kept while a `uv_fs_event_t` watches its
+          // directory, and a directory while one watches it as well, and
+          // is dropped when a watch sees a change, when the runtime changes
+          // the path itself, or least recently used first when the cache
+          // is full. The target of a symbolic link is not watched, so what
+          // `stat()` and `access()` find through a link is not kept. Only
+          // used on the event loop thread.
+          class StatCache {
+            public:
+              struct Watch;
+
+              struct Result {
+                bool known = false;
+                int err = 0;
+                uv_stat_t stat {};
+              };
+
+              struct Entry {
+                String path;
+                // the watch of the directory of `path`
+                Watch *watch = nullptr;
+                // the watch of `path` itself when it is a directory
+                Watch *self = nullptr;
+                Result stat;
+                Result lstat;
+                // `access()` results by mode
+                std::map<int, int> access;
+              };
+
+              using Entries = std::list<Entry>;
+
+              struct Watch {
+                StatCache *cache = nullptr;
+                String path;
+                uv_fs_event_t handle;
+                std::unordered_set<String> paths;
+              };
+
+              size_t capacity = 0;
+              bool initialized = false;
+              // changed whenever a path is dropped, a result is only kept
+              // if nothing was dropped while it was being found
+              uint64_t generation = 0;
+              uint64_t hits = 0;
+              uint64_t misses = 0;
+              uint64_t invalidations = 0;
+              uint64_t evictions = 0;
+
+              // most recently used first
+              Entries entries;
+              std::unordered_map<String, Entries::iterator> index;
+              std::unordered_map<String, Watch*> watches;
+
+              StatCache () = default;
+              StatCache (const StatCache&) = delete;
+              ~StatCache ();
+
+              bool isEnabled ();
+              Entry * get (const String& path);
+              void set (
+                uv_loop_t *loop,
+                const String& path,
+                uint64_t generation,
+                const std::function<void(Entry&)>& update
+              );
+              void invalidate (const String& path);
+              void invalidate (Watch *watch);
+              void remove (Entries::iterator entry);
+              Watch * watch (uv_loop_t *loop, const String& directory);
+              void unwatch (Watch *watch);
+              JSON::Object json ();
+          };
+
+          // A watch of a path started with `watch()`. Changes are kept by
+          // path (relative to `path`) until `window` milliseconds pass
+          // without another one, or `window * WATCH_MAX_WINDOWS` since the
+          // first, and are then given to `callback` in one batch. On Linux
+          // inotify does not watch subdirectories, so a recursive watch
+          // has a `uv_fs_event_t` for every directory under `path`, found
+          // on the threadpool. Only used on the event loop thread.
+          class Watcher {
+            public:
+              struct Handle {
+                Watcher *watcher = nullptr;
+                // the watched directory relative to `Watcher::path`
+                String path;
+                uv_fs_event_t handle;
+              };
+
+              // the directories under `paths` (and their entries when
+              // `report` is true) found by `scan()`
+              struct Scan {
+                uv_work_t req;
+                Watcher *watcher = nullptr;
+                String root;
+                Vector<String> paths;
+                Vector<String> directories;
+                Vector<String> entries;
+                Vector<String> removed;
+                bool report = false;
+                std::function<void()> callback = nullptr;
+              };
+
+              FS *fs = nullptr;
+              uv_loop_t *loop = nullptr;
+              uint64_t id = 0;
+              String path;
+              bool recursive = false;
+              uint64_t window = 0;
+              Module::Callback callback = nullptr;
+
+              uv_timer_t timer;
+              std::map<String, Handle*> handles;
+              // changed paths and their `uv_fs_event` flags since the last
+              // batch, and the paths renamed since the last scan
+              std::map<String, int> changes;
+              std::unordered_set<String> renamed;
+              uint64_t firstChangeAt = 0;
+              uint64_t events = 0;
+              uint64_t batches = 0;
+
+              // handles, timers and scans not done yet, the watcher is
+              // deleted when it is closed and the last of them is done
+              size_t pending = 0;
+              bool closed = false;
+
+              Watcher (
+                FS *fs,
+                uv_loop_t *loop,
+                uint64_t id,
+                const String& path,
+                bool recursive,
+                uint64_t window,
+                Module::Callback callback
+              );
+
+              Watcher (const Watcher&) = delete;
+
+              int start (const std::function<void()> onStarted);
+              int add (const String& directory);
+              void remove (const String& directory);
+              void scan (
+                const Vector<String>& paths,
+                bool report,
+                const std::function<void()> onScanned
+              );
+              void change (const String& path, int events);
+              void flush ();
+              void close ();
+              void release ();
+              JSON::Object json ();
+          };
+
+          // what `walk()` gives and how deep it goes
+          struct WalkOptions {
+            // levels of directories below the walked path that are read,
+            // 0 for only its own entries and -1 for all of them
+            int64_t depth = -1;
+            // globs of the paths given (all of them when empty) and of the
+            // paths that are neither given nor read
+            Vector<String> include;
+            Vector<String> ignore;
+            // whether every entry is given with its `lstat()`
+            bool stat = false;
+          };
+
+          // A traversal started with `walk()`. Every directory is read on
+          // the threadpool by a `uv_work_t` of its own, which also writes
+          // the JSON of its entries, so the loop thread only joins them.
+          // The entries are given to `cb` in posts of at least
+          // `WALK_BATCH_ENTRIES` entries. Only used on the event loop
+          // thread.
+          struct Walk {
+            struct Directory {
+              uv_work_t req;
+              Walk *walk = nullptr;
+              // relative to `Walk::path`
+              String path;
+              int64_t depth = 0;
+              int err = 0;
+              // comma separated JSON of the entries given
+              String output;
+              size_t entries = 0;
+              Vector<String> directories;
+            };
+
+            FS *fs = nullptr;
+            uv_loop_t *loop = nullptr;
+            uint64_t id = 0;
+            String seq;
+            String path;
+            WalkOptions options;
+            Module::Callback cb = nullptr;
+
+            // directories found and not read yet, and those being read
+            std::deque<Directory*> queue;
+            size_t reading = 0;
+
+            // the body of the next post
+            String output;
+            size_t outputEntries = 0;
+
+            uint64_t entries = 0;
+            uint64_t directories = 0;
+            uint64_t batches = 0;
+            uint64_t errors = 0;
+            // the error reading the walked path itself
+            int err = 0;
+            uint64_t startedAt = 0;
+          };
+
+          struct RequestContext;
+
+          // A free list of one request context shape. Contexts are only
+          // acquired and released on the event loop thread, so each `Core`
+          // (and its loop) has its own lists and they need no lock.
+          struct RequestContextPool {
+            // contexts kept for reuse, a burst beyond this is freed
+            const size_t capacity;
+
+            Vector<RequestContext*> contexts;
+            uint64_t allocations = 0;
+            uint64_t reuses = 0;
+
+            RequestContextPool (size_t capacity) : capacity(capacity) {}
+            virtual ~RequestContextPool ();
+            virtual RequestContext* allocate () = 0;
+            RequestContext* acquire (Descriptor *desc, String seq, Callback cb);
+            void release (RequestContext *ctx);
+          };
+
+          template <class T> struct RequestContextAllocator : RequestContextPool {
+            using RequestContextPool::RequestContextPool;
+
+            RequestContext* allocate () override {
+              return new T();
+            }
+
+            T* acquire (Descriptor *desc, String seq, Callback cb) {
+              return static_cast<T*>(RequestContextPool::acquire(desc, seq, cb));
+            }
+          };
+
+          // the context of an operation on a path or a descriptor
           struct RequestContext : Module::RequestContext {
-            uint64_t id;
             Descriptor *desc = nullptr;
-            uv_fs_t req;
-            uv_buf_t iov[16];
-            // 256 which corresponds to DirectoryHandle.MAX_BUFFER_SIZE
-            uv_dirent_t dirents[256];
-            int offset = 0;
-            int result = 0;
+            RequestContextPool *pool = nullptr;
+            uv_fs_t req {};
 
-            RequestContext () = default;
-            RequestContext (Descriptor *desc)
-              : RequestContext(desc, "", nullptr) {}
-            RequestContext (String seq, Callback cb)
-              : RequestContext(nullptr, seq, cb) {}
-            RequestContext (Descriptor *desc, String seq, Callback cb) {
-              this->id = SSC::rand64();
-              this->cb = cb;
-              this->seq = seq;
-              this->desc = desc;
+            RequestContext () {
               this->req.data = (void *) this;
             }
 
-            ~RequestContext () {
+            virtual ~RequestContext () {
               uv_fs_req_cleanup(&this->req);
             }
 
-            void setBuffer (int index, size_t len, char *base);
-            void freeBuffer (int index);
-            char* getBuffer (int index);
-            size_t getBufferSize (int index);
+            // returns the context to the pool it was acquired from
+            void release ();
+          };
+
+          // the context of a read or a write of a single buffer
+          struct BufferRequestContext : RequestContext {
+            uv_buf_t buffer = uv_buf_init(nullptr, 0);
+            // the post a read result is given in, see `BufferPool`
+            Post post;
+
+            void setBuffer (size_t len, char *base);
+            void freeBuffer ();
+            char* getBuffer ();
+            size_t getBufferSize ();
+          };
+
+          // the context of a read or a write of several buffers, each one a
+          // segment of `post.body` (a read) or of the request body (a write)
+          struct VectoredRequestContext : BufferRequestContext {
+            Vector<uv_buf_t> buffers;
           };
 
-          std::map<uint64_t, Descriptor*> descriptors;
+          // the context of `fs.readFile()`, which opens, reads and closes
+          // a file with one request
+          struct ReadFileRequestContext : BufferRequestContext {
+            uv_file fd = -1;
+            // the size of a regular file, 0 when it is read until EOF
+            size_t size = 0;
+            // the bytes read into `post.body` so far
+            size_t offset = 0;
+          };
+
+          // the context of a `stat()`, `lstat()` or `access()` whose result
+          // may be kept in `stats`, or of a request that changes `path` (and
+          // `target`) and drops what is kept of them
+          struct StatRequestContext : RequestContext {
+            StatCache *cache = nullptr;
+            uv_loop_t *loop = nullptr;
+            String path;
+            String target;
+            int mode = 0;
+            uint64_t generation = 0;
+          };
+
+          // the context of a `uv_fs_readdir()` request
+          struct DirectoryRequestContext : RequestContext {
+            // 256 which corresponds to DirectoryHandle.MAX_BUFFER_SIZE
+            uv_dirent_t dirents[256];
+          };
+
+          // a directory context is about nine times the size of the others
+          // and a directory handle is read one batch at a time, so fewer of
+          // them are kept
+          RequestContextAllocator<RequestContext> requestContexts { 1024 };
+          RequestContextAllocator<BufferRequestContext> bufferRequestContexts { 1024 };
+          RequestContextAllocator<DirectoryRequestContext> directoryRequestContexts { 32 };
+          RequestContextAllocator<ReadFileRequestContext> readFileRequestContexts { 64 };
+          RequestContextAllocator<VectoredRequestContext> vectoredRequestContexts { 64 };
+          RequestContextAllocator<StatRequestContext> statRequestContexts { 256 };
+          BufferPool buffers;
+          URing uring;
+          StatCache stats;
+          std::map<uint64_t, Watcher*> watchers;
+
+          // regular files at least this large are mapped by `readFile()`
+          // instead of being read into a buffer, when enabled with
+          // `[filesystem] map_read_files`
+          static constexpr size_t READ_FILE_MMAP_THRESHOLD = 1024 * 1024;
+
+          // sequential reads in a row before a descriptor is read ahead,
+          // and how many chunks `setReadAhead()` keeps in flight or ready
+          // for it when it is not told and at most
+          static constexpr unsigned int READ_AHEAD_THRESHOLD = 2;
+          static constexpr size_t READ_AHEAD_CHUNKS = 4;
+          static constexpr size_t READ_AHEAD_MAX_CHUNKS = 16;
+
+          uint64_t readAheadPrefetches = 0;
+          uint64_t readAheadHits = 0;
+          uint64_t readAheadDiscards = 0;
+          // reads that found the ready chunks of their file changed
+          uint64_t readAheadStale = 0;
+
+          // how much `setWriteBehind()` holds and for how long (in
+          // milliseconds) when it is not told
+          static constexpr size_t WRITE_BEHIND_SIZE = 64 * 1024;
+          static constexpr uint64_t WRITE_BEHIND_DELAY = 5;
+
+          uint64_t writeBehindWrites = 0;
+          uint64_t writeBehindFlushes = 0;
+
+          // how long (in milliseconds) `watch()` waits for more changes
+          // before it delivers a batch when it is not told, how many of
+          // those windows a batch waits at most, and the most paths in one
+          // batch
+          static constexpr uint64_t WATCH_WINDOW = 50;
+          static constexpr uint64_t WATCH_MAX_WINDOWS = 10;
+          static constexpr size_t MAX_WATCH_BATCH = 4096;
+
+          uint64_t watchEvents = 0;
+          uint64_t watchBatches = 0;
+
+          // directories `walk()` reads at once, which leaves room in the
+          // threadpool (4 threads by default) for other requests, and the
+          // least entries in one of its posts
+          static constexpr size_t WALK_CONCURRENCY = 3;
+          static constexpr size_t WALK_BATCH_ENTRIES = 2048;
+
+          uint64_t walks = 0;
+          uint64_t walkDirectories = 0;
+
+          // the most buffers `readv()` and `writev()` give to one request,
+          // `IOV_MAX` on Linux and macOS
+          static constexpr size_t MAX_VECTORED_BUFFERS = 1024;
+          // the most bytes of one `readv()` or `writev()`, a post length is
+          // an `int`, like the size of `read()`
+          static constexpr size_t MAX_VECTORED_BYTES = INT_MAX;
+
+          DescriptorTable descriptors;
           Mutex mutex;
 
           Descriptor * getDescriptor (uint64_t id);
@@ -485,6 +1067,7 @@ namespace SSC {
           bool hasDescriptor (uint64_t id);
 
           void constants (const String seq, Module::Callback cb);
+          void diagnostics (const String seq, Module::Callback cb);
           void access (
             const String seq,
             const String path,
@@ -512,12 +1095,14 @@ namespace SSC {
             Module::Callback cb
           );
           void closeOpenDescriptors (const String seq, Module::Callback cb);
+          void closeWatchers ();
           void closeOpenDescriptors (
             const String seq,
             bool preserveRetained,
             Module::Callback cb
           );
           void fstat (const String seq, uint64_t id, Module::Callback cb);
+          void fsync (const String seq, uint64_t id, Module::Callback cb);
           void getOpenDescriptors (const String seq, Module::Callback cb);
           void lstat (const String seq, const String path, Module::Callback cb);
           void mkdir (
@@ -547,12 +1132,24 @@ namespace SSC {
             size_t offset,
             Module::Callback cb
           );
+          void readFile (
+            const String seq,
+            const String path,
+            Module::Callback cb
+          );
           void readdir (
             const String seq,
             uint64_t id,
             size_t entries,
             Module::Callback cb
           );
+          void readv (
+            const String seq,
+            uint64_t id,
+            const Vector<size_t> sizes,
+            size_t offset,
+            Module::Callback cb
+          );
           void retainOpenDescriptor (
             const String seq,
             uint64_t id,
@@ -569,6 +1166,19 @@ namespace SSC {
             const String path,
             Module::Callback cb
           );
+          void setReadAhead (
+            const String seq,
+            uint64_t id,
+            size_t chunks,
+            Module::Callback cb
+          );
+          void setWriteBehind (
+            const String seq,
+            uint64_t id,
+            size_t size,
+            uint64_t delay,
+            Module::Callback cb
+          );
           void stat (
             const String seq,
             const String path,
@@ -579,6 +1189,22 @@ namespace SSC {
             const String path,
             Module::Callback cb
           );
+          void unwatch (const String seq, uint64_t id, Module::Callback cb);
+          void walk (
+            const String seq,
+            uint64_t id,
+            const String path,
+            const WalkOptions options,
+            Module::Callback cb
+          );
+          void watch (
+            const String seq,
+            uint64_t id,
+            const String path,
+            bool recursive,
+            uint64_t window,
+            Module::Callback cb
+          );
           void write (
             const String seq,
             uint64_t id,
@@ -587,6 +1213,14 @@ namespace SSC {
             size_t offset,
             Module::Callback cb
           );
+          void writev (
+            const String seq,
+            uint64_t id,
+            char *bytes,
+            const Vector<size_t> sizes,
+            size_t offset,
+            Module::Callback cb
+          );
       };
 
       class OS : public Module {
@@ -803,6 +1437,11 @@ namespace SSC {
     const String& value
   );
 
+  String getEmitJSONToRenderProcessJavaScript (
+    const String& event,
+    const String& json
+  );
+
   String getResolveMenuSelectionJavaScript (
     const String& seq,
     const String& title,
@@ -814,6 +1453,12 @@ namespace SSC {
     const String& state,
     const String& value
   );
+
+  String getResolveJSONToRenderProcessJavaScript (
+    const String& seq,
+    const String& state,
+    const String& json
+  );
 } // SSC
 
 #endif // SSC_CORE_CORE_H
@@ -1,5 +1,9 @@
 #include "core.hh"
 
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
 namespace SSC {
   #define SET_CONSTANT(c) constants[#c] = (c);
   static std::map<String, int32_t> getFSConstantsMap () {
@@ -169,62 +173,349 @@ namespace SSC {
   }
   #undef SET_CONSTANT
 
-  JSON::Object getStatsJSON (const String& source, uv_stat_t* stats) {
-    return JSON::Object::Entries {
-      {"source", source},
-      {"data", JSON::Object::Entries {
-        {"st_dev", std::to_string(stats->st_dev)},
-        {"st_mode", std::to_string(stats->st_mode)},
-        {"st_nlink", std::to_string(stats->st_nlink)},
-        {"st_uid", std::to_string(stats->st_uid)},
-        {"st_gid", std::to_string(stats->st_gid)},
-        {"st_rdev", std::to_string(stats->st_rdev)},
-        {"st_ino", std::to_string(stats->st_ino)},
-        {"st_size", std::to_string(stats->st_size)},
-        {"st_blksize", std::to_string(stats->st_blksize)},
-        {"st_blocks", std::to_string(stats->st_blocks)},
-        {"st_flags", std::to_string(stats->st_flags)},
-        {"st_gen", std::to_string(stats->st_gen)},
-        {"st_atim", JSON::Object::Entries {
-          {"tv_sec", std::to_string(stats->st_atim.tv_sec)},
-          {"tv_nsec", std::to_string(stats->st_atim.tv_nsec)},
-        }},
-        {"st_mtim", JSON::Object::Entries {
-          {"tv_sec", std::to_string(stats->st_mtim.tv_sec)},
-          {"tv_nsec", std::to_string(stats->st_mtim.tv_nsec)}
-        }},
-        {"st_ctim", JSON::Object::Entries {
-          {"tv_sec", std::to_string(stats->st_ctim.tv_sec)},
-          {"tv_nsec", std::to_string(stats->st_ctim.tv_nsec)}
-        }},
-        {"st_birthtim", JSON::Object::Entries {
-          {"tv_sec", std::to_string(stats->st_birthtim.tv_sec)},
-          {"tv_nsec", std::to_string(stats->st_birthtim.tv_nsec)}
-        }}
-      }}
+  struct StatsTimeJSON {
+    int64_t sec;
+    int64_t nsec;
+
+    using Shape = JSON::Shape<
+      JSON::QuotedField<"tv_sec", &StatsTimeJSON::sec>,
+      JSON::QuotedField<"tv_nsec", &StatsTimeJSON::nsec>
+    >;
+  };
+
+  struct StatsJSON {
+    uint64_t dev;
+    uint64_t mode;
+    uint64_t nlink;
+    uint64_t uid;
+    uint64_t gid;
+    uint64_t rdev;
+    uint64_t ino;
+    uint64_t size;
+    uint64_t blksize;
+    uint64_t blocks;
+    uint64_t flags;
+    uint64_t gen;
+    StatsTimeJSON atim;
+    StatsTimeJSON mtim;
+    StatsTimeJSON ctim;
+    StatsTimeJSON birthtim;
+
+    using Shape = JSON::Shape<
+      JSON::QuotedField<"st_dev", &StatsJSON::dev>,
+      JSON::QuotedField<"st_mode", &StatsJSON::mode>,
+      JSON::QuotedField<"st_nlink", &StatsJSON::nlink>,
+      JSON::QuotedField<"st_uid", &StatsJSON::uid>,
+      JSON::QuotedField<"st_gid", &StatsJSON::gid>,
+      JSON::QuotedField<"st_rdev", &StatsJSON::rdev>,
+      JSON::QuotedField<"st_ino", &StatsJSON::ino>,
+      JSON::QuotedField<"st_size", &StatsJSON::size>,
+      JSON::QuotedField<"st_blksize", &StatsJSON::blksize>,
+      JSON::QuotedField<"st_blocks", &StatsJSON::blocks>,
+      JSON::QuotedField<"st_flags", &StatsJSON::flags>,
+      JSON::QuotedField<"st_gen", &StatsJSON::gen>,
+      JSON::Field<"st_atim", &StatsJSON::atim>,
+      JSON::Field<"st_mtim", &StatsJSON::mtim>,
+      JSON::Field<"st_ctim", &StatsJSON::ctim>,
+      JSON::Field<"st_birthtim", &StatsJSON::birthtim>
+    >;
+  };
+
+  struct StatsResultJSON {
+    const char* source;
+    StatsJSON data;
+
+    using Shape = JSON::Shape<
+      JSON::Field<"source", &StatsResultJSON::source>,
+      JSON::Field<"data", &StatsResultJSON::data>
+    >;
+  };
+
+  static StatsJSON toStatsJSON (const uv_stat_t* stats) {
+    return StatsJSON {
+      stats->st_dev,
+      stats->st_mode,
+      stats->st_nlink,
+      stats->st_uid,
+      stats->st_gid,
+      stats->st_rdev,
+      stats->st_ino,
+      stats->st_size,
+      stats->st_blksize,
+      stats->st_blocks,
+      stats->st_flags,
+      stats->st_gen,
+      { stats->st_atim.tv_sec, stats->st_atim.tv_nsec },
+      { stats->st_mtim.tv_sec, stats->st_mtim.tv_nsec },
+      { stats->st_ctim.tv_sec, stats->st_ctim.tv_nsec },
+      { stats->st_birthtim.tv_sec, stats->st_birthtim.tv_nsec }
     };
   }
 
-  void Core::FS::RequestContext::setBuffer (int index, size_t len, char *base) {
-    this->iov[index].base = base;
-    this->iov[index].len = len;
+  JSON::Any getStatsJSON (const char* source, uv_stat_t* stats) {
+    return StatsResultJSON { source, toStatsJSON(stats) };
+  }
+
+  // the reply of `stat()` or `lstat()` for a `result` of `uv_fs_stat()`
+  // or `uv_fs_lstat()`
+  static JSON::Any getStatResultJSON (
+    const char *source,
+    const char *errorSource,
+    int result,
+    uv_stat_t *stats
+  ) {
+    if (result < 0) {
+      return JSON::Object::Entries {
+        {"source", errorSource},
+        {"err", JSON::Object::Entries {
+          {"code", result},
+          {"message", String(uv_strerror(result))}
+        }}
+      };
+    }
+
+    return getStatsJSON(source, stats);
+  }
+
+  // results that do not change until the path or its directory does, other
+  // errors (`EMFILE`, `ENOMEM`, ...) are not kept in `Core::FS::stats`
+  static bool isKeptStatResult (int result) {
+    return result >= 0 || result == UV_ENOENT || result == UV_ENOTDIR;
+  }
+
+  // whether `stats` is of a symbolic link, whose target is not watched by
+  // `Core::FS::stats`, so what is found through it is not kept
+  static bool isSymbolicLinkStat (int result, const uv_stat_t *stats) {
+  #if defined(S_IFLNK)
+    return result >= 0 && (stats->st_mode & S_IFMT) == S_IFLNK;
+  #else
+    return false;
+  #endif
+  }
+
+  // whether `path` is known not to be a symbolic link, so `access()` of it
+  // is not of a link target
+  static bool isKnownNotSymbolicLink (Core::FS::StatCache *cache, const String& path) {
+    const auto entry = cache->get(path);
+    return (
+      entry != nullptr &&
+      entry->lstat.known &&
+      !isSymbolicLinkStat(entry->lstat.err, &entry->lstat.stat)
+    );
+  }
+
+  // a request whose result is not in `Core::FS::stats` is a miss and its
+  // result is kept when it completes, unless the cache is disabled
+  static void prepareStatRequest (
+    Core::FS *fs,
+    Core::FS::StatRequestContext *ctx,
+    const String& path,
+    int mode
+  ) {
+    ctx->cache = nullptr;
+    ctx->loop = &fs->core->eventLoop;
+    ctx->path = path;
+    ctx->target = "";
+    ctx->mode = mode;
+
+    if (fs->stats.isEnabled()) {
+      fs->stats.misses++;
+      ctx->cache = &fs->stats;
+      ctx->generation = fs->stats.generation;
+    }
+  }
+
+  // a request that changes `path` (and `target`) drops what is kept of
+  // them in `Core::FS::stats` when it completes, see `invalidateStats()`
+  static void prepareStatChange (
+    Core::FS *fs,
+    Core::FS::StatRequestContext *ctx,
+    const String& path,
+    const String& target = ""
+  ) {
+    ctx->cache = fs->stats.isEnabled() ? &fs->stats : nullptr;
+    ctx->loop = &fs->core->eventLoop;
+    ctx->path = path;
+    ctx->target = target;
+  }
+
+  static void invalidateStats (Core::FS::StatRequestContext *ctx) {
+    if (ctx->cache != nullptr) {
+      ctx->cache->invalidate(ctx->path);
+
+      if (ctx->target.size() > 0) {
+        ctx->cache->invalidate(ctx->target);
+      }
+    }
+  }
+
+  Core::FS::RequestContextPool::~RequestContextPool () {
+    for (auto ctx : this->contexts) {
+      delete ctx;
+    }
+  }
+
+  Core::FS::RequestContext* Core::FS::RequestContextPool::acquire (
+    Descriptor *desc,
+    String seq,
+    Callback cb
+  ) {
+    RequestContext *ctx = nullptr;
+
+    if (this->contexts.size() > 0) {
+      ctx = this->contexts.back();
+      this->contexts.pop_back();
+      this->reuses++;
+    } else {
+      ctx = this->allocate();
+      ctx->pool = this;
+      this->allocations++;
+    }
+
+    ctx->desc = desc;
+    ctx->seq = seq;
+    ctx->cb = cb;
+    return ctx;
+  }
+
+  void Core::FS::RequestContextPool::release (RequestContext *ctx) {
+    if (this->contexts.size() >= this->capacity) {
+      delete ctx;
+      return;
+    }
+
+    // a reused `uv_fs_t` is initialized again by the next `uv_fs_*()` call,
+    // only what the last request allocated has to be freed here
+    uv_fs_req_cleanup(&ctx->req);
+    ctx->req.data = (void *) ctx;
+    ctx->desc = nullptr;
+    ctx->seq.clear();
+    ctx->cb = nullptr;
+
+    this->contexts.push_back(ctx);
+  }
+
+  void Core::FS::RequestContext::release () {
+    if (this->pool != nullptr) {
+      this->pool->release(this);
+    } else {
+      delete this;
+    }
+  }
+
+  void Core::FS::BufferRequestContext::setBuffer (size_t len, char *base) {
+    this->buffer = uv_buf_init(base, (unsigned int) len);
+  }
+
+  void Core::FS::BufferRequestContext::freeBuffer () {
+    if (this->buffer.base != nullptr) {
+      delete [] (char *) this->buffer.base;
+    }
+
+    this->buffer = uv_buf_init(nullptr, 0);
+  }
+
+  char* Core::FS::BufferRequestContext::getBuffer () {
+    return this->buffer.base;
+  }
+
+  size_t Core::FS::BufferRequestContext::getBufferSize () {
+    return this->buffer.len;
+  }
+
+  Core::FS::BufferPool::BufferPool () {
+    auto size = MIN_BUFFER_SIZE;
+
+    for (auto& sizeClass : this->classes) {
+      sizeClass.pool = this;
+      sizeClass.size = size;
+      sizeClass.capacity = std::max((size_t) 4, MAX_FREE_BYTES / size);
+      size *= 2;
+    }
+  }
+
+  Core::FS::BufferPool::~BufferPool () {
+    for (auto& sizeClass : this->classes) {
+      for (auto buffer : sizeClass.buffers) {
+        delete [] buffer;
+      }
+    }
   }
 
-  void Core::FS::RequestContext::freeBuffer (int index) {
-    if (this->iov[index].base != nullptr) {
-      delete [] (char *) this->iov[index].base;
-      this->iov[index].base = nullptr;
+  Post Core::FS::BufferPool::acquire (size_t size) {
+    Post post;
+    post.length = size;
+
+    if (size > MAX_BUFFER_SIZE) {
+      Lock lock(this->mutex);
+      this->unpooled++;
+      post.body = new char[size];
+      return post;
+    }
+
+    auto sizeClass = &this->classes[0];
+    while (sizeClass->size < size) {
+      sizeClass++;
     }
 
-    this->iov[index].len = 0;
+    post.deallocate = release;
+    post.deallocateData = sizeClass;
+
+    do {
+      Lock lock(this->mutex);
+      sizeClass->used++;
+
+      if (sizeClass->buffers.size() > 0) {
+        post.body = sizeClass->buffers.back();
+        sizeClass->buffers.pop_back();
+        sizeClass->reuses++;
+        return post;
+      }
+
+      sizeClass->allocations++;
+    } while (0);
+
+    post.body = new char[sizeClass->size];
+    return post;
   }
 
-  char* Core::FS::RequestContext::getBuffer (int index) {
-    return this->iov[index].base;
+  void Core::FS::BufferPool::release (char *body, void *data) {
+    auto sizeClass = reinterpret_cast<SizeClass*>(data);
+
+    do {
+      Lock lock(sizeClass->pool->mutex);
+      sizeClass->used--;
+
+      if (sizeClass->buffers.size() < sizeClass->capacity) {
+        sizeClass->buffers.push_back(body);
+        return;
+      }
+    } while (0);
+
+    delete [] body;
   }
 
-  size_t Core::FS::RequestContext::getBufferSize (int index) {
-    return this->iov[index].len;
+  JSON::Object Core::FS::BufferPool::json () {
+    Lock lock(this->mutex);
+    JSON::Array classes;
+    size_t free = 0;
+
+    for (const auto& sizeClass : this->classes) {
+      free += sizeClass.buffers.size() * sizeClass.size;
+      classes.push(JSON::Object::Entries {
+        {"size", sizeClass.size},
+        {"allocations", sizeClass.allocations},
+        {"reuses", sizeClass.reuses},
+        {"used", sizeClass.used},
+        {"free", sizeClass.buffers.size()}
+      });
+    }
+
+    return JSON::Object::Entries {
+      {"classes", classes},
+      {"unpooled", this->unpooled},
+      {"freeBytes", free}
+    };
   }
 
   Core::FS::Descriptor::Descriptor (Core *core, uint64_t id) {
@@ -250,163 +541,1316 @@ namespace SSC {
     return this->stale;
   }
 
-  Core::FS::Descriptor * Core::FS::getDescriptor (uint64_t id) {
-    Lock lock(this->mutex);
-    if (descriptors.find(id) != descriptors.end()) {
-      return descriptors.at(id);
+  Core::FS::Descriptor * Core::FS::DescriptorTable::get (uint64_t id) {
+    const auto entry = this->index.find(id);
+    return entry != this->index.end() ? this->slots[entry->second] : nullptr;
+  }
+
+  void Core::FS::DescriptorTable::insert (Descriptor *desc) {
+    const auto entry = this->index.find(desc->id);
+
+    // a descriptor opened again with the same id takes its slot
+    if (entry != this->index.end()) {
+      this->unlinkStale(this->slots[entry->second]);
+      this->slots[entry->second] = desc;
+      desc->slot = entry->second;
+      return;
     }
-    return nullptr;
+
+    desc->slot = this->slots.size();
+    this->index[desc->id] = desc->slot;
+    this->slots.push_back(desc);
   }
 
-  void Core::FS::removeDescriptor (uint64_t id) {
-    Lock lock(this->mutex);
-    if (descriptors.find(id) != descriptors.end()) {
-      descriptors.erase(id);
+  void Core::FS::DescriptorTable::remove (uint64_t id) {
+    const auto entry = this->index.find(id);
+
+    if (entry == this->index.end()) {
+      return;
+    }
+
+    const auto slot = entry->second;
+    auto last = this->slots.back();
+
+    this->unlinkStale(this->slots[slot]);
+    this->index.erase(entry);
+    this->slots.pop_back();
+
+    if (slot < this->slots.size()) {
+      this->slots[slot] = last;
+      this->index[last->id] = slot;
+      last->slot = slot;
     }
   }
 
-  bool Core::FS::hasDescriptor (uint64_t id) {
-    Lock lock(this->mutex);
-    return descriptors.find(id) != descriptors.end();
+  size_t Core::FS::DescriptorTable::size () {
+    return this->slots.size();
   }
 
-  void Core::FS::retainOpenDescriptor (
-    const String seq,
-    uint64_t id,
-    Module::Callback cb
-  ) {
-    auto desc = getDescriptor(id);
+  void Core::FS::DescriptorTable::markStale (Descriptor *desc) {
+    desc->stale = true;
 
-    if (desc == nullptr) {
+    // retained descriptors are never released
+    if (desc->isRetained() || desc->isStaleLinked) {
+      return;
+    }
+
+    desc->stalePrev = nullptr;
+    desc->staleNext = this->stale;
+
+    if (this->stale != nullptr) {
+      this->stale->stalePrev = desc;
+    }
+
+    this->stale = desc;
+    this->staleCount++;
+    desc->isStaleLinked = true;
+  }
+
+  void Core::FS::DescriptorTable::unlinkStale (Descriptor *desc) {
+    if (!desc->isStaleLinked) {
+      return;
+    }
+
+    if (desc->stalePrev != nullptr) {
+      desc->stalePrev->staleNext = desc->staleNext;
+    } else {
+      this->stale = desc->staleNext;
+    }
+
+    if (desc->staleNext != nullptr) {
+      desc->staleNext->stalePrev = desc->stalePrev;
+    }
+
+    desc->staleNext = nullptr;
+    desc->stalePrev = nullptr;
+    desc->isStaleLinked = false;
+    this->staleCount--;
+  }
+
+  // empties the stale list and returns the descriptors that were in it,
+  // they stay in the table until they are closed
+  Vector<Core::FS::Descriptor*> Core::FS::DescriptorTable::releaseStale () {
+    Vector<Descriptor*> descriptors;
+    descriptors.reserve(this->staleCount);
+
+    while (this->stale != nullptr) {
+      auto desc = this->stale;
+      this->unlinkStale(desc);
+      descriptors.push_back(desc);
+    }
+
+    this->released += descriptors.size();
+    return descriptors;
+  }
+
+  JSON::Object Core::FS::DescriptorTable::json () {
+    uint64_t directories = 0;
+    uint64_t retained = 0;
+
+    for (auto desc : this->slots) {
+      if (desc->isDirectory()) directories++;
+      if (desc->isRetained()) retained++;
+    }
+
+    return JSON::Object::Entries {
+      {"open", this->slots.size()},
+      {"files", this->slots.size() - directories},
+      {"directories", directories},
+      {"retained", retained},
+      {"stale", this->staleCount},
+      {"released", this->released}
+    };
+  }
+
+  Core::FS::ReadAhead::~ReadAhead () {
+    this->discard();
+  }
+
+  uint64_t Core::FS::ReadAhead::discard () {
+    uint64_t discarded = 0;
+
+    for (auto chunk : this->chunks) {
+      if (chunk->cb == nullptr) {
+        discarded++;
+      }
+
+      // a chunk in flight owns its buffer until the read completes, and a
+      // read waiting for it is still replied to then
+      if (chunk->pending) {
+        chunk->abandoned = true;
+      } else {
+        freePostBody(chunk->post);
+        delete chunk;
+      }
+    }
+
+    this->chunks.clear();
+    return discarded;
+  }
+
+  static void adviseSequential (uv_file fd) {
+  #if defined(__linux__)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  #elif defined(__APPLE__)
+    fcntl(fd, F_RDAHEAD, 1);
+  #endif
+  }
+
+  // replies to the read waiting for `chunk` with at most `chunk->length`
+  // of its bytes, the chunk's buffer is given away or freed
+  static void replyReadAheadChunk (Core::FS::ReadAhead::Chunk *chunk) {
+    const auto result = chunk->req.result;
+
+    if (result < 0) {
       auto json = JSON::Object::Entries {
-        {"source", "fs.retainOpenDescriptor"},
+        {"source", "fs.read"},
         {"err", JSON::Object::Entries {
-          {"id", std::to_string(id)},
-          {"code", "ENOTOPEN"},
-          {"type", "NotFoundError"},
-          {"message", "No file descriptor found with that id"}
+          {"id", std::to_string(chunk->id)},
+          {"code", result},
+          {"message", String(uv_strerror((int) result))}
         }}
       };
 
-      return cb(seq, json, Post{});
+      freePostBody(chunk->post);
+      return chunk->cb(chunk->seq, json, Post{});
     }
 
-    desc->retained = true;
-    auto json = JSON::Object::Entries {
-      {"source", "fs.retainOpenDescriptor"},
-      {"data", JSON::Object::Entries {
-        {"id", std::to_string(desc->id)}
-      }}
-    };
+    const auto length = std::min((size_t) result, chunk->length);
+    auto headers = Headers {{
+      {"content-type" ,"application/octet-stream"},
+      {"content-length", length}
+    }};
 
-    cb(seq, json, Post{});
+    auto post = chunk->post;
+    post.id = SSC::rand64();
+    post.length = (int) length;
+    post.headers = headers.str();
+
+    chunk->cb(chunk->seq, JSON::Object {}, post);
   }
 
-  void Core::FS::access (
-    const String seq,
-    const String path,
-    int mode,
-    Module::Callback cb
-  ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto filename = path.c_str();
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_access(loop, req, filename, mode, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto json = JSON::Object {};
+  // the size and modification time of the file of `desc`, or false
+  static bool statReadAhead (Core::FS::Descriptor *desc, uv_stat_t *stat) {
+    uv_fs_t req;
+    auto err = uv_fs_fstat(nullptr, &req, desc->fd, nullptr);
 
-        if (req->result < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.access"},
-            {"err", JSON::Object::Entries {
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.access"},
-            {"data", JSON::Object::Entries {
-              {"mode", req->flags},
-            }}
-          };
-        }
+    if (err == 0) {
+      *stat = req.statbuf;
+    }
 
-        ctx->cb(ctx->seq, json, Post {});
-        delete ctx;
-      });
+    uv_fs_req_cleanup(&req);
+    return err == 0;
+  }
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.access"},
-          {"err", JSON::Object::Entries {
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+  // true if the file of `desc` has not changed since its ready chunks were
+  // read, which another process or descriptor may have done
+  static bool isReadAheadCurrent (Core::FS::Descriptor *desc) {
+    const auto& before = desc->readAhead.stat;
+    uv_stat_t now;
+
+    return (
+      statReadAhead(desc, &now) &&
+      now.st_size == before.st_size &&
+      now.st_mtim.tv_sec == before.st_mtim.tv_sec &&
+      now.st_mtim.tv_nsec == before.st_mtim.tv_nsec
+    );
+  }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      }
-    });
+  static void fillReadAhead (Core::FS *fs, Core::FS::Descriptor *desc);
+  static void onReadAheadChunk (uv_fs_t *req);
+
+  // reads `chunk` again for the read waiting for it, which is replied to
+  // when that completes whatever happens to the descriptor by then
+  static void rereadReadAheadChunk (Core::FS *fs, Core::FS::ReadAhead::Chunk *chunk) {
+    uv_fs_req_cleanup(&chunk->req);
+    chunk->pending = true;
+    chunk->abandoned = true;
+
+    auto err = fs->uring.read(
+      &fs->core->eventLoop,
+      &chunk->req,
+      chunk->desc->fd,
+      &chunk->buffer,
+      1,
+      (int64_t) chunk->offset,
+      onReadAheadChunk
+    );
+
+    if (err < 0) {
+      chunk->req.result = err;
+      replyReadAheadChunk(chunk);
+      delete chunk;
+    }
   }
 
-  void Core::FS::chmod (
-    const String seq,
-    const String path,
-    int mode,
-    Module::Callback cb
-  ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto filename = path.c_str();
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_chmod(loop, req, filename, mode, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto json = JSON::Object {};
+  static void onReadAheadChunk (uv_fs_t *req) {
+    auto chunk = (Core::FS::ReadAhead::Chunk *) req->data;
+    chunk->pending = false;
 
-        if (req->result < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.chmod"},
-            {"err", JSON::Object::Entries {
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.chmod"},
-            {"data", JSON::Object::Entries {
-              {"mode", req->flags},
-            }}
-          };
-        }
+    // the descriptor may be gone, only the chunk is used
+    if (chunk->abandoned) {
+      if (chunk->cb != nullptr) {
+        replyReadAheadChunk(chunk);
+      } else {
+        freePostBody(chunk->post);
+      }
 
-        ctx->cb(ctx->seq, json, Post {});
-        delete ctx;
-      });
+      delete chunk;
+      return;
+    }
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.chmod"},
-          {"err", JSON::Object::Entries {
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+    auto desc = chunk->desc;
+    auto fs = &desc->core->fs;
+    auto& readAhead = desc->readAhead;
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+    // a short chunk is not kept for a later read, more may be written to
+    // the file by then, and neither is what was read ahead after it. A read
+    // waiting for it asked while it was read, so it is replied to.
+    if (req->result < (ssize_t) chunk->size && chunk->cb == nullptr) {
+      fs->readAheadDiscards += readAhead.discard();
+      return;
+    }
+
+    if (chunk->cb != nullptr) {
+      auto& chunks = readAhead.chunks;
+      chunks.erase(std::find(chunks.begin(), chunks.end(), chunk));
+
+      // the file may have changed after the chunk was read but before the
+      // read waiting for it was made
+      if (!isReadAheadCurrent(desc)) {
+        fs->readAheadStale++;
+        fs->readAheadDiscards += readAhead.discard();
+        return rereadReadAheadChunk(fs, chunk);
       }
-    });
+
+      replyReadAheadChunk(chunk);
+      delete chunk;
+      fillReadAhead(fs, desc);
+    }
   }
 
-  void Core::FS::close (
+  // reads whole chunks after the last one read ahead (or after the last
+  // read) that end before the end of the file, until `readAhead.depth` are
+  // in flight or ready
+  static void fillReadAhead (Core::FS *fs, Core::FS::Descriptor *desc) {
+    auto loop = &fs->core->eventLoop;
+    auto& readAhead = desc->readAhead;
+    auto offset = readAhead.next;
+
+    if (readAhead.chunks.size() > 0) {
+      const auto last = readAhead.chunks.back();
+      offset = last->offset + last->size;
+    } else if (!statReadAhead(desc, &readAhead.stat)) {
+      return;
+    }
+
+    while (
+      readAhead.chunks.size() < readAhead.depth &&
+      offset + readAhead.size <= readAhead.stat.st_size
+    ) {
+      auto chunk = new Core::FS::ReadAhead::Chunk();
+      chunk->desc = desc;
+      chunk->id = desc->id;
+      chunk->offset = offset;
+      chunk->size = readAhead.size;
+      chunk->post = fs->buffers.acquire(chunk->size);
+      chunk->buffer = uv_buf_init(chunk->post.body, (unsigned int) chunk->size);
+
+      auto err = fs->uring.read(
+        loop,
+        &chunk->req,
+        desc->fd,
+        &chunk->buffer,
+        1,
+        (int64_t) offset,
+        onReadAheadChunk
+      );
+
+      if (err < 0) {
+        freePostBody(chunk->post);
+        delete chunk;
+        break;
+      }
+
+      readAhead.chunks.push_back(chunk);
+      fs->readAheadPrefetches++;
+      offset += chunk->size;
+    }
+  }
+
+  // stops reading ahead of `desc`, its file is about to change or close
+  static void stopReadAhead (Core::FS *fs, Core::FS::Descriptor *desc) {
+    fs->readAheadDiscards += desc->readAhead.discard();
+    desc->readAhead.sequential = 0;
+  }
+
+  // replies to a read with a chunk read ahead of it and returns true, or
+  // follows how `desc` is read, starts reading ahead of it once its reads
+  // are sequential and returns false
+  static bool readFromReadAhead (
+    Core::FS *fs,
+    Core::FS::Descriptor *desc,
+    const String& seq,
+    size_t size,
+    size_t offset,
+    const Core::Module::Callback& cb
+  ) {
+    auto& readAhead = desc->readAhead;
+
+    // a read at the current position has no offset to follow
+    if (
+      readAhead.depth == 0 ||
+      (int64_t) offset < 0 ||
+      size == 0 ||
+      size > Core::FS::BufferPool::MAX_BUFFER_SIZE
+    ) {
+      stopReadAhead(fs, desc);
+      readAhead.next = 0;
+      readAhead.size = 0;
+      return false;
+    }
+
+    // only the first chunk no read is waiting for can be next
+    for (auto chunk : readAhead.chunks) {
+      if (chunk->cb != nullptr) {
+        continue;
+      }
+
+      if (chunk->offset != offset || chunk->size < size) {
+        break;
+      }
+
+      // a ready chunk holds what the file was when it was read
+      if (!chunk->pending && !isReadAheadCurrent(desc)) {
+        fs->readAheadStale++;
+        break;
+      }
+
+      fs->readAheadHits++;
+      readAhead.next = offset + size;
+      chunk->seq = seq;
+      chunk->length = size;
+      chunk->cb = cb;
+
+      // a chunk in flight replies when its read completes
+      if (!chunk->pending) {
+        auto& chunks = readAhead.chunks;
+        chunks.erase(std::find(chunks.begin(), chunks.end(), chunk));
+        replyReadAheadChunk(chunk);
+        delete chunk;
+        fillReadAhead(fs, desc);
+      }
+
+      return true;
+    }
+
+    const auto sequential = offset == readAhead.next && size == readAhead.size;
+
+    fs->readAheadDiscards += readAhead.discard();
+    readAhead.sequential = sequential ? readAhead.sequential + 1 : 0;
+    readAhead.next = offset + size;
+    readAhead.size = size;
+
+    if (readAhead.sequential >= Core::FS::READ_AHEAD_THRESHOLD) {
+      if (!readAhead.advised) {
+        adviseSequential(desc->fd);
+        readAhead.advised = true;
+      }
+
+      // this read goes to the file as usual, the chunks start after it
+      fillReadAhead(fs, desc);
+    }
+
+    return false;
+  }
+
+  // replies to each write of `batch` with the part of `result` that is
+  // its own, a write the file did not take all of fails
+  static void replyWriteBehind (Core::FS::WriteBehind::Batch *batch, ssize_t result) {
+    size_t offset = 0;
+
+    for (const auto& write : batch->writes) {
+      JSON::Object json;
+
+      if (result >= 0 && offset + write.size <= (size_t) result) {
+        json = JSON::Object::Entries {
+          {"source", write.source},
+          {"data", JSON::Object::Entries {
+            {"id", std::to_string(batch->id)},
+            {"result", write.size}
+          }}
+        };
+      } else {
+        const auto code = result < 0 ? (int) result : UV_EIO;
+        json = JSON::Object::Entries {
+          {"source", write.source},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(batch->id)},
+            {"code", code},
+            {"message", String(uv_strerror(code))}
+          }}
+        };
+      }
+
+      offset += write.size;
+      write.cb(write.seq, json, Post{});
+    }
+  }
+
+  Core::FS::WriteBehind::~WriteBehind () {
+    for (auto batch : this->batches) {
+      // a batch in flight replies when its write completes
+      if (batch->flushing) {
+        batch->desc = nullptr;
+        continue;
+      }
+
+      replyWriteBehind(batch, UV_ECANCELED);
+      delete batch;
+    }
+
+    if (this->timer != nullptr) {
+      uv_close((uv_handle_t *) this->timer, [](uv_handle_t *handle) {
+        delete (uv_timer_t *) handle;
+      });
+    }
+  }
+
+  static void flushWriteBehind (Core::FS *fs, Core::FS::Descriptor *desc);
+
+  static void onWriteBehindFlushed (uv_fs_t *req) {
+    auto batch = (Core::FS::WriteBehind::Batch *) req->data;
+    auto desc = batch->desc;
+
+    if (desc != nullptr) {
+      auto& batches = desc->writeBehind.batches;
+      batches.erase(batches.begin());
+    }
+
+    if (desc != nullptr) {
+      desc->core->fs.stats.invalidate(desc->path);
+    }
+
+    replyWriteBehind(batch, req->result);
+
+    for (const auto& callback : batch->after) {
+      callback();
+    }
+
+    delete batch;
+
+    // writes held while the batch was in flight have waited long enough
+    if (desc != nullptr) {
+      flushWriteBehind(&desc->core->fs, desc);
+    }
+  }
+
+  // writes the first batch held for `desc` unless it is in flight, the
+  // batches after it are written as each one before them completes
+  static void flushWriteBehind (Core::FS *fs, Core::FS::Descriptor *desc) {
+    auto& writeBehind = desc->writeBehind;
+
+    if (writeBehind.batches.size() == 0 || writeBehind.batches.front()->flushing) {
+      return;
+    }
+
+    if (writeBehind.timer != nullptr) {
+      uv_timer_stop(writeBehind.timer);
+    }
+
+    auto loop = &fs->core->eventLoop;
+    auto batch = writeBehind.batches.front();
+    batch->flushing = true;
+    fs->writeBehindFlushes++;
+
+    auto err = fs->uring.write(
+      loop,
+      &batch->req,
+      desc->fd,
+      batch->buffers.data(),
+      (unsigned int) batch->buffers.size(),
+      batch->offset,
+      onWriteBehindFlushed
+    );
+
+    if (err < 0) {
+      batch->req.result = err;
+      onWriteBehindFlushed(&batch->req);
+    }
+  }
+
+  // holds the `buffers` of a write to be written with the writes around it,
+  // `cb` is called once they are
+  static void holdWrite (
+    Core::FS *fs,
+    Core::FS::Descriptor *desc,
+    const String& source,
+    const String& seq,
+    const Core::Module::Callback& cb,
+    const uv_buf_t buffers[],
+    unsigned int nbufs,
+    int64_t offset
+  ) {
+    auto& writeBehind = desc->writeBehind;
+    auto batch = writeBehind.batches.size() > 0 ? writeBehind.batches.back() : nullptr;
+    size_t size = 0;
+
+    // writes at the current position follow each other, others only when
+    // each starts where the previous one ended
+    if (
+      batch == nullptr ||
+      batch->flushing ||
+      batch->sealed ||
+      batch->buffers.size() + nbufs > Core::FS::MAX_VECTORED_BUFFERS ||
+      (batch->offset < 0) != (offset < 0) ||
+      (offset >= 0 && offset != batch->offset + (int64_t) batch->size)
+    ) {
+      batch = new Core::FS::WriteBehind::Batch();
+      batch->desc = desc;
+      batch->id = desc->id;
+      batch->offset = offset;
+      writeBehind.batches.push_back(batch);
+    }
+
+    for (unsigned int i = 0; i < nbufs; ++i) {
+      batch->buffers.push_back(buffers[i]);
+      size += buffers[i].len;
+    }
+
+    batch->writes.push_back({ source, seq, cb, size });
+    batch->size += size;
+    fs->writeBehindWrites++;
+
+    if (batch->size >= writeBehind.size || writeBehind.batches.size() > 1) {
+      return flushWriteBehind(fs, desc);
+    }
+
+    if (writeBehind.timer == nullptr) {
+      writeBehind.timer = new uv_timer_t;
+      writeBehind.timer->data = (void *) desc;
+      uv_timer_init(&fs->core->eventLoop, writeBehind.timer);
+    }
+
+    // a write is held at most `delay` from the first write of its batch
+    if (!uv_is_active((uv_handle_t *) writeBehind.timer)) {
+      uv_timer_start(writeBehind.timer, [](uv_timer_t *timer) {
+        auto desc = (Core::FS::Descriptor *) timer->data;
+        flushWriteBehind(&desc->core->fs, desc);
+      }, writeBehind.delay, 0);
+    }
+  }
+
+  // calls `callback` once every write held for `desc` is written and
+  // returns true, or returns false if no writes are held
+  static bool afterWriteBehind (
+    Core::FS *fs,
+    Core::FS::Descriptor *desc,
+    const std::function<void()>& callback
+  ) {
+    auto& writeBehind = desc->writeBehind;
+
+    if (writeBehind.batches.size() == 0) {
+      return false;
+    }
+
+    auto batch = writeBehind.batches.back();
+    batch->sealed = true;
+    batch->after.push_back(callback);
+    flushWriteBehind(fs, desc);
+    return true;
+  }
+
+  Core::FS::Descriptor * Core::FS::getDescriptor (uint64_t id) {
+    Lock lock(this->mutex);
+    return descriptors.get(id);
+  }
+
+  void Core::FS::removeDescriptor (uint64_t id) {
+    Lock lock(this->mutex);
+    descriptors.remove(id);
+  }
+
+  bool Core::FS::hasDescriptor (uint64_t id) {
+    Lock lock(this->mutex);
+    return descriptors.get(id) != nullptr;
+  }
+
+  void Core::FS::retainOpenDescriptor (
+    const String seq,
+    uint64_t id,
+    Module::Callback cb
+  ) {
+    auto desc = getDescriptor(id);
+
+    if (desc == nullptr) {
+      auto json = JSON::Object::Entries {
+        {"source", "fs.retainOpenDescriptor"},
+        {"err", JSON::Object::Entries {
+          {"id", std::to_string(id)},
+          {"code", "ENOTOPEN"},
+          {"type", "NotFoundError"},
+          {"message", "No file descriptor found with that id"}
+        }}
+      };
+
+      return cb(seq, json, Post{});
+    }
+
+    do {
+      Lock lock(this->mutex);
+      desc->retained = true;
+      descriptors.unlinkStale(desc);
+    } while (0);
+
+    auto json = JSON::Object::Entries {
+      {"source", "fs.retainOpenDescriptor"},
+      {"data", JSON::Object::Entries {
+        {"id", std::to_string(desc->id)}
+      }}
+    };
+
+    cb(seq, json, Post{});
+  }
+
+  void Core::FS::access (
+    const String seq,
+    const String path,
+    int mode,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      auto cached = this->stats.isEnabled() ? this->stats.get(path) : nullptr;
+
+      if (cached != nullptr && cached->access.contains(mode)) {
+        const auto result = cached->access.at(mode);
+        auto json = JSON::Object {};
+
+        if (result < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.access"},
+            {"err", JSON::Object::Entries {
+              {"code", result},
+              {"message", String(uv_strerror(result))}
+            }}
+          };
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.access"},
+            {"data", JSON::Object::Entries {
+              {"mode", mode},
+            }}
+          };
+        }
+
+        this->stats.hits++;
+        return cb(seq, json, Post{});
+      }
+
+      auto filename = path.c_str();
+      auto loop = &this->core->eventLoop;
+      auto ctx = this->statRequestContexts.acquire(nullptr, seq, cb);
+      auto req = &ctx->req;
+
+      prepareStatRequest(this, ctx, path, mode);
+
+      auto err = uv_fs_access(loop, req, filename, mode, [](uv_fs_t* req) {
+        auto ctx = (StatRequestContext *) req->data;
+        auto json = JSON::Object {};
+
+        if (req->result < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.access"},
+            {"err", JSON::Object::Entries {
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
+            }}
+          };
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.access"},
+            {"data", JSON::Object::Entries {
+              {"mode", req->flags},
+            }}
+          };
+        }
+
+        if (
+          ctx->cache != nullptr &&
+          isKeptStatResult((int) req->result) &&
+          isKnownNotSymbolicLink(ctx->cache, ctx->path)
+        ) {
+          const auto result = (int) req->result;
+          ctx->cache->set(ctx->loop, ctx->path, ctx->generation, [&](auto& entry) {
+            entry.access[ctx->mode] = result;
+          });
+        }
+
+        ctx->cb(ctx->seq, json, Post {});
+        ctx->release();
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.access"},
+          {"err", JSON::Object::Entries {
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        ctx->release();
+      }
+    });
+  }
+
+  void Core::FS::chmod (
+    const String seq,
+    const String path,
+    int mode,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      auto filename = path.c_str();
+      auto loop = &this->core->eventLoop;
+      auto ctx = this->statRequestContexts.acquire(nullptr, seq, cb);
+      auto req = &ctx->req;
+
+      prepareStatChange(this, ctx, path);
+
+      auto err = uv_fs_chmod(loop, req, filename, mode, [](uv_fs_t* req) {
+        auto ctx = (StatRequestContext *) req->data;
+        auto json = JSON::Object {};
+
+        if (req->result < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.chmod"},
+            {"err", JSON::Object::Entries {
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
+            }}
+          };
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.chmod"},
+            {"data", JSON::Object::Entries {
+              {"mode", req->flags},
+            }}
+          };
+        }
+
+        invalidateStats(ctx);
+        ctx->cb(ctx->seq, json, Post {});
+        ctx->release();
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.chmod"},
+          {"err", JSON::Object::Entries {
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        ctx->release();
+      }
+    });
+  }
+
+  void Core::FS::close (
+    const String seq,
+    uint64_t id,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.close"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"type", "NotFoundError"},
+            {"message", "No file descriptor found with that id"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      // held writes are written first
+      if (afterWriteBehind(this, desc, [=, this]() { this->close(seq, id, cb); })) {
+        return;
+      }
+
+      stopReadAhead(this, desc);
+
+      auto loop = &this->core->eventLoop;
+      auto ctx = this->requestContexts.acquire(desc, seq, cb);
+      auto req = &ctx->req;
+      auto err = this->uring.close(loop, req, desc->fd, [](uv_fs_t* req) {
+        auto ctx = (RequestContext *) req->data;
+        auto desc = ctx->desc;
+        auto json = JSON::Object {};
+
+        if (req->result < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.close"},
+            {"err", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
+            }}
+          };
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.close"},
+            {"data", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"fd", desc->fd}
+            }}
+          };
+
+          desc->core->fs.removeDescriptor(desc->id);
+          delete desc;
+        }
+
+        ctx->cb(ctx->seq, json, Post{});
+        ctx->release();
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.close"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(desc->id)},
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        ctx->release();
+      }
+    });
+  }
+
+  void Core::FS::open (
+    const String seq,
+    uint64_t id,
+    const String path,
+    int flags,
+    int mode,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      auto filename = path.c_str();
+      auto desc = new Descriptor(this->core, id);
+      auto loop = &this->core->eventLoop;
+      desc->path = path;
+      auto ctx = this->requestContexts.acquire(desc, seq, cb);
+      auto req = &ctx->req;
+      auto err = this->uring.open(loop, req, filename, flags, mode, [](uv_fs_t* req) {
+        auto ctx = (RequestContext *) req->data;
+        auto desc = ctx->desc;
+        auto json = JSON::Object {};
+
+        if (req->result < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.open"},
+            {"err", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
+            }}
+          };
+
+          delete desc;
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.open"},
+            {"data", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"fd", (int) req->result}
+            }}
+          };
+
+          desc->fd = (int) req->result;
+
+          // a file created or truncated is no longer what was kept of it
+          if ((req->flags & (O_CREAT | O_TRUNC)) != 0) {
+            desc->core->fs.stats.invalidate(desc->path);
+          }
+
+          // insert into `descriptors` table
+          Lock lock(desc->core->fs.mutex);
+          desc->core->fs.descriptors.insert(desc);
+        }
+
+        ctx->cb(ctx->seq, json, Post{});
+        ctx->release();
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.open"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(desc->id)},
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        delete desc;
+        ctx->release();
+      }
+    });
+  }
+
+  void Core::FS::opendir (
+    const String seq,
+    uint64_t id,
+    const String path,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      auto filename = path.c_str();
+      auto desc =  new Descriptor(this->core, id);
+      auto loop = &this->core->eventLoop;
+      auto ctx = this->requestContexts.acquire(desc, seq, cb);
+      auto req = &ctx->req;
+      auto err = uv_fs_opendir(loop, req, filename, [](uv_fs_t *req) {
+        auto ctx = (RequestContext *) req->data;
+        auto desc = ctx->desc;
+        auto json = JSON::Object {};
+
+        if (req->result < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.opendir"},
+            {"err", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
+            }}
+          };
+
+          delete desc;
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.opendir"},
+            {"data", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)}
+            }}
+          };
+
+          desc->dir = (uv_dir_t *) req->ptr;
+          // insert into `descriptors` table
+          Lock lock(desc->core->fs.mutex);
+          desc->core->fs.descriptors.insert(desc);
+        }
+
+        ctx->cb(ctx->seq, json, Post{});
+        ctx->release();
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.opendir"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(desc->id)},
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        delete desc;
+        ctx->release();
+      }
+    });
+  }
+
+  void Core::FS::readdir (
+    const String seq,
+    uint64_t id,
+    size_t nentries,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.close"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"type", "NotFoundError"},
+            {"message", "No directory descriptor found with that id"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      if (!desc->isDirectory()) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.close"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"message", "No directory descriptor found with that id"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      Lock lock(desc->mutex);
+      auto loop = &this->core->eventLoop;
+      auto ctx = this->directoryRequestContexts.acquire(desc, seq, cb);
+      auto req = &ctx->req;
+
+      desc->dir->dirents = ctx->dirents;
+      desc->dir->nentries = nentries;
+
+      auto err = uv_fs_readdir(loop, req, desc->dir, [](uv_fs_t *req) {
+        auto ctx = (RequestContext *) req->data;
+        auto desc = ctx->desc;
+        auto json = JSON::Object {};
+
+        if (req->result < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.readdir"},
+            {"err", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
+            }}
+          };
+        } else {
+          Vector<JSON::Any> entries;
+
+          for (int i = 0; i < req->result; ++i) {
+            auto entry = JSON::Object::Entries {
+              {"type", desc->dir->dirents[i].type},
+              {"name", desc->dir->dirents[i].name}
+            };
+
+            entries.push_back(entry);
+          }
+
+          json = JSON::Object::Entries {
+            {"source", "fs.readdir"},
+            {"data", entries}
+          };
+        }
+
+        ctx->cb(ctx->seq, json, Post{});
+        ctx->release();
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.readdir"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(desc->id)},
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        ctx->release();
+      }
+    });
+  }
+
+  void Core::FS::closedir (
+    const String seq,
+    uint64_t id,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.closedir"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"type", "NotFoundError"},
+            {"message", "No directory descriptor found with that id"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      if (!desc->isDirectory()) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.closedir"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"message", "The descriptor found with was not a directory"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      auto loop = &this->core->eventLoop;
+      auto ctx = this->requestContexts.acquire(desc, seq, cb);
+      auto req = &ctx->req;
+      auto err = uv_fs_closedir(loop, req, desc->dir, [](uv_fs_t* req) {
+        auto ctx = (RequestContext *) req->data;
+        auto desc = ctx->desc;
+        auto json = JSON::Object {};
+
+        if (req->result < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.closedir"},
+            {"err", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
+            }}
+          };
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.closedir"},
+            {"data", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"fd", desc->fd}
+            }}
+          };
+
+          desc->core->fs.removeDescriptor(desc->id);
+          delete desc;
+        }
+
+        ctx->cb(ctx->seq, json, Post{});
+        ctx->release();
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.closedir"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(desc->id)},
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        ctx->release();
+      }
+    });
+  }
+
+  void Core::FS::closeOpenDescriptor (
+    const String seq,
+    uint64_t id,
+    Module::Callback cb
+  ) {
+    auto desc = getDescriptor(id);
+
+    if (desc == nullptr) {
+      auto json = JSON::Object::Entries {
+        {"source", "fs.closeOpenDescriptor"},
+        {"err", JSON::Object::Entries {
+          {"id", std::to_string(id)},
+          {"code", "ENOTOPEN"},
+          {"type", "NotFoundError"},
+          {"message", "No descriptor found with that id"}
+        }}
+      };
+
+      return cb(seq, json, Post{});
+    }
+
+    if (desc->isDirectory()) {
+      this->closedir(seq, id, cb);
+    } else if (desc->isFile()) {
+      this->close(seq, id, cb);
+    }
+  }
+
+  void Core::FS::closeOpenDescriptors (const String seq, Module::Callback cb) {
+    return this->closeOpenDescriptors(seq, false, cb);
+  }
+
+  void Core::FS::closeOpenDescriptors (
+    const String seq,
+    bool preserveRetained,
+    Module::Callback cb
+  ) {
+    Lock lock(this->mutex);
+
+    auto pending = descriptors.size();
+    int queued = 0;
+    auto json = JSON::Object {};
+    auto ids = Vector<uint64_t> {};
+
+    for (auto const desc : descriptors.slots) {
+      ids.push_back(desc->id);
+    }
+
+    for (auto const id : ids) {
+      auto desc = descriptors.get(id);
+      pending--;
+
+      if (desc == nullptr) {
+        continue;
+      }
+
+      if (preserveRetained && desc->isRetained()) {
+        continue;
+      }
+
+      if (desc->isDirectory()) {
+        queued++;
+        this->closedir(seq, id, [pending, cb](auto seq, auto json, auto post) {
+          if (pending == 0) {
+            cb(seq, json, post);
+          }
+        });
+      } else if (desc->isFile()) {
+        queued++;
+        this->close(seq, id, [pending, cb](auto seq, auto json, auto post) {
+          if (pending == 0) {
+            cb(seq, json, post);
+          }
+        });
+      }
+    }
+
+    if (queued == 0) {
+      cb(seq, json, Post{});
+    }
+  }
+
+  void Core::FS::closeWatchers () {
+    for (const auto& entry : this->watchers) {
+      entry.second->close();
+    }
+
+    this->watchers.clear();
+  }
+
+  void Core::FS::read (
     const String seq,
     uint64_t id,
+    size_t size,
+    size_t offset,
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
@@ -414,7 +1858,7 @@ namespace SSC {
 
       if (desc == nullptr) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.close"},
+          {"source", "fs.read"},
           {"err", JSON::Object::Entries {
             {"id", std::to_string(id)},
             {"code", "ENOTOPEN"},
@@ -426,43 +1870,58 @@ namespace SSC {
         return cb(seq, json, Post{});
       }
 
+      // held writes are written first
+      if (afterWriteBehind(this, desc, [=, this]() { this->read(seq, id, size, offset, cb); })) {
+        return;
+      }
+
+      if (readFromReadAhead(this, desc, seq, size, offset, cb)) {
+        return;
+      }
+
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
+      auto ctx = this->bufferRequestContexts.acquire(desc, seq, cb);
       auto req = &ctx->req;
-      auto err = uv_fs_close(loop, req, desc->fd, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
+
+      ctx->post = this->buffers.acquire(size);
+      ctx->setBuffer(size, ctx->post.body);
+
+      auto err = this->uring.read(loop, req, desc->fd, &ctx->buffer, 1, offset, [](uv_fs_t* req) {
+        auto ctx = static_cast<BufferRequestContext*>(req->data);
         auto desc = ctx->desc;
         auto json = JSON::Object {};
+        Post post = {0};
 
         if (req->result < 0) {
           json = JSON::Object::Entries {
-            {"source", "fs.close"},
+            {"source", "fs.read"},
             {"err", JSON::Object::Entries {
               {"id", std::to_string(desc->id)},
               {"code", req->result},
               {"message", String(uv_strerror((int) req->result))}
             }}
           };
+
+          freePostBody(ctx->post);
         } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.close"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"fd", desc->fd}
-            }}
-          };
+          auto headers = Headers {{
+            {"content-type" ,"application/octet-stream"},
+            {"content-length", req->result}
+          }};
 
-          desc->core->fs.removeDescriptor(desc->id);
-          delete desc;
+          post = ctx->post;
+          post.id = SSC::rand64();
+          post.length = (int) req->result;
+          post.headers = headers.str();
         }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->cb(ctx->seq, json, post);
+        ctx->release();
       });
 
       if (err < 0) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.close"},
+          {"source", "fs.read"},
           {"err", JSON::Object::Entries {
             {"id", std::to_string(desc->id)},
             {"code", err},
@@ -471,63 +1930,142 @@ namespace SSC {
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        freePostBody(ctx->post);
+        ctx->release();
       }
     });
   }
 
-  void Core::FS::open (
+  // the error of a `readv()` or `writev()` given more buffers than one
+  // request can take, or none at all
+  static JSON::Object getVectoredBuffersErrorJSON (const String& source, uint64_t id) {
+    return JSON::Object::Entries {
+      {"source", source},
+      {"err", JSON::Object::Entries {
+        {"id", std::to_string(id)},
+        {"code", UV_EINVAL},
+        {"message",
+          "Expecting between 1 and " + std::to_string(Core::FS::MAX_VECTORED_BUFFERS) +
+          " buffers of at most " + std::to_string(Core::FS::MAX_VECTORED_BYTES) + " bytes in all"
+        }
+      }}
+    };
+  }
+
+  // the total of `sizes`, or -1 when there are no buffers, too many of them
+  // or more bytes than one request reads or writes
+  static int64_t getVectoredBuffersSize (const Vector<size_t>& sizes) {
+    size_t size = 0;
+
+    if (sizes.size() == 0 || sizes.size() > Core::FS::MAX_VECTORED_BUFFERS) {
+      return -1;
+    }
+
+    for (const auto bufferSize : sizes) {
+      if (bufferSize > Core::FS::MAX_VECTORED_BYTES - size) {
+        return -1;
+      }
+
+      size += bufferSize;
+    }
+
+    return (int64_t) size;
+  }
+
+  void Core::FS::readv (
     const String seq,
     uint64_t id,
-    const String path,
-    int flags,
-    int mode,
+    const Vector<size_t> sizes,
+    size_t offset,
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
-      auto filename = path.c_str();
-      auto desc = new Descriptor(this->core, id);
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.readv"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"type", "NotFoundError"},
+            {"message", "No file descriptor found with that id"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      // held writes are written first
+      if (afterWriteBehind(this, desc, [=, this]() { this->readv(seq, id, sizes, offset, cb); })) {
+        return;
+      }
+
+      const auto size = getVectoredBuffersSize(sizes);
+
+      if (size < 0) {
+        return cb(seq, getVectoredBuffersErrorJSON("fs.readv", id), Post{});
+      }
+
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
+      auto ctx = this->vectoredRequestContexts.acquire(desc, seq, cb);
       auto req = &ctx->req;
-      auto err = uv_fs_open(loop, req, filename, flags, mode, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
 
-        if (req->result < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.open"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
+      // the buffers are consecutive segments of one body, so the reply is
+      // what the kernel read and the caller splits it by `sizes`
+      ctx->post = this->buffers.acquire(size);
+      ctx->buffers.clear();
 
-          delete desc;
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.open"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"fd", (int) req->result}
-            }}
-          };
+      auto base = ctx->post.body;
+      for (const auto bufferSize : sizes) {
+        ctx->buffers.push_back(uv_buf_init(base, (unsigned int) bufferSize));
+        base += bufferSize;
+      }
 
-          desc->fd = (int) req->result;
-          // insert into `descriptors` map
-          Lock lock(desc->core->fs.mutex);
-          desc->core->fs.descriptors.insert_or_assign(desc->id, desc);
-        }
+      auto err = this->uring.read(
+        loop,
+        req,
+        desc->fd,
+        ctx->buffers.data(),
+        (unsigned int) ctx->buffers.size(),
+        offset,
+        [](uv_fs_t* req) {
+          auto ctx = static_cast<VectoredRequestContext*>(req->data);
+          auto desc = ctx->desc;
+          auto json = JSON::Object {};
+          Post post = {0};
+
+          if (req->result < 0) {
+            json = JSON::Object::Entries {
+              {"source", "fs.readv"},
+              {"err", JSON::Object::Entries {
+                {"id", std::to_string(desc->id)},
+                {"code", req->result},
+                {"message", String(uv_strerror((int) req->result))}
+              }}
+            };
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      });
+            freePostBody(ctx->post);
+          } else {
+            auto headers = Headers {{
+              {"content-type" ,"application/octet-stream"},
+              {"content-length", req->result}
+            }};
+
+            post = ctx->post;
+            post.id = SSC::rand64();
+            post.length = (int) req->result;
+            post.headers = headers.str();
+          }
+
+          ctx->cb(ctx->seq, json, post);
+          ctx->release();
+        }
+      );
 
       if (err < 0) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.open"},
+          {"source", "fs.readv"},
           {"err", JSON::Object::Entries {
             {"id", std::to_string(desc->id)},
             {"code", err},
@@ -536,79 +2074,202 @@ namespace SSC {
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete desc;
-        delete ctx;
+        freePostBody(ctx->post);
+        ctx->release();
       }
     });
   }
 
-  void Core::FS::opendir (
+  // the initial buffer of a file that is read until EOF
+  static constexpr size_t READ_FILE_CHUNK_SIZE = 64 * 1024;
+
+#if !defined(_WIN32)
+  // Mapping a large file saves reading it into a buffer, but the WebView
+  // reads the mapping after the reply, and a file truncated by another
+  // process before then faults with SIGBUS, so it is opt-in with
+  // `[filesystem] map_read_files`.
+  static bool isReadFileMappingEnabled () {
+    static auto userConfig = SSC::getUserConfig();
+    static const auto enabled = userConfig["filesystem_map_read_files"] == "true";
+    return enabled;
+  }
+#endif
+
+  static JSON::Object getReadFileErrorJSON (int err) {
+    return JSON::Object::Entries {
+      {"source", "fs.readFile"},
+      {"err", JSON::Object::Entries {
+        {"code", err},
+        {"message", String(uv_strerror(err))}
+      }}
+    };
+  }
+
+  // replies with `json` and `post` and then closes the file, the context is
+  // released once it is closed
+  static void finishReadFile (
+    Core::FS::ReadFileRequestContext *ctx,
+    const JSON::Any& json,
+    const Post& post
+  ) {
+    ctx->cb(ctx->seq, json, post);
+    uv_fs_req_cleanup(&ctx->req);
+
+    if (ctx->fd < 0) {
+      ctx->release();
+      return;
+    }
+
+    auto loop = ctx->req.loop;
+    auto err = uv_fs_close(loop, &ctx->req, ctx->fd, [](uv_fs_t* req) {
+      auto ctx = (Core::FS::ReadFileRequestContext *) req->data;
+      ctx->release();
+    });
+
+    if (err < 0) {
+      ctx->release();
+    }
+  }
+
+  static void replyReadFile (Core::FS::ReadFileRequestContext *ctx) {
+    auto post = ctx->post;
+    auto headers = Headers {{
+      {"content-type" ,"application/octet-stream"},
+      {"content-length", ctx->offset}
+    }};
+
+    post.id = SSC::rand64();
+    post.length = ctx->offset;
+    post.headers = headers.str();
+
+    finishReadFile(ctx, JSON::Object {}, post);
+  }
+
+  // reads from `ctx->offset` into the rest of `ctx->post.body`
+  static void readFileChunk (Core::FS::ReadFileRequestContext *ctx) {
+    auto loop = ctx->req.loop;
+    auto remaining = ctx->post.length - ctx->offset;
+
+    uv_fs_req_cleanup(&ctx->req);
+    ctx->setBuffer(remaining, ctx->post.body + ctx->offset);
+
+    auto err = uv_fs_read(loop, &ctx->req, ctx->fd, &ctx->buffer, 1, ctx->offset, [](uv_fs_t* req) {
+      auto ctx = (Core::FS::ReadFileRequestContext *) req->data;
+
+      if (req->result < 0) {
+        freePostBody(ctx->post);
+        return finishReadFile(ctx, getReadFileErrorJSON((int) req->result), Post{});
+      }
+
+      ctx->offset += req->result;
+
+      // a regular file is read up to the size it had when it was opened,
+      // anything else is read until EOF in a buffer that grows as needed
+      if (req->result == 0 || (ctx->size > 0 && ctx->offset >= ctx->size)) {
+        return replyReadFile(ctx);
+      }
+
+      if (ctx->offset == ctx->post.length) {
+        auto length = ctx->post.length * 2;
+        auto body = new char[length];
+        memcpy(body, ctx->post.body, ctx->offset);
+        delete [] ctx->post.body;
+        ctx->post.body = body;
+        ctx->post.length = length;
+      }
+
+      readFileChunk(ctx);
+    });
+
+    if (err < 0) {
+      freePostBody(ctx->post);
+      finishReadFile(ctx, getReadFileErrorJSON(err), Post{});
+    }
+  }
+
+  void Core::FS::readFile (
     const String seq,
-    uint64_t id,
     const String path,
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
       auto filename = path.c_str();
-      auto desc =  new Descriptor(this->core, id);
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
+      auto ctx = this->readFileRequestContexts.acquire(nullptr, seq, cb);
       auto req = &ctx->req;
-      auto err = uv_fs_opendir(loop, req, filename, [](uv_fs_t *req) {
-        auto ctx = (RequestContext *) req->data;
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
 
-        if (req->result < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.opendir"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
+      ctx->fd = -1;
+      ctx->size = 0;
+      ctx->offset = 0;
+      ctx->post = Post {};
 
-          delete desc;
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.opendir"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)}
-            }}
-          };
+      auto err = uv_fs_open(loop, req, filename, UV_FS_O_RDONLY, 0, [](uv_fs_t* req) {
+        auto ctx = (ReadFileRequestContext *) req->data;
 
-          desc->dir = (uv_dir_t *) req->ptr;
-          // insert into `descriptors` map
-          Lock lock(desc->core->fs.mutex);
-          desc->core->fs.descriptors.insert_or_assign(desc->id, desc);
+        if (req->result < 0) {
+          return finishReadFile(ctx, getReadFileErrorJSON((int) req->result), Post{});
         }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->fd = (uv_file) req->result;
+        uv_fs_req_cleanup(req);
+
+        auto err = uv_fs_fstat(req->loop, req, ctx->fd, [](uv_fs_t* req) {
+          auto ctx = (ReadFileRequestContext *) req->data;
+
+          if (req->result < 0) {
+            return finishReadFile(ctx, getReadFileErrorJSON((int) req->result), Post{});
+          }
+
+          const auto stats = uv_fs_get_statbuf(req);
+          const auto isRegularFile = (stats->st_mode & S_IFMT) == S_IFREG;
+
+          if (isRegularFile) {
+            ctx->size = (size_t) stats->st_size;
+          }
+
+        #if !defined(_WIN32)
+          // the mapping is the response body, it is unmapped when the post
+          // is freed after the WebView has consumed it
+          if (ctx->size >= READ_FILE_MMAP_THRESHOLD && isReadFileMappingEnabled()) {
+            auto mapping = mmap(nullptr, ctx->size, PROT_READ, MAP_PRIVATE, ctx->fd, 0);
+
+            if (mapping != MAP_FAILED) {
+              ctx->post.body = (char *) mapping;
+              ctx->post.length = ctx->size;
+              ctx->post.deallocate = [](char* body, void* data) {
+                munmap(body, (size_t) reinterpret_cast<uintptr_t>(data));
+              };
+              ctx->post.deallocateData = reinterpret_cast<void*>((uintptr_t) ctx->size);
+              ctx->offset = ctx->size;
+              return replyReadFile(ctx);
+            }
+          }
+        #endif
+
+          // files without a size (pipes, or files in `/proc` that report 0)
+          // start with a chunk that grows until EOF
+          ctx->post.length = ctx->size > 0 ? ctx->size : READ_FILE_CHUNK_SIZE;
+          ctx->post.body = new char[ctx->post.length];
+          readFileChunk(ctx);
+        });
+
+        if (err < 0) {
+          finishReadFile(ctx, getReadFileErrorJSON(err), Post{});
+        }
       });
 
       if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.opendir"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(desc->id)},
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
-
-        ctx->cb(ctx->seq, json, Post{});
-        delete desc;
-        delete ctx;
+        finishReadFile(ctx, getReadFileErrorJSON(err), Post{});
       }
     });
   }
 
-  void Core::FS::readdir (
+  void Core::FS::write (
     const String seq,
     uint64_t id,
-    size_t nentries,
+    char *bytes,
+    size_t size,
+    size_t offset,
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
@@ -616,47 +2277,38 @@ namespace SSC {
 
       if (desc == nullptr) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.close"},
+          {"source", "fs.write"},
           {"err", JSON::Object::Entries {
             {"id", std::to_string(id)},
             {"code", "ENOTOPEN"},
             {"type", "NotFoundError"},
-            {"message", "No directory descriptor found with that id"}
+            {"message", "No file descriptor found with that id"}
           }}
         };
 
         return cb(seq, json, Post{});
       }
 
-      if (!desc->isDirectory()) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.close"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-            {"code", "ENOTOPEN"},
-            {"message", "No directory descriptor found with that id"}
-          }}
-        };
+      stopReadAhead(this, desc);
 
-        return cb(seq, json, Post{});
+      if (desc->writeBehind.size > 0 || desc->writeBehind.batches.size() > 0) {
+        const auto buffer = uv_buf_init(bytes, (unsigned int) size);
+        return holdWrite(this, desc, "fs.write", seq, cb, &buffer, 1, (int64_t) offset);
       }
 
-      Lock lock(desc->mutex);
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
-
-      desc->dir->dirents = ctx->dirents;
-      desc->dir->nentries = nentries;
+      auto ctx = this->bufferRequestContexts.acquire(desc, seq, cb);
+      auto req = &ctx->req;
 
-      auto err = uv_fs_readdir(loop, req, desc->dir, [](uv_fs_t *req) {
-        auto ctx = (RequestContext *) req->data;
+      ctx->setBuffer(size, bytes);
+      auto err = this->uring.write(loop, req, desc->fd, &ctx->buffer, 1, offset, [](uv_fs_t* req) {
+        auto ctx = static_cast<BufferRequestContext*>(req->data);
         auto desc = ctx->desc;
         auto json = JSON::Object {};
 
         if (req->result < 0) {
           json = JSON::Object::Entries {
-            {"source", "fs.readdir"},
+            {"source", "fs.write"},
             {"err", JSON::Object::Entries {
               {"id", std::to_string(desc->id)},
               {"code", req->result},
@@ -664,30 +2316,23 @@ namespace SSC {
             }}
           };
         } else {
-          Vector<JSON::Any> entries;
-
-          for (int i = 0; i < req->result; ++i) {
-            auto entry = JSON::Object::Entries {
-              {"type", desc->dir->dirents[i].type},
-              {"name", desc->dir->dirents[i].name}
-            };
-
-            entries.push_back(entry);
-          }
-
           json = JSON::Object::Entries {
-            {"source", "fs.readdir"},
-            {"data", entries}
+            {"source", "fs.write"},
+            {"data", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"result", req->result}
+            }}
           };
         }
 
+        desc->core->fs.stats.invalidate(desc->path);
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       });
 
       if (err < 0) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.readdir"},
+          {"source", "fs.write"},
           {"err", JSON::Object::Entries {
             {"id", std::to_string(desc->id)},
             {"code", err},
@@ -696,14 +2341,17 @@ namespace SSC {
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       }
     });
   }
 
-  void Core::FS::closedir (
+  void Core::FS::writev (
     const String seq,
     uint64_t id,
+    char *bytes,
+    const Vector<size_t> sizes,
+    size_t offset,
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
@@ -711,68 +2359,98 @@ namespace SSC {
 
       if (desc == nullptr) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.closedir"},
+          {"source", "fs.writev"},
           {"err", JSON::Object::Entries {
             {"id", std::to_string(id)},
             {"code", "ENOTOPEN"},
             {"type", "NotFoundError"},
-            {"message", "No directory descriptor found with that id"}
+            {"message", "No file descriptor found with that id"}
           }}
         };
 
         return cb(seq, json, Post{});
       }
 
-      if (!desc->isDirectory()) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.closedir"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-            {"code", "ENOTOPEN"},
-            {"message", "The descriptor found with was not a directory"}
-          }}
-        };
+      stopReadAhead(this, desc);
 
-        return cb(seq, json, Post{});
+      if (getVectoredBuffersSize(sizes) < 0) {
+        return cb(seq, getVectoredBuffersErrorJSON("fs.writev", id), Post{});
+      }
+
+      if (desc->writeBehind.size > 0 || desc->writeBehind.batches.size() > 0) {
+        Vector<uv_buf_t> buffers;
+        auto base = bytes;
+
+        for (const auto bufferSize : sizes) {
+          buffers.push_back(uv_buf_init(base, (unsigned int) bufferSize));
+          base += bufferSize;
+        }
+
+        return holdWrite(
+          this,
+          desc,
+          "fs.writev",
+          seq,
+          cb,
+          buffers.data(),
+          (unsigned int) buffers.size(),
+          (int64_t) offset
+        );
       }
 
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
+      auto ctx = this->vectoredRequestContexts.acquire(desc, seq, cb);
       auto req = &ctx->req;
-      auto err = uv_fs_closedir(loop, req, desc->dir, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
+      auto base = bytes;
+
+      // each buffer is the next `sizes[i]` bytes of `bytes`, which the
+      // route has checked add up to the size of the request body
+      ctx->buffers.clear();
+      for (const auto bufferSize : sizes) {
+        ctx->buffers.push_back(uv_buf_init(base, (unsigned int) bufferSize));
+        base += bufferSize;
+      }
 
-        if (req->result < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.closedir"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.closedir"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"fd", desc->fd}
-            }}
-          };
+      auto err = this->uring.write(
+        loop,
+        req,
+        desc->fd,
+        ctx->buffers.data(),
+        (unsigned int) ctx->buffers.size(),
+        offset,
+        [](uv_fs_t* req) {
+          auto ctx = static_cast<VectoredRequestContext*>(req->data);
+          auto desc = ctx->desc;
+          auto json = JSON::Object {};
+
+          if (req->result < 0) {
+            json = JSON::Object::Entries {
+              {"source", "fs.writev"},
+              {"err", JSON::Object::Entries {
+                {"id", std::to_string(desc->id)},
+                {"code", req->result},
+                {"message", String(uv_strerror((int) req->result))}
+              }}
+            };
+          } else {
+            json = JSON::Object::Entries {
+              {"source", "fs.writev"},
+              {"data", JSON::Object::Entries {
+                {"id", std::to_string(desc->id)},
+                {"result", req->result}
+              }}
+            };
+          }
 
-          desc->core->fs.removeDescriptor(desc->id);
-          delete desc;
+          desc->core->fs.stats.invalidate(desc->path);
+          ctx->cb(ctx->seq, json, Post{});
+          ctx->release();
         }
-
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      });
+      );
 
       if (err < 0) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.closedir"},
+          {"source", "fs.writev"},
           {"err", JSON::Object::Entries {
             {"id", std::to_string(desc->id)},
             {"code", err},
@@ -781,99 +2459,61 @@ namespace SSC {
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       }
     });
   }
 
-  void Core::FS::closeOpenDescriptor (
+  void Core::FS::setReadAhead (
     const String seq,
     uint64_t id,
+    size_t chunks,
     Module::Callback cb
   ) {
-    auto desc = getDescriptor(id);
-
-    if (desc == nullptr) {
-      auto json = JSON::Object::Entries {
-        {"source", "fs.closeOpenDescriptor"},
-        {"err", JSON::Object::Entries {
-          {"id", std::to_string(id)},
-          {"code", "ENOTOPEN"},
-          {"type", "NotFoundError"},
-          {"message", "No descriptor found with that id"}
-        }}
-      };
-
-      return cb(seq, json, Post{});
-    }
-
-    if (desc->isDirectory()) {
-      this->closedir(seq, id, cb);
-    } else if (desc->isFile()) {
-      this->close(seq, id, cb);
-    }
-  }
-
-  void Core::FS::closeOpenDescriptors (const String seq, Module::Callback cb) {
-    return this->closeOpenDescriptors(seq, false, cb);
-  }
-
-  void Core::FS::closeOpenDescriptors (
-    const String seq,
-    bool preserveRetained,
-    Module::Callback cb
-  ) {
-    Lock lock(this->mutex);
+    this->core->dispatchEventLoop([=, this]() {
+      auto desc = getDescriptor(id);
 
-    auto pending = descriptors.size();
-    int queued = 0;
-    auto json = JSON::Object {};
-    auto ids = Vector<uint64_t> {};
+      if (desc == nullptr) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.setReadAhead"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"type", "NotFoundError"},
+            {"message", "No file descriptor found with that id"}
+          }}
+        };
 
-    for (auto const &tuple : descriptors) {
-      ids.push_back(tuple.first);
-    }
+        return cb(seq, json, Post{});
+      }
 
-    for (auto const id : ids) {
-      auto desc = descriptors[id];
-      pending--;
+      const auto depth = std::min(chunks, READ_AHEAD_MAX_CHUNKS);
 
-      if (desc == nullptr) {
-        descriptors.erase(id);
-        continue;
+      // chunks read ahead until now are dropped when reads are no longer
+      // read ahead
+      if (depth == 0) {
+        stopReadAhead(this, desc);
       }
 
-      if (preserveRetained && desc->isRetained()) {
-        continue;
-      }
+      desc->readAhead.depth = depth;
 
-      if (desc->isDirectory()) {
-        queued++;
-        this->closedir(seq, id, [pending, cb](auto seq, auto json, auto post) {
-          if (pending == 0) {
-            cb(seq, json, post);
-          }
-        });
-      } else if (desc->isFile()) {
-        queued++;
-        this->close(seq, id, [pending, cb](auto seq, auto json, auto post) {
-          if (pending == 0) {
-            cb(seq, json, post);
-          }
-        });
-      }
-    }
+      auto json = JSON::Object::Entries {
+        {"source", "fs.setReadAhead"},
+        {"data", JSON::Object::Entries {
+          {"id", std::to_string(desc->id)},
+          {"chunks", depth}
+        }}
+      };
 
-    if (queued == 0) {
       cb(seq, json, Post{});
-    }
+    });
   }
 
-  void Core::FS::read (
+  void Core::FS::setWriteBehind (
     const String seq,
     uint64_t id,
     size_t size,
-    size_t offset,
+    uint64_t delay,
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
@@ -881,7 +2521,7 @@ namespace SSC {
 
       if (desc == nullptr) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.read"},
+          {"source", "fs.setWriteBehind"},
           {"err", JSON::Object::Entries {
             {"id", std::to_string(id)},
             {"code", "ENOTOPEN"},
@@ -893,72 +2533,107 @@ namespace SSC {
         return cb(seq, json, Post{});
       }
 
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
-      auto bytes = new char[size]{0};
+      desc->writeBehind.size = size;
+      desc->writeBehind.delay = delay;
 
-      ctx->setBuffer(0, size, bytes);
+      // writes held until now are written now when writes are no longer held
+      if (size == 0) {
+        flushWriteBehind(this, desc);
+      }
 
-      auto err = uv_fs_read(loop, req, desc->fd, ctx->iov, 1, offset, [](uv_fs_t* req) {
-        auto ctx = static_cast<RequestContext*>(req->data);
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
-        Post post = {0};
+      auto json = JSON::Object::Entries {
+        {"source", "fs.setWriteBehind"},
+        {"data", JSON::Object::Entries {
+          {"id", std::to_string(desc->id)},
+          {"size", size},
+          {"delay", delay}
+        }}
+      };
 
-        if (req->result < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.read"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
+      cb(seq, json, Post{});
+    });
+  }
 
-          auto bytes = ctx->getBuffer(0);
-          if (bytes != nullptr) {
-            delete [] bytes;
-          }
-        } else {
-          auto headers = Headers {{
-            {"content-type" ,"application/octet-stream"},
-            {"content-length", req->result}
-          }};
+  // replies to `fs.stat` with the result of `req`
+  static void replyStat (uv_fs_t *req) {
+    auto ctx = (Core::FS::StatRequestContext *) req->data;
+    auto json = getStatResultJSON("fs.stat", "fs.stat", (int) req->result, uv_fs_get_statbuf(req));
+    ctx->cb(ctx->seq, json, Post{});
+    ctx->release();
+  }
 
-          post.id = SSC::rand64();
-          post.body = ctx->getBuffer(0);
-          post.length = (int) req->result;
-          post.headers = headers.str();
-        }
+  void Core::FS::stat (
+    const String seq,
+    const String path,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      auto cached = this->stats.isEnabled() ? this->stats.get(path) : nullptr;
 
-        ctx->cb(ctx->seq, json, post);
-        delete ctx;
-      });
+      if (cached != nullptr && cached->stat.known) {
+        auto& result = cached->stat;
+        this->stats.hits++;
+        return cb(seq, getStatResultJSON("fs.stat", "fs.stat", result.err, &result.stat), Post{});
+      }
+
+      auto filename = path.c_str();
+      auto loop = &this->core->eventLoop;
+      auto ctx = this->statRequestContexts.acquire(nullptr, seq, cb);
+      auto req = &ctx->req;
+
+      prepareStatRequest(this, ctx, path, 0);
+
+      // with the cache the path is `lstat()`ed first, which is its `stat()`
+      // too unless it is a symbolic link, and only then is it followed
+      auto err = ctx->cache != nullptr
+        ? uv_fs_lstat(loop, req, filename, [](uv_fs_t *req) {
+            auto ctx = (StatRequestContext *) req->data;
+            auto result = (int) req->result;
+            auto stats = uv_fs_get_statbuf(req);
+            const auto isLink = isSymbolicLinkStat(result, stats);
+
+            if (isKeptStatResult(result)) {
+              ctx->cache->set(ctx->loop, ctx->path, ctx->generation, [&](auto& entry) {
+                entry.lstat = { true, result, *stats };
+
+                if (!isLink) {
+                  entry.stat = { true, result, *stats };
+                }
+              });
+            }
+
+            if (!isLink) {
+              return replyStat(req);
+            }
+
+            uv_fs_req_cleanup(req);
+            auto err = uv_fs_stat(ctx->loop, req, ctx->path.c_str(), replyStat);
+
+            if (err < 0) {
+              ctx->cb(ctx->seq, getStatResultJSON("fs.stat", "fs.stat", err, nullptr), Post{});
+              ctx->release();
+            }
+          })
+        : this->uring.stat(loop, req, filename, replyStat);
 
       if (err < 0) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.read"},
+          {"source", "fs.stat"},
           {"err", JSON::Object::Entries {
-            {"id", std::to_string(desc->id)},
             {"code", err},
             {"message", String(uv_strerror(err))}
           }}
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete [] bytes;
-        delete ctx;
+        ctx->release();
       }
     });
   }
 
-  void Core::FS::write (
+  void Core::FS::fstat (
     const String seq,
     uint64_t id,
-    char *bytes,
-    size_t size,
-    size_t offset,
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
@@ -966,7 +2641,7 @@ namespace SSC {
 
       if (desc == nullptr) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.write"},
+          {"source", "fs.fstat"},
           {"err", JSON::Object::Entries {
             {"id", std::to_string(id)},
             {"code", "ENOTOPEN"},
@@ -976,103 +2651,55 @@ namespace SSC {
         };
 
         return cb(seq, json, Post{});
-      }
-
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
-
-      ctx->setBuffer(0, (int) size, bytes);
-      auto err = uv_fs_write(loop, req, desc->fd, ctx->iov, 1, offset, [](uv_fs_t* req) {
-        auto ctx = static_cast<RequestContext*>(req->data);
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
-
-        if (req->result < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.write"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.write"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"result", req->result}
-            }}
-          };
-        }
-
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      });
-
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.write"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(desc->id)},
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+      }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+      // held writes are written first
+      if (afterWriteBehind(this, desc, [=, this]() { this->fstat(seq, id, cb); })) {
+        return;
       }
-    });
-  }
 
-  void Core::FS::stat (
-    const String seq,
-    const String path,
-    Module::Callback cb
-  ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto filename = path.c_str();
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = this->requestContexts.acquire(desc, seq, cb);
       auto req = &ctx->req;
-      auto err = uv_fs_stat(loop, req, filename, [](uv_fs_t *req) {
+      auto err = uv_fs_fstat(loop, req, desc->fd, [](uv_fs_t *req) {
         auto ctx = (RequestContext *) req->data;
-        auto json = JSON::Object {};
+        auto desc = ctx->desc;
+        JSON::Any json;
 
         if (req->result < 0) {
           json = JSON::Object::Entries {
-            {"source", "fs.stat"},
+            {"source", "fs.fstat"},
             {"err", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
               {"code", req->result},
               {"message", String(uv_strerror((int) req->result))}
             }}
           };
         } else {
-          json = getStatsJSON("fs.stat", uv_fs_get_statbuf(req));
+          json = getStatsJSON("fs.fstat", uv_fs_get_statbuf(req));
         }
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       });
 
       if (err < 0) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.stat"},
+          {"source", "fs.fstat"},
           {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
             {"code", err},
             {"message", String(uv_strerror(err))}
           }}
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       }
     });
   }
 
-  void Core::FS::fstat (
+  void Core::FS::fsync (
     const String seq,
     uint64_t id,
     Module::Callback cb
@@ -1082,7 +2709,7 @@ namespace SSC {
 
       if (desc == nullptr) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.fstat"},
+          {"source", "fs.fsync"},
           {"err", JSON::Object::Entries {
             {"id", std::to_string(id)},
             {"code", "ENOTOPEN"},
@@ -1094,17 +2721,22 @@ namespace SSC {
         return cb(seq, json, Post{});
       }
 
+      // held writes are written first
+      if (afterWriteBehind(this, desc, [=, this]() { this->fsync(seq, id, cb); })) {
+        return;
+      }
+
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
+      auto ctx = this->requestContexts.acquire(desc, seq, cb);
       auto req = &ctx->req;
-      auto err = uv_fs_fstat(loop, req, desc->fd, [](uv_fs_t *req) {
+      auto err = uv_fs_fsync(loop, req, desc->fd, [](uv_fs_t* req) {
         auto ctx = (RequestContext *) req->data;
         auto desc = ctx->desc;
         auto json = JSON::Object {};
 
         if (req->result < 0) {
           json = JSON::Object::Entries {
-            {"source", "fs.fstat"},
+            {"source", "fs.fsync"},
             {"err", JSON::Object::Entries {
               {"id", std::to_string(desc->id)},
               {"code", req->result},
@@ -1112,25 +2744,31 @@ namespace SSC {
             }}
           };
         } else {
-          json = getStatsJSON("fs.fstat", uv_fs_get_statbuf(req));
+          json = JSON::Object::Entries {
+            {"source", "fs.fsync"},
+            {"data", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"result", req->result}
+            }}
+          };
         }
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       });
 
       if (err < 0) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.fstat"},
+          {"source", "fs.fsync"},
           {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
+            {"id", std::to_string(desc->id)},
             {"code", err},
             {"message", String(uv_strerror(err))}
           }}
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       }
     });
   }
@@ -1142,10 +2780,8 @@ namespace SSC {
     Lock lock(this->mutex);
     auto entries = Vector<JSON::Any> {};
 
-    for (auto const &tuple : descriptors) {
-      auto desc = tuple.second;
-
-      if (!desc || (desc->isStale() && !desc->isRetained())) {
+    for (auto const desc : descriptors.slots) {
+      if (desc->isStale() && !desc->isRetained()) {
         continue;
       }
 
@@ -1172,28 +2808,35 @@ namespace SSC {
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
+      auto cached = this->stats.isEnabled() ? this->stats.get(path) : nullptr;
+
+      if (cached != nullptr && cached->lstat.known) {
+        auto& result = cached->lstat;
+        this->stats.hits++;
+        return cb(seq, getStatResultJSON("fs.lstat", "fs.stat", result.err, &result.stat), Post{});
+      }
+
       auto filename = path.c_str();
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = this->statRequestContexts.acquire(nullptr, seq, cb);
       auto req = &ctx->req;
-      auto err = uv_fs_lstat(loop, req, filename, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto json = JSON::Object {};
 
-        if (req->result < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.stat"},
-            {"err", JSON::Object::Entries {
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = getStatsJSON("fs.lstat", uv_fs_get_statbuf(req));
+      prepareStatRequest(this, ctx, path, 0);
+
+      auto err = uv_fs_lstat(loop, req, filename, [](uv_fs_t* req) {
+        auto ctx = (StatRequestContext *) req->data;
+        auto result = (int) req->result;
+        auto stats = uv_fs_get_statbuf(req);
+        auto json = getStatResultJSON("fs.lstat", "fs.stat", result, stats);
+
+        if (ctx->cache != nullptr && isKeptStatResult(result)) {
+          ctx->cache->set(ctx->loop, ctx->path, ctx->generation, [&](auto& entry) {
+            entry.lstat = { true, result, *stats };
+          });
         }
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       });
 
       if (err < 0) {
@@ -1206,7 +2849,7 @@ namespace SSC {
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       }
     });
   }
@@ -1219,10 +2862,13 @@ namespace SSC {
     this->core->dispatchEventLoop([=, this]() {
       auto filename = path.c_str();
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = this->statRequestContexts.acquire(nullptr, seq, cb);
       auto req = &ctx->req;
+
+      prepareStatChange(this, ctx, path);
+
       auto err = uv_fs_unlink(loop, req, filename, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
+        auto ctx = (StatRequestContext *) req->data;
         auto json = JSON::Object {};
 
         if (req->result < 0) {
@@ -1242,8 +2888,9 @@ namespace SSC {
           };
         }
 
+        invalidateStats(ctx);
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       });
 
       if (err < 0) {
@@ -1256,8 +2903,455 @@ namespace SSC {
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
+      }
+    });
+  }
+
+  void Core::FS::unwatch (const String seq, uint64_t id, Module::Callback cb) {
+    this->core->dispatchEventLoop([=, this]() {
+      const auto entry = this->watchers.find(id);
+
+      if (entry == this->watchers.end()) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.unwatch"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTWATCHING"},
+            {"type", "NotFoundError"},
+            {"message", "No watcher found with that id"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      // changes not delivered yet are delivered before the watcher closes
+      entry->second->flush();
+      entry->second->close();
+      this->watchers.erase(entry);
+
+      auto json = JSON::Object::Entries {
+        {"source", "fs.unwatch"},
+        {"data", JSON::Object::Entries {
+          {"id", std::to_string(id)}
+        }}
+      };
+
+      cb(seq, json, Post{});
+    });
+  }
+
+  void Core::FS::watch (
+    const String seq,
+    uint64_t id,
+    const String path,
+    bool recursive,
+    uint64_t window,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      if (this->watchers.contains(id)) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.watch"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "EEXIST"},
+            {"type", "InternalError"},
+            {"message", "A watcher with that id already exists"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      auto loop = &this->core->eventLoop;
+      auto watcher = new Watcher(this, loop, id, path, recursive, window, cb);
+      auto err = watcher->start([=]() {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.watch"},
+          {"data", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"path", path},
+            {"recursive", recursive},
+            {"window", window}
+          }}
+        };
+
+        cb(seq, json, Post{});
+      });
+
+      if (err < 0) {
+        watcher->close();
+
+        auto json = JSON::Object::Entries {
+          {"source", "fs.watch"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      this->watchers[id] = watcher;
+    });
+  }
+
+  // an entry given by `walk()`, `name` is relative to the walked path
+  struct WalkEntryJSON {
+    std::string_view name;
+    int type;
+
+    using Shape = JSON::Shape<
+      JSON::Field<"name", &WalkEntryJSON::name>,
+      JSON::Field<"type", &WalkEntryJSON::type>
+    >;
+  };
+
+  struct WalkStatEntryJSON {
+    std::string_view name;
+    int type;
+    StatsJSON stat;
+
+    using Shape = JSON::Shape<
+      JSON::Field<"name", &WalkStatEntryJSON::name>,
+      JSON::Field<"type", &WalkStatEntryJSON::type>,
+      JSON::Field<"stat", &WalkStatEntryJSON::stat>
+    >;
+  };
+
+  static bool matchGlob (std::string_view glob, std::string_view path) {
+    while (glob.size() > 0) {
+      const auto c = glob[0];
+
+      if (c == '*') {
+        const auto globstar = glob.size() > 1 && glob[1] == '*';
+        const auto rest = glob.substr(globstar ? 2 : 1);
+
+        // `**/` matches no directories too
+        if (globstar && rest.starts_with("/") && matchGlob(rest.substr(1), path)) {
+          return true;
+        }
+
+        for (size_t i = 0; i <= path.size(); ++i) {
+          if (matchGlob(rest, path.substr(i))) {
+            return true;
+          }
+
+          if (i < path.size() && path[i] == '/' && !globstar) {
+            return false;
+          }
+        }
+
+        return false;
+      }
+
+      if (path.size() == 0) {
+        return false;
+      }
+
+      if (c == '?') {
+        if (path[0] == '/') {
+          return false;
+        }
+      } else if (c == '[' && glob.find(']', 1) != std::string_view::npos) {
+        const auto end = glob.find(']', 1);
+        const auto negated = glob[1] == '!' || glob[1] == '^';
+        auto matched = false;
+
+        for (size_t i = negated ? 2 : 1; i < end; ++i) {
+          if (i + 2 < end && glob[i + 1] == '-') {
+            matched = matched || (path[0] >= glob[i] && path[0] <= glob[i + 2]);
+            i += 2;
+          } else {
+            matched = matched || path[0] == glob[i];
+          }
+        }
+
+        if (matched == negated || path[0] == '/') {
+          return false;
+        }
+
+        glob = glob.substr(end);
+      } else if (c == '\\' && glob.size() > 1) {
+        if (path[0] != glob[1]) {
+          return false;
+        }
+
+        glob = glob.substr(1);
+      } else if (c != path[0]) {
+        return false;
+      }
+
+      glob = glob.substr(1);
+      path = path.substr(1);
+    }
+
+    return path.size() == 0;
+  }
+
+  // whether `path` matches `glob`, where `*` and `?` match within a path
+  // segment, `**` matches any number of segments and `[...]` matches a
+  // character class. Like a `.gitignore` pattern, a glob without a `/` is
+  // matched against the last segment of `path`
+  static bool matchesGlob (const String& glob, const String& path) {
+    if (glob.find('/') == String::npos) {
+      const auto slash = path.rfind('/');
+      return matchGlob(
+        glob,
+        slash == String::npos ? std::string_view(path) : std::string_view(path).substr(slash + 1)
+      );
+    }
+
+    return matchGlob(
+      glob.starts_with("/") ? std::string_view(glob).substr(1) : std::string_view(glob),
+      path
+    );
+  }
+
+  static bool matchesAnyGlob (const Vector<String>& globs, const String& path) {
+    for (const auto& glob : globs) {
+      if (matchesGlob(glob, path)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // reads `directory` and writes the JSON of its entries, on the threadpool
+  static void readWalkDirectory (Core::FS::Walk::Directory *directory) {
+    const auto walk = directory->walk;
+    const auto& options = walk->options;
+    const auto target = directory->path.size() > 0
+      ? walk->path + "/" + directory->path
+      : walk->path;
+
+    uv_fs_t req;
+    auto result = uv_fs_scandir(nullptr, &req, target.c_str(), 0, nullptr);
+
+    if (result < 0) {
+      directory->err = result;
+      uv_fs_req_cleanup(&req);
+      return;
+    }
+
+    uv_dirent_t dirent;
+
+    while (uv_fs_scandir_next(&req, &dirent) != UV_EOF) {
+      const auto name = directory->path.size() > 0
+        ? directory->path + "/" + dirent.name
+        : String(dirent.name);
+
+      if (matchesAnyGlob(options.ignore, name)) {
+        continue;
+      }
+
+      auto type = (int) dirent.type;
+      auto hasStat = false;
+      uv_fs_t stat;
+
+      // some file systems do not give the type of an entry
+      if (options.stat || type == UV_DIRENT_UNKNOWN) {
+        const auto path = target + "/" + dirent.name;
+        hasStat = uv_fs_lstat(nullptr, &stat, path.c_str(), nullptr) == 0;
+        uv_fs_req_cleanup(&stat);
+
+        if (hasStat && type == UV_DIRENT_UNKNOWN) {
+          const auto mode = stat.statbuf.st_mode & S_IFMT;
+          if (mode == S_IFDIR) type = UV_DIRENT_DIR;
+          else if (mode == S_IFREG) type = UV_DIRENT_FILE;
+        #if defined(S_IFLNK)
+          else if (mode == S_IFLNK) type = UV_DIRENT_LINK;
+        #endif
+        }
+      }
+
+      if (
+        type == UV_DIRENT_DIR &&
+        (options.depth < 0 || directory->depth < options.depth)
+      ) {
+        directory->directories.push_back(name);
+      }
+
+      if (options.include.size() > 0 && !matchesAnyGlob(options.include, name)) {
+        continue;
+      }
+
+      if (directory->entries++ > 0) {
+        directory->output.push_back(',');
+      }
+
+      if (options.stat && hasStat) {
+        JSON::write(directory->output, WalkStatEntryJSON { name, type, toStatsJSON(&stat.statbuf) });
+      } else {
+        JSON::write(directory->output, WalkEntryJSON { name, type });
+      }
+    }
+
+    uv_fs_req_cleanup(&req);
+  }
+
+  // gives the entries joined so far to `walk->cb` in a post
+  static void sendWalkEntries (Core::FS::Walk *walk) {
+    if (walk->outputEntries == 0) {
+      return;
+    }
+
+    // the post owns the joined entries, they are not copied
+    auto body = new String(std::move(walk->output));
+    body->push_back(']');
+
+    auto headers = Headers {{
+      {"content-type", "application/json"},
+      {"content-length", body->size()}
+    }};
+
+    Post post;
+    post.id = rand64();
+    post.body = body->data();
+    post.length = body->size();
+    post.headers = headers.str();
+    post.deallocateData = (void *) body;
+    post.deallocate = [](char *bytes, void *data) {
+      delete (String *) data;
+    };
+
+    auto json = JSON::Object::Entries {
+      {"source", "fs.walk"},
+      {"data", JSON::Object::Entries {
+        {"id", std::to_string(walk->id)},
+        {"entries", walk->outputEntries}
+      }}
+    };
+
+    walk->output = String();
+    walk->outputEntries = 0;
+    walk->batches++;
+    walk->cb("-1", json, post);
+  }
+
+  static void readWalkDirectories (Core::FS::Walk *walk) {
+    while (walk->reading < Core::FS::WALK_CONCURRENCY && walk->queue.size() > 0) {
+      auto directory = walk->queue.front();
+      walk->queue.pop_front();
+      walk->reading++;
+
+      uv_queue_work(
+        walk->loop,
+        &directory->req,
+        [](uv_work_t *req) {
+          readWalkDirectory((Core::FS::Walk::Directory *) req->data);
+        },
+        [](uv_work_t *req, int status) {
+          auto directory = (Core::FS::Walk::Directory *) req->data;
+          auto walk = directory->walk;
+
+          walk->reading--;
+          walk->directories++;
+          walk->fs->walkDirectories++;
+
+          if (directory->err < 0 && directory->path.size() == 0) {
+            walk->err = directory->err;
+          } else if (directory->err < 0) {
+            walk->errors++;
+          }
+
+          if (directory->entries > 0) {
+            walk->output.push_back(walk->outputEntries == 0 ? '[' : ',');
+            walk->output.append(directory->output);
+            walk->outputEntries += directory->entries;
+            walk->entries += directory->entries;
+          }
+
+          for (const auto& path : directory->directories) {
+            auto next = new Core::FS::Walk::Directory();
+            next->walk = walk;
+            next->path = path;
+            next->depth = directory->depth + 1;
+            next->req.data = (void *) next;
+            walk->queue.push_back(next);
+          }
+
+          delete directory;
+
+          if (walk->outputEntries >= Core::FS::WALK_BATCH_ENTRIES) {
+            sendWalkEntries(walk);
+          }
+
+          readWalkDirectories(walk);
+        }
+      );
+    }
+
+    if (walk->reading > 0) {
+      return;
+    }
+
+    sendWalkEntries(walk);
+
+    auto json = JSON::Object {};
+
+    if (walk->err < 0) {
+      json = JSON::Object::Entries {
+        {"source", "fs.walk"},
+        {"err", JSON::Object::Entries {
+          {"id", std::to_string(walk->id)},
+          {"code", walk->err},
+          {"message", String(uv_strerror(walk->err))}
+        }}
+      };
+    } else {
+      json = JSON::Object::Entries {
+        {"source", "fs.walk"},
+        {"data", JSON::Object::Entries {
+          {"id", std::to_string(walk->id)},
+          {"entries", walk->entries},
+          {"directories", walk->directories},
+          {"batches", walk->batches},
+          {"errors", walk->errors},
+          {"elapsed", (uv_hrtime() - walk->startedAt) / 1000000}
+        }}
+      };
+    }
+
+    walk->cb(walk->seq, json, Post{});
+    delete walk;
+  }
+
+  void Core::FS::walk (
+    const String seq,
+    uint64_t id,
+    const String path,
+    const WalkOptions options,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      auto walk = new Walk();
+      auto directory = new Walk::Directory();
+
+      walk->fs = this;
+      walk->loop = &this->core->eventLoop;
+      walk->id = id;
+      walk->seq = seq;
+      walk->path = path;
+      walk->options = options;
+      walk->cb = cb;
+      walk->startedAt = uv_hrtime();
+
+      while (walk->path.size() > 1 && walk->path.ends_with("/")) {
+        walk->path.pop_back();
       }
+
+      directory->walk = walk;
+      directory->req.data = (void *) directory;
+      walk->queue.push_back(directory);
+
+      this->walks++;
+      readWalkDirectories(walk);
     });
   }
 
@@ -1269,12 +3363,15 @@ namespace SSC {
   ) {
     this->core->dispatchEventLoop([=, this]() {
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = this->statRequestContexts.acquire(nullptr, seq, cb);
       auto req = &ctx->req;
       auto src = pathA.c_str();
       auto dst = pathB.c_str();
+
+      prepareStatChange(this, ctx, pathA, pathB);
+
       auto err = uv_fs_rename(loop, req, src, dst, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
+        auto ctx = (StatRequestContext *) req->data;
         auto json = JSON::Object {};
 
         if (req->result < 0) {
@@ -1294,8 +3391,9 @@ namespace SSC {
           };
         }
 
+        invalidateStats(ctx);
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       });
 
       if (err < 0) {
@@ -1308,7 +3406,7 @@ namespace SSC {
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       }
     });
   }
@@ -1322,12 +3420,15 @@ namespace SSC {
   ) {
     this->core->dispatchEventLoop([=, this]() {
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = this->statRequestContexts.acquire(nullptr, seq, cb);
       auto req = &ctx->req;
       auto src = pathA.c_str();
       auto dst = pathB.c_str();
+
+      prepareStatChange(this, ctx, pathB);
+
       auto err = uv_fs_copyfile(loop, req, src, dst, flags, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
+        auto ctx = (StatRequestContext *) req->data;
         auto json = JSON::Object {};
 
         if (req->result < 0) {
@@ -1347,8 +3448,9 @@ namespace SSC {
           };
         }
 
+        invalidateStats(ctx);
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       });
 
       if (err < 0) {
@@ -1361,7 +3463,7 @@ namespace SSC {
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       }
     });
   }
@@ -1374,10 +3476,13 @@ namespace SSC {
     this->core->dispatchEventLoop([=, this]() {
       auto filename = path.c_str();
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = this->statRequestContexts.acquire(nullptr, seq, cb);
       auto req = &ctx->req;
+
+      prepareStatChange(this, ctx, path);
+
       auto err = uv_fs_rmdir(loop, req, filename, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
+        auto ctx = (StatRequestContext *) req->data;
         auto json = JSON::Object {};
 
         if (req->result < 0) {
@@ -1397,8 +3502,9 @@ namespace SSC {
           };
         }
 
+        invalidateStats(ctx);
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       });
 
       if (err < 0) {
@@ -1411,7 +3517,7 @@ namespace SSC {
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       }
     });
   }
@@ -1425,10 +3531,13 @@ namespace SSC {
     this->core->dispatchEventLoop([=, this]() {
       auto filename = path.c_str();
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = this->statRequestContexts.acquire(nullptr, seq, cb);
       auto req = &ctx->req;
+
+      prepareStatChange(this, ctx, path);
+
       auto err = uv_fs_mkdir(loop, req, filename, mode, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
+        auto ctx = (StatRequestContext *) req->data;
         auto json = JSON::Object {};
 
         if (req->result < 0) {
@@ -1448,8 +3557,9 @@ namespace SSC {
           };
         }
 
+        invalidateStats(ctx);
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       });
 
       if (err < 0) {
@@ -1462,7 +3572,7 @@ namespace SSC {
         };
 
         ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+        ctx->release();
       }
     });
   }
@@ -1489,4 +3599,71 @@ namespace SSC {
 
     cb(seq, json, post);
   }
+
+  void Core::FS::diagnostics (const String seq, Module::Callback cb) {
+    this->core->dispatchEventLoop([=, this]() {
+      JSON::Object contexts;
+      const auto pools = Vector<std::pair<String, RequestContextPool*>> {
+        {"path", &this->requestContexts},
+        {"buffer", &this->bufferRequestContexts},
+        {"directory", &this->directoryRequestContexts},
+        {"readFile", &this->readFileRequestContexts},
+        {"vectored", &this->vectoredRequestContexts},
+        {"stat", &this->statRequestContexts}
+      };
+
+      for (const auto& entry : pools) {
+        contexts[entry.first] = JSON::Object::Entries {
+          {"allocations", entry.second->allocations},
+          {"reuses", entry.second->reuses},
+          {"free", entry.second->contexts.size()}
+        };
+      }
+
+      JSON::Array watchers;
+
+      for (const auto& entry : this->watchers) {
+        watchers.push(entry.second->json());
+      }
+
+      JSON::Object descriptors;
+
+      do {
+        Lock lock(this->mutex);
+        descriptors = this->descriptors.json();
+      } while (0);
+
+      auto json = JSON::Object::Entries {
+        {"source", "diagnostics.fs"},
+        {"data", JSON::Object::Entries {
+          {"buffers", this->buffers.json()},
+          {"contexts", contexts},
+          {"descriptors", descriptors},
+          {"statCache", this->stats.json()},
+          {"uring", this->uring.json()},
+          {"readAhead", JSON::Object::Entries {
+            {"prefetches", this->readAheadPrefetches},
+            {"hits", this->readAheadHits},
+            {"discards", this->readAheadDiscards},
+            {"stale", this->readAheadStale}
+          }},
+          {"writeBehind", JSON::Object::Entries {
+            {"writes", this->writeBehindWrites},
+            {"flushes", this->writeBehindFlushes}
+          }},
+          {"watch", JSON::Object::Entries {
+            {"watchers", watchers},
+            {"events", this->watchEvents},
+            {"batches", this->watchBatches}
+          }},
+          {"walk", JSON::Object::Entries {
+            {"walks", this->walks},
+            {"directories", this->walkDirectories}
+          }}
+        }}
+      };
+
+      cb(seq, json, Post{});
+    });
+  }
 }
@@ -32,11 +32,12 @@ namespace SSC {
     return getEmitToRenderProcessJavaScript(event, value, "window", JSON::Object {});
   }
 
-  String getEmitToRenderProcessJavaScript (
+  static String createEmitToRenderProcessJavaScript (
     const String& event,
     const String& value,
     const String& target,
-    const JSON::Object& options
+    const JSON::Object& options,
+    bool decode
   ) {
     return createJavaScript("emit-to-render-process.js",
       "const name = decodeURIComponent(`" + event + "`);                   \n"
@@ -47,7 +48,10 @@ namespace SSC {
       "                                                                    \n"
       "if (typeof value === 'string') {                                    \n"
       "  try {                                                             \n"
-      "    detail = decodeURIComponent(value);                             \n"
+      + String(decode
+        ? "    detail = decodeURIComponent(value);                         \n"
+        : ""
+      ) +
       "    detail = JSON.parse(detail);                                    \n"
       "  } catch (err) {                                                   \n"
       "    if (!detail) {                                                  \n"
@@ -62,6 +66,28 @@ namespace SSC {
     );
   }
 
+  String getEmitToRenderProcessJavaScript (
+    const String& event,
+    const String& value,
+    const String& target,
+    const JSON::Object& options
+  ) {
+    return createEmitToRenderProcessJavaScript(event, value, target, options, true);
+  }
+
+  String getEmitJSONToRenderProcessJavaScript (
+    const String& event,
+    const String& json
+  ) {
+    return createEmitToRenderProcessJavaScript(
+      event,
+      encodeTemplateLiteral(json),
+      "window",
+      JSON::Object {},
+      false
+    );
+  }
+
   String getResolveMenuSelectionJavaScript (
     const String& seq,
     const String& title,
@@ -88,14 +114,20 @@ namespace SSC {
     );
   }
 
-  String getResolveToRenderProcessJavaScript (
+  // `value` is either percent-encoded (`decode`) or escaped with
+  // `encodeTemplateLiteral()`, in which case it is only parsed
+  static String createResolveToRenderProcessJavaScript (
     const String& seq,
     const String& state,
-    const String& value
+    const String& value,
+    bool decode
   ) {
+    // callers of `getResolveToRenderProcessJavaScript()` may pass JSON
+    // that is not percent-encoded, which has always been quoted with '
+    const auto quote = String(decode ? "'" : "`");
     return createJavaScript("resolve-to-render-process.js",
       "const seq = String('" + seq + "');                    \n"
-      "const value = '" + value + "';                        \n"
+      "const value = " + quote + value + quote + ";          \n"
       "const index = globalThis.__args.index;                    \n"
       "const state = Number('" + state + "');                \n"
       "const eventName = `resolve-${index}-${seq}`;          \n"
@@ -103,7 +135,10 @@ namespace SSC {
       "                                                      \n"
       "if (typeof value === 'string') {                      \n"
       "  try {                                               \n"
-      "    detail = decodeURIComponent(value);               \n"
+      + String(decode
+        ? "    detail = decodeURIComponent(value);             \n"
+        : ""
+      ) +
       "    detail = JSON.parse(detail);                      \n"
       "  } catch (err) {                                     \n"
       "    if (!detail) {                                    \n"
@@ -130,4 +165,25 @@ namespace SSC {
       "globalThis.dispatchEvent(event);                          \n"
     );
   }
+
+  String getResolveToRenderProcessJavaScript (
+    const String& seq,
+    const String& state,
+    const String& value
+  ) {
+    return createResolveToRenderProcessJavaScript(seq, state, value, true);
+  }
+
+  String getResolveJSONToRenderProcessJavaScript (
+    const String& seq,
+    const String& state,
+    const String& json
+  ) {
+    return createResolveToRenderProcessJavaScript(
+      seq,
+      state,
+      encodeTemplateLiteral(json),
+      false
+    );
+  }
 }
@@ -1,5 +1,11 @@
 #include "json.hh"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace SSC::JSON {
   Null null;
   Any anyNull = nullptr;
@@ -8,190 +14,963 @@ namespace SSC::JSON {
     this->data = std::stod(string.str());
   }
 
-  std::string Number::str () const {
-    if (this->data == 0) {
-      return "0";
+  // Writes the shortest decimal representation of `value` that reads back
+  // as the same double to `buffer` and returns its length. There is no JSON
+  // representation of NaN or infinity so, like `JSON.stringify()`, they are
+  // written as `null`.
+  static size_t formatNumber (char* buffer, size_t size, double value) {
+    if (!std::isfinite(value)) {
+      std::memcpy(buffer, "null", 4);
+      return 4;
     }
 
-    auto value = this->data;
-    auto output = std::to_string(value);
-    auto decimal = output.find(".");
+    // integers (the common case for sizes, ids and timestamps) that are
+    // exactly representable skip the floating point formatting
+    if (
+      value > -9007199254740992.0 &&
+      value < 9007199254740992.0 &&
+      value == (double) (int64_t) value
+    ) {
+      return std::to_chars(buffer, buffer + size, (int64_t) value).ptr - buffer;
+    }
 
-    // trim trailing zeros
-    if (decimal >= 0) {
-      auto i = output.size() - 1;
-      while (output[i] == '0' && i >= decimal) {
-        i--;
+  #if defined(__cpp_lib_to_chars)
+    return std::to_chars(buffer, buffer + size, value).ptr - buffer;
+  #else
+    // the fewest significant digits, from 15 to 17, that round trip
+    int length = 0;
+    for (int precision = 15; precision <= 17; ++precision) {
+      length = std::snprintf(buffer, size, "%.*g", precision, value);
+      if (std::strtod(buffer, nullptr) == value) {
+        break;
       }
+    }
 
-      return output.substr(0, i);
+    // `%g` uses the decimal separator of the current locale
+    for (int i = 0; i < length; ++i) {
+      if (buffer[i] == ',') {
+        buffer[i] = '.';
+      }
     }
 
-    return output;
+    return length;
+  #endif
+  }
+
+  std::string Number::str () const {
+    char buffer[32];
+    const auto length = formatNumber(buffer, sizeof(buffer), this->data);
+    return std::string(buffer, length);
   }
 
   std::string Object::str () const {
-    std::stringstream stream;
-    auto count = this->data.size();
-    stream << std::string("{");
-    for (const auto& tuple : this->data) {
-      auto key = replace(tuple.first, "\"","\\\"");
-      auto value = tuple.second.str();
+    std::string output;
+    write(output, *this);
+    return output;
+  }
 
-      stream << std::string("\"");
-      stream << key;
-      stream << std::string("\":");
-      stream << value;
+  std::string Array::str () const {
+    std::string output;
+    write(output, *this);
+    return output;
+  }
 
-      if (--count > 0) {
-        stream << std::string(",");
-      }
+  std::string String::str () const {
+    std::string output;
+    output.reserve(this->data.size() + 2);
+    writeString(output, this->data);
+    return output;
+  }
+
+  String::String (const Number& number) {
+    this->data = number.str();
+  }
+
+  static thread_local Arena::Scope* currentArenaScope = nullptr;
+
+  Arena::Scope::Scope () {
+    this->previous = currentArenaScope;
+    currentArenaScope = this;
+  }
+
+  Arena::Scope::~Scope () {
+    currentArenaScope = this->previous;
+
+    if (this->arena != nullptr) {
+      this->arena->release();
+    }
+  }
+
+  Arena* Arena::current () {
+    auto scope = currentArenaScope;
+
+    if (scope == nullptr) {
+      return nullptr;
     }
 
-    stream << std::string("}");
-    return stream.str();
+    if (scope->arena == nullptr) {
+      scope->arena = new Arena();
+    }
+
+    return scope->arena;
   }
 
-  std::string Array::str () const {
-    std::stringstream stream;
-    auto count = this->data.size();
-    stream << std::string("[");
+  Arena::~Arena () {
+    auto block = this->blocks;
 
-    for (const auto& value : this->data) {
-      stream << value.str();
+    while (block != nullptr) {
+      auto next = block->next;
+      std::free(block);
+      block = next;
+    }
+  }
+
+  void* Arena::allocate (size_t size, size_t alignment) {
+    static constexpr auto header = (sizeof(Block) + alignof(std::max_align_t) - 1)
+      & ~(alignof(std::max_align_t) - 1);
 
-      if (--count > 0) {
-        stream << std::string(",");
+    auto block = this->blocks;
+
+    if (block != nullptr) {
+      const auto offset = (block->used + alignment - 1) & ~(alignment - 1);
+
+      if (offset + size <= block->size) {
+        block->used = offset + size;
+        this->allocations++;
+        this->bytes += size;
+        return reinterpret_cast<char*>(block) + header + offset;
       }
     }
 
-    stream << std::string("]");
-    return stream.str();
+    // blocks double in size up to `MAX_BLOCK_SIZE`, larger nodes get a
+    // block of their own
+    auto capacity = block != nullptr
+      ? std::min(block->size * 2, MAX_BLOCK_SIZE)
+      : BLOCK_SIZE;
+
+    if (size + alignment > capacity) {
+      capacity = size + alignment;
+    }
+
+    auto memory = std::malloc(header + capacity);
+
+    if (memory == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    block = new (memory) Block();
+    block->size = capacity;
+    block->next = this->blocks;
+    this->blocks = block;
+
+    return this->allocate(size, alignment);
   }
 
-  String::String (const Number& number) {
-    this->data = number.str();
+  void Arena::retain () {
+    this->references.fetch_add(1, std::memory_order_relaxed);
   }
 
-  Any::Any (const Null null) {
-    this->pointer = std::shared_ptr<void>(new Null());
-    this->type = Type::Null;
+  void Arena::release () {
+    if (this->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
   }
 
-  Any::Any (std::nullptr_t) {
-    this->pointer = std::shared_ptr<void>(new Null());
-    this->type = Type::Null;
+  template <typename T, typename... Args>
+  static Node* createNode (Args&&... args) {
+    auto arena = Arena::current();
+
+    if (arena == nullptr) {
+      auto node = new ValueNode<T>(std::forward<Args>(args)...);
+      return &node->node;
+    }
+
+    auto memory = arena->allocate(sizeof(ValueNode<T>), alignof(ValueNode<T>));
+    auto node = new (memory) ValueNode<T>(std::forward<Args>(args)...);
+    node->node.arena = arena;
+    arena->retain();
+    return &node->node;
   }
 
-  Any::Any (const char *string) {
-    this->pointer = std::shared_ptr<void>(new String(string));
-    this->type = Type::String;
+  template <typename T> static void destroyNode (Node* pointer) {
+    auto node = reinterpret_cast<ValueNode<T>*>(pointer);
+    auto arena = pointer->arena;
+
+    if (arena == nullptr) {
+      delete node;
+    } else {
+      node->~ValueNode<T>();
+      arena->release();
+    }
   }
 
-  Any::Any (const char string) {
-    this->pointer = std::shared_ptr<void>(new String(string));
-    this->type = Type::String;
+  void Any::release () {
+    if (!this->hasNode()) {
+      return;
+    }
+
+    auto node = this->data.node;
+
+    if (node->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+
+    switch (this->type) {
+      case Type::Object: destroyNode<Object>(node); break;
+      case Type::Array: destroyNode<Array>(node); break;
+      case Type::Raw: destroyNode<Raw>(node); break;
+      case Type::String: destroyNode<String>(node); break;
+      default: break;
+    }
   }
 
-  Any::Any (const std::string string) {
-    this->pointer = std::shared_ptr<void>(new String(string));
+  void Any::setString (const char* bytes, size_t size) {
     this->type = Type::String;
+
+    if (size <= SMALL_STRING_SIZE) {
+      if (size > 0) {
+        std::memcpy(this->data.string.bytes, bytes, size);
+      }
+
+      this->data.string.size = (unsigned char) size;
+    } else {
+      this->data.node = createNode<String>(std::string(bytes, size));
+      this->data.string.size = NODE_STRING;
+    }
   }
 
-  Any::Any (const String string) {
-    this->pointer = std::shared_ptr<void>(new String(string));
-    this->type = Type::String;
+  std::string_view Any::stringView () const {
+    if (this->type != Type::String) {
+      return std::string_view();
+    }
+
+    if (this->data.string.size == NODE_STRING) {
+      return reinterpret_cast<ValueNode<String>*>(this->data.node)->value.data;
+    }
+
+    return std::string_view(this->data.string.bytes, this->data.string.size);
   }
 
-  Any::Any (bool boolean) {
-    this->pointer = std::shared_ptr<void>(new Boolean(boolean));
-    this->type = Type::Boolean;
+  Any::Any (const Any& any) {
+    this->type = any.type;
+    this->data = any.data;
+
+    if (this->hasNode()) {
+      this->data.node->references.fetch_add(1, std::memory_order_relaxed);
+    }
   }
 
-  Any::Any (const Boolean boolean) {
-    this->pointer = std::shared_ptr<void>(new Boolean(boolean));
-    this->type = Type::Boolean;
+  Any::Any (Any&& any) noexcept {
+    this->type = any.type;
+    this->data = any.data;
+    any.type = Type::Null;
   }
 
-  Any::Any (int32_t number) {
-    this->pointer = std::shared_ptr<void>(new Number((double) number));
-    this->type = Type::Number;
+  Any::~Any () {
+    this->release();
   }
 
-  Any::Any (uint32_t number) {
-    this->pointer = std::shared_ptr<void>(new Number((double) number));
-    this->type = Type::Number;
+  // `any` may be a value nested in the node this value releases, so it is
+  // read before the release in both assignments
+  Any& Any::operator= (const Any& any) {
+    if (this != &any) {
+      const auto type = any.type;
+      const auto data = any.data;
+
+      if (any.hasNode()) {
+        any.data.node->references.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      this->release();
+      this->type = type;
+      this->data = data;
+    }
+
+    return *this;
   }
 
-  Any::Any (int64_t number) {
-    this->pointer = std::shared_ptr<void>(new Number((double) number));
-    this->type = Type::Number;
+  Any& Any::operator= (Any&& any) noexcept {
+    if (this != &any) {
+      const auto type = any.type;
+      const auto data = any.data;
+
+      any.type = Type::Null;
+      this->release();
+      this->type = type;
+      this->data = data;
+    }
+
+    return *this;
   }
 
-  Any::Any (uint64_t number) {
-    this->pointer = std::shared_ptr<void>(new Number((double) number));
-    this->type = Type::Number;
+  Any::Any (const Null null) : Any() {}
+  Any::Any (std::nullptr_t) : Any() {}
+
+  Any::Any (const char *string) {
+    this->setString(string, std::strlen(string));
   }
 
+  Any::Any (const char string) {
+    this->setString(&string, 1);
+  }
+
+  Any::Any (const std::string& string) {
+    this->setString(string.data(), string.size());
+  }
+
+  Any::Any (std::string&& string) {
+    if (string.size() <= SMALL_STRING_SIZE) {
+      this->setString(string.data(), string.size());
+    } else {
+      this->type = Type::String;
+      this->data.node = createNode<String>(std::move(string));
+      this->data.string.size = NODE_STRING;
+    }
+  }
+
+  Any::Any (const String& string) {
+    this->setString(string.data.data(), string.data.size());
+  }
+
+  Any::Any (bool boolean) {
+    this->type = Type::Boolean;
+    this->data.boolean = boolean;
+  }
+
+  Any::Any (const Boolean& boolean) : Any(boolean.data) {}
+  Any::Any (int32_t number) : Any((double) number) {}
+  Any::Any (uint32_t number) : Any((double) number) {}
+  Any::Any (int64_t number) : Any((double) number) {}
+  Any::Any (uint64_t number) : Any((double) number) {}
+
   Any::Any (double number) {
-    this->pointer = std::shared_ptr<void>(new Number((double) number));
     this->type = Type::Number;
+    this->data.number = number;
   }
 
   #if defined(__APPLE__)
-  Any::Any (ssize_t  number) {
-    this->pointer = std::shared_ptr<void>(new Number((double) number));
-    this->type = Type::Number;
-  }
+  Any::Any (ssize_t number) : Any((double) number) {}
   #endif
 
-  Any::Any (const Number number) {
-    this->pointer = std::shared_ptr<void>(new Number(number));
-    this->type = Type::Number;
+  Any::Any (const Number& number) : Any(number.data) {}
+
+  Any::Any (const Object& object) {
+    this->type = Type::Object;
+    this->data.node = createNode<Object>(object);
   }
 
-  Any::Any (const Object object) {
-    this->pointer = std::shared_ptr<void>(new Object(object));
+  Any::Any (Object&& object) {
     this->type = Type::Object;
+    this->data.node = createNode<Object>(std::move(object));
   }
 
-  Any::Any (const Object::Entries entries) {
-    this->pointer = std::shared_ptr<void>(new Object(entries));
+  Any::Any (const Object::Entries& entries) {
     this->type = Type::Object;
+    this->data.node = createNode<Object>(entries);
   }
 
-  Any::Any (const Array array) {
-    this->pointer = std::shared_ptr<void>(new Array(array));
+  Any::Any (Object::Entries&& entries) {
+    this->type = Type::Object;
+    this->data.node = createNode<Object>(std::move(entries));
+  }
+
+  Any::Any (const Array& array) {
     this->type = Type::Array;
+    this->data.node = createNode<Array>(array);
   }
 
-  Any::Any (const Array::Entries entries) {
-    this->pointer = std::shared_ptr<void>(new Array(entries));
+  Any::Any (Array&& array) {
     this->type = Type::Array;
+    this->data.node = createNode<Array>(std::move(array));
   }
 
-  Any::Any (const Raw source) {
-    this->pointer = std::shared_ptr<void>(new Raw(source));
+  Any::Any (const Array::Entries& entries) {
+    this->type = Type::Array;
+    this->data.node = createNode<Array>(entries);
+  }
+
+  Any::Any (Array::Entries&& entries) {
+    this->type = Type::Array;
+    this->data.node = createNode<Array>(std::move(entries));
+  }
+
+  Any::Any (const Raw& source) {
     this->type = Type::Raw;
+    this->data.node = createNode<Raw>(source);
+  }
+
+  Any::Any (Raw&& source) {
+    this->type = Type::Raw;
+    this->data.node = createNode<Raw>(std::move(source));
   }
 
   std::string Any::str () const {
-    const auto ptr = this->pointer.get() == nullptr
-      ? reinterpret_cast<const void*>(this)
-      : this->pointer.get();
+    std::string output;
+    write(output, *this);
+    return output;
+  }
 
-    switch (this->type) {
-      case Type::Empty: return "";
-      case Type::Any: return "";
-      case Type::Raw: return reinterpret_cast<const Raw*>(ptr)->str();
-      case Type::Null: return "null";
-      case Type::Object: return reinterpret_cast<const Object*>(ptr)->str();
-      case Type::Array: return reinterpret_cast<const Array*>(ptr)->str();
-      case Type::Boolean: return reinterpret_cast<const Boolean*>(ptr)->str();
-      case Type::Number: return reinterpret_cast<const Number*>(ptr)->str();
-      case Type::String: return reinterpret_cast<const String*>(ptr)->str();
-    }
-
-    return "";
+  // bytes that cannot be copied into a JSON string as is
+  static const auto escapes = []() {
+    std::array<bool, 256> table = {};
+    for (int i = 0; i < 0x20; ++i) {
+      table[i] = true;
+    }
+
+    table['"'] = true;
+    table['\\'] = true;
+    return table;
+  }();
+
+  void writeString (std::string& output, std::string_view value) {
+    static constexpr char hex[] = "0123456789abcdef";
+    const auto size = value.size();
+    const auto data = value.data();
+    size_t offset = 0;
+
+    output.push_back('"');
+
+    for (size_t i = 0; i < size; ++i) {
+      const auto c = (unsigned char) data[i];
+
+      if (!escapes[c]) {
+        continue;
+      }
+
+      // copy the unescaped run before this byte in one go
+      output.append(data + offset, i - offset);
+      offset = i + 1;
+
+      switch (c) {
+        case '"': output.append("\\\""); break;
+        case '\\': output.append("\\\\"); break;
+        case '\n': output.append("\\n"); break;
+        case '\r': output.append("\\r"); break;
+        case '\t': output.append("\\t"); break;
+        case '\b': output.append("\\b"); break;
+        case '\f': output.append("\\f"); break;
+        default: {
+          const char sequence[] = {
+            '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]
+          };
+
+          output.append(sequence, sizeof(sequence));
+        }
+      }
+    }
+
+    output.append(data + offset, size - offset);
+    output.push_back('"');
+  }
+
+  void writeNumber (std::string& output, double value) {
+    char buffer[32];
+    output.append(buffer, formatNumber(buffer, sizeof(buffer), value));
+  }
+
+  void write (std::string& output, const Object& object) {
+    bool first = true;
+    output.push_back('{');
+
+    for (const auto& tuple : object.data) {
+      if (!first) {
+        output.push_back(',');
+      }
+
+      first = false;
+      writeString(output, tuple.first);
+      output.push_back(':');
+      write(output, tuple.second);
+    }
+
+    output.push_back('}');
+  }
+
+  void write (std::string& output, const Array& array) {
+    bool first = true;
+    output.push_back('[');
+
+    for (const auto& value : array.data) {
+      if (!first) {
+        output.push_back(',');
+      }
+
+      first = false;
+      write(output, value);
+    }
+
+    output.push_back(']');
+  }
+
+  void write (std::string& output, const Any& value) {
+    switch (value.type) {
+      case Type::Empty: break;
+      case Type::Any: break;
+      case Type::Null: output.append("null"); break;
+      case Type::Raw:
+        output.append(value.as<Raw>().data);
+        break;
+      case Type::Object:
+        write(output, value.as<Object>());
+        break;
+      case Type::Array:
+        write(output, value.as<Array>());
+        break;
+      case Type::Boolean:
+        output.append(value.data.boolean ? "true" : "false");
+        break;
+      case Type::Number:
+        writeNumber(output, value.data.number);
+        break;
+      case Type::String:
+        writeString(output, value.stringView());
+        break;
+    }
+  }
+
+  // bytes that end a run of literal characters in a JSON string
+  static const auto stringStops = []() {
+    std::array<bool, 256> table = {};
+    for (int i = 0; i < 0x20; ++i) {
+      table[i] = true;
+    }
+
+    table['"'] = true;
+    table['\\'] = true;
+    return table;
+  }();
+
+  // Returns a pointer to the first '"', '\' or control character in
+  // `[p, end)`, or `end`. Most strings are long runs of literal characters,
+  // so 16 bytes are tested at a time where SIMD is available.
+  static inline const char* scanString (const char* p, const char* end) {
+  #if defined(__SSE2__) || defined(_M_X64)
+    const auto quote = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto control = _mm_set1_epi8(0x1f);
+
+    while (end - p >= 16) {
+      const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      const auto mask = _mm_or_si128(
+        _mm_or_si128(
+          _mm_cmpeq_epi8(chunk, quote),
+          _mm_cmpeq_epi8(chunk, backslash)
+        ),
+        // unsigned `c <= 0x1f` is `min(c, 0x1f) == c`
+        _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk)
+      );
+
+      const auto bits = (unsigned int) _mm_movemask_epi8(mask);
+
+      if (bits != 0) {
+        return p + std::countr_zero(bits);
+      }
+
+      p += 16;
+    }
+  #elif defined(__ARM_NEON) && defined(__aarch64__)
+    const auto quote = vdupq_n_u8('"');
+    const auto backslash = vdupq_n_u8('\\');
+    const auto control = vdupq_n_u8(0x20);
+
+    while (end - p >= 16) {
+      const auto chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+      const auto mask = vorrq_u8(
+        vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+        vcltq_u8(chunk, control)
+      );
+
+      // the exact position is found by the scalar loop below
+      if (vmaxvq_u8(mask) != 0) {
+        break;
+      }
+
+      p += 16;
+    }
+  #endif
+
+    while (p < end && !stringStops[(unsigned char) *p]) {
+      p++;
+    }
+
+    return p;
+  }
+
+  class Parser {
+    public:
+      static constexpr int MAX_DEPTH = 512;
+      static constexpr size_t INDEXED_OBJECT_SIZE = 32;
+
+      const char* begin = nullptr;
+      const char* end = nullptr;
+      const char* p = nullptr;
+      int depth = 0;
+
+      Parser (const char* source, size_t size) {
+        this->begin = source;
+        this->end = source + size;
+        this->p = source;
+      }
+
+      [[noreturn]] void fail (const std::string& message) const {
+        throw Error(
+          "SyntaxError",
+          message,
+          "offset " + std::to_string(this->p - this->begin)
+        );
+      }
+
+      inline void skipWhitespace () {
+        while (this->p < this->end) {
+          const auto c = *this->p;
+          if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            break;
+          }
+
+          this->p++;
+        }
+      }
+
+      inline void expect (char c) {
+        if (this->p >= this->end || *this->p != c) {
+          this->fail(std::string("Expecting '") + c + "'");
+        }
+
+        this->p++;
+      }
+
+      inline void expectLiteral (const char* literal, size_t size) {
+        if ((size_t) (this->end - this->p) < size || std::memcmp(this->p, literal, size) != 0) {
+          this->fail("Unexpected token");
+        }
+
+        this->p += size;
+      }
+
+      Any parseDocument () {
+        this->skipWhitespace();
+        auto value = this->parseValue();
+        this->skipWhitespace();
+
+        if (this->p != this->end) {
+          this->fail("Unexpected data after JSON value");
+        }
+
+        return value;
+      }
+
+      Any parseValue () {
+        if (this->p >= this->end) {
+          this->fail("Unexpected end of JSON input");
+        }
+
+        switch (*this->p) {
+          case '{': return this->parseObject();
+          case '[': return this->parseArray();
+          case '"': return Any(this->parseString());
+          case 't': this->expectLiteral("true", 4); return Any(true);
+          case 'f': this->expectLiteral("false", 5); return Any(false);
+          case 'n': this->expectLiteral("null", 4); return Any(nullptr);
+          default: return this->parseNumber();
+        }
+      }
+
+      Any parseObject () {
+        if (++this->depth > MAX_DEPTH) {
+          this->fail("Maximum nesting depth exceeded");
+        }
+
+        // keys are looked up linearly while an object is small, larger
+        // objects index their keys so duplicates are still found cheaply
+        std::unordered_map<std::string, size_t> index;
+        Object object;
+        this->expect('{');
+        this->skipWhitespace();
+
+        if (this->p < this->end && *this->p == '}') {
+          this->p++;
+          this->depth--;
+          return object;
+        }
+
+        while (true) {
+          this->skipWhitespace();
+
+          if (this->p >= this->end || *this->p != '"') {
+            this->fail("Expecting object key");
+          }
+
+          auto key = this->parseString();
+          this->skipWhitespace();
+          this->expect(':');
+          this->skipWhitespace();
+          auto value = this->parseValue();
+          auto& entries = object.data;
+
+          if (entries.size() < INDEXED_OBJECT_SIZE) {
+            entries.insert_or_assign(std::move(key), std::move(value));
+          } else {
+            if (index.empty()) {
+              for (size_t i = 0; i < entries.size(); ++i) {
+                index.emplace(entries.entries[i].first, i);
+              }
+            }
+
+            const auto result = index.try_emplace(key, entries.size());
+
+            if (result.second) {
+              entries.append(std::move(key), std::move(value));
+            } else {
+              entries.entries[result.first->second].second = std::move(value);
+            }
+          }
+          this->skipWhitespace();
+
+          if (this->p < this->end && *this->p == ',') {
+            this->p++;
+            continue;
+          }
+
+          this->expect('}');
+          break;
+        }
+
+        this->depth--;
+        return object;
+      }
+
+      Any parseArray () {
+        if (++this->depth > MAX_DEPTH) {
+          this->fail("Maximum nesting depth exceeded");
+        }
+
+        Array array;
+        this->expect('[');
+        this->skipWhitespace();
+
+        if (this->p < this->end && *this->p == ']') {
+          this->p++;
+          this->depth--;
+          return array;
+        }
+
+        while (true) {
+          this->skipWhitespace();
+          array.data.push_back(this->parseValue());
+          this->skipWhitespace();
+
+          if (this->p < this->end && *this->p == ',') {
+            this->p++;
+            continue;
+          }
+
+          this->expect(']');
+          break;
+        }
+
+        this->depth--;
+        return array;
+      }
+
+      inline uint32_t parseHex4 () {
+        uint32_t value = 0;
+
+        if (this->end - this->p < 4) {
+          this->fail("Invalid unicode escape");
+        }
+
+        for (int i = 0; i < 4; ++i) {
+          const auto c = *this->p++;
+          value <<= 4;
+
+          if (c >= '0' && c <= '9') {
+            value |= c - '0';
+          } else if (c >= 'a' && c <= 'f') {
+            value |= c - 'a' + 10;
+          } else if (c >= 'A' && c <= 'F') {
+            value |= c - 'A' + 10;
+          } else {
+            this->fail("Invalid unicode escape");
+          }
+        }
+
+        return value;
+      }
+
+      static void appendUTF8 (std::string& output, uint32_t codepoint) {
+        if (codepoint < 0x80) {
+          output.push_back((char) codepoint);
+        } else if (codepoint < 0x800) {
+          output.push_back((char) (0xc0 | (codepoint >> 6)));
+          output.push_back((char) (0x80 | (codepoint & 0x3f)));
+        } else if (codepoint < 0x10000) {
+          output.push_back((char) (0xe0 | (codepoint >> 12)));
+          output.push_back((char) (0x80 | ((codepoint >> 6) & 0x3f)));
+          output.push_back((char) (0x80 | (codepoint & 0x3f)));
+        } else {
+          output.push_back((char) (0xf0 | (codepoint >> 18)));
+          output.push_back((char) (0x80 | ((codepoint >> 12) & 0x3f)));
+          output.push_back((char) (0x80 | ((codepoint >> 6) & 0x3f)));
+          output.push_back((char) (0x80 | (codepoint & 0x3f)));
+        }
+      }
+
+      std::string parseString () {
+        std::string output;
+        this->expect('"');
+
+        while (true) {
+          const auto stop = scanString(this->p, this->end);
+          output.append(this->p, stop - this->p);
+          this->p = stop;
+
+          if (this->p >= this->end) {
+            this->fail("Unterminated string");
+          }
+
+          const auto c = *this->p++;
+
+          if (c == '"') {
+            return output;
+          }
+
+          if (c != '\\') {
+            this->p--;
+            this->fail("Bad control character in string");
+          }
+
+          if (this->p >= this->end) {
+            this->fail("Unterminated string");
+          }
+
+          switch (*this->p++) {
+            case '"': output.push_back('"'); break;
+            case '\\': output.push_back('\\'); break;
+            case '/': output.push_back('/'); break;
+            case 'b': output.push_back('\b'); break;
+            case 'f': output.push_back('\f'); break;
+            case 'n': output.push_back('\n'); break;
+            case 'r': output.push_back('\r'); break;
+            case 't': output.push_back('\t'); break;
+            case 'u': {
+              auto codepoint = this->parseHex4();
+
+              // surrogate pair
+              if (codepoint >= 0xd800 && codepoint <= 0xdbff) {
+                if (this->end - this->p >= 6 && this->p[0] == '\\' && this->p[1] == 'u') {
+                  this->p += 2;
+                  const auto low = this->parseHex4();
+
+                  if (low >= 0xdc00 && low <= 0xdfff) {
+                    codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+                  } else {
+                    // lone high surrogate followed by another escape
+                    appendUTF8(output, 0xfffd);
+                    codepoint = low;
+                  }
+                } else {
+                  codepoint = 0xfffd;
+                }
+              } else if (codepoint >= 0xdc00 && codepoint <= 0xdfff) {
+                codepoint = 0xfffd;
+              }
+
+              appendUTF8(output, codepoint);
+              break;
+            }
+
+            default:
+              this->p--;
+              this->fail("Invalid escape sequence");
+          }
+        }
+      }
+
+      Any parseNumber () {
+        const auto start = this->p;
+        bool negative = false;
+        bool integer = true;
+        uint64_t mantissa = 0;
+        int digits = 0;
+
+        if (this->p < this->end && *this->p == '-') {
+          negative = true;
+          this->p++;
+        }
+
+        if (this->p >= this->end || *this->p < '0' || *this->p > '9') {
+          this->fail("Unexpected token");
+        }
+
+        if (*this->p == '0') {
+          this->p++;
+        } else {
+          while (this->p < this->end && *this->p >= '0' && *this->p <= '9') {
+            mantissa = mantissa * 10 + (*this->p++ - '0');
+            digits++;
+          }
+        }
+
+        if (this->p < this->end && *this->p == '.') {
+          integer = false;
+          this->p++;
+
+          if (this->p >= this->end || *this->p < '0' || *this->p > '9') {
+            this->fail("Invalid number");
+          }
+
+          while (this->p < this->end && *this->p >= '0' && *this->p <= '9') {
+            this->p++;
+          }
+        }
+
+        if (this->p < this->end && (*this->p == 'e' || *this->p == 'E')) {
+          integer = false;
+          this->p++;
+
+          if (this->p < this->end && (*this->p == '+' || *this->p == '-')) {
+            this->p++;
+          }
+
+          if (this->p >= this->end || *this->p < '0' || *this->p > '9') {
+            this->fail("Invalid number");
+          }
+
+          while (this->p < this->end && *this->p >= '0' && *this->p <= '9') {
+            this->p++;
+          }
+        }
+
+        // integers that are exactly representable as a double skip the
+        // general (and much slower) decimal to binary conversion
+        if (integer && digits <= 15) {
+          const auto value = (double) mantissa;
+          return Any(negative ? -value : value);
+        }
+
+        double value = 0;
+      #if defined(__cpp_lib_to_chars)
+        const auto result = std::from_chars(start, this->p, value);
+        if (result.ec == std::errc::result_out_of_range) {
+          value = std::strtod(std::string(start, this->p).c_str(), nullptr);
+        }
+      #else
+        value = std::strtod(std::string(start, this->p).c_str(), nullptr);
+      #endif
+        return Any(value);
+      }
+  };
+
+  Any parse (const char* source, size_t size) {
+    if (source == nullptr) {
+      throw Error("SyntaxError", "Unexpected end of JSON input", "offset 0");
+    }
+
+    auto parser = Parser(source, size);
+    return parser.parseDocument();
+  }
+
+  Any parse (const std::string& source) {
+    return parse(source.data(), source.size());
   }
 }
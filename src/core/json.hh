@@ -13,8 +13,9 @@ namespace SSC::JSON {
   class Boolean;
   class Number;
   class String;
+  class Arena;
+  class ObjectEntries;
 
-  using ObjectEntries = std::map<std::string, Any>;
   using ArrayEntries = std::vector<Any>;
 
   inline auto replace (
@@ -60,6 +61,7 @@ namespace SSC::JSON {
 
   template <typename D, Type t> struct Value {
     public:
+      static constexpr Type TYPE = t;
       Type type = t;
       D data;
 
@@ -102,34 +104,113 @@ namespace SSC::JSON {
 
   extern Null null;
 
-  class Any : public Value<void *, Type::Any> {
+  /**
+   * A bump allocator for the nodes of objects, arrays, raw values and
+   * strings that do not fit inline in an `Any`. While an `Arena::Scope` is
+   * active on a thread, values created on that thread are allocated from
+   * the scope's arena instead of the heap. Nodes stay reference counted and
+   * each one holds a reference to its arena, so values may safely outlive
+   * the scope: the memory is released when the last of them is destroyed.
+   */
+  class Arena {
     public:
-      std::shared_ptr<void> pointer = nullptr;
+      static constexpr size_t BLOCK_SIZE = 4096;
+      static constexpr size_t MAX_BLOCK_SIZE = 64 * 1024;
+
+      struct Block {
+        Block* next = nullptr;
+        size_t size = 0;
+        size_t used = 0;
+      };
+
+      class Scope {
+        public:
+          Arena* arena = nullptr;
+          Scope* previous = nullptr;
+
+          Scope ();
+          Scope (const Scope&) = delete;
+          ~Scope ();
+      };
+
+      std::atomic<uint64_t> references = 1;
+      Block* blocks = nullptr;
+      size_t allocations = 0;
+      size_t bytes = 0;
+
+      // the arena of the innermost scope on this thread, created on demand
+      static Arena* current ();
+
+      Arena () = default;
+      Arena (const Arena&) = delete;
+      ~Arena ();
+
+      void* allocate (size_t size, size_t alignment);
+      void retain ();
+      void release ();
+  };
 
-      Any () {
-        this->pointer = nullptr;
-        this->type = Type::Null;
-      }
+  /**
+   * The reference counted header of a value that is stored out of line.
+   */
+  struct Node {
+    std::atomic<uint32_t> references = 1;
+    Arena* arena = nullptr;
+  };
 
-      ~Any () {
-        this->pointer = nullptr;
-        this->type = Type::Any;
-      }
+  template <typename T> struct ValueNode {
+    Node node;
+    T value;
+    // nested objects and arrays are handed to extensions as `sapi_json_*`
+    // values, which carry their context directly after the value
+    void* context = nullptr;
 
-      Any (const Any &any) {
-        this->pointer = any.pointer;
-        this->type = any.type;
-      }
+    template <typename... Args> ValueNode (Args&&... args)
+      : value(std::forward<Args>(args)...)
+    {}
+  };
 
-      Any (Type type, std::shared_ptr<void> pointer) {
-        this->type = type;
-        this->pointer = pointer;
+  // a type that declares how it is written as JSON with `JSON::Shape`
+  template <typename T> concept Shaped = requires { typename T::Shape; };
+
+  // the inline storage of an `Any`
+  union AnyData {
+    bool boolean;
+    double number;
+    Node* node;
+    struct {
+      char bytes[15];
+      unsigned char size;
+    } string;
+  };
+
+  /**
+   * A JSON value. Booleans, numbers and strings of up to
+   * `SMALL_STRING_SIZE` bytes are stored inline. Objects, arrays, raw values
+   * and longer strings are stored in a reference counted node that is
+   * shared by copies of the value.
+   */
+  class Any : public Value<AnyData, Type::Null> {
+    public:
+      static constexpr size_t SMALL_STRING_SIZE = sizeof(AnyData::string.bytes);
+      // `data.string.size` of a string stored in a node
+      static constexpr unsigned char NODE_STRING = 0xff;
+
+      Any () {
+        this->data.node = nullptr;
       }
 
+      Any (const Any& any);
+      Any (Any&& any) noexcept;
+      ~Any ();
+
+      Any& operator= (const Any& any);
+      Any& operator= (Any&& any) noexcept;
+
       Any (std::nullptr_t);
       Any (const Null);
       Any (bool);
-      Any (const Boolean);
+      Any (const Boolean&);
       Any (int64_t);
       Any (uint64_t);
       Any (uint32_t);
@@ -138,35 +219,78 @@ namespace SSC::JSON {
       #if defined(__APPLE__)
       Any (ssize_t);
       #endif
-      Any (const Number);
+      Any (const Number&);
       Any (const char);
       Any (const char *);
-      Any (const std::string);
-      Any (const String);
-      Any (const Object);
-      Any (const ObjectEntries);
-      Any (const Array);
-      Any (const ArrayEntries);
-      Any (const Raw source);
+      Any (const std::string&);
+      Any (std::string&&);
+      Any (const String&);
+      Any (const Object&);
+      Any (Object&&);
+      Any (const ObjectEntries&);
+      Any (ObjectEntries&&);
+      Any (const Array&);
+      Any (Array&&);
+      Any (const ArrayEntries&);
+      Any (ArrayEntries&&);
+      Any (const Raw&);
+      Any (Raw&&);
+      template <Shaped T> Any (const T&);
 
       std::string str () const;
 
-      template <typename T> T& as () const {
-        auto ptr = this->pointer.get();
-
-        if (ptr != nullptr && this->type != Type::Null) {
-          return *reinterpret_cast<T *>(ptr);
+      inline bool hasNode () const {
+        return (
+          this->type == Type::Object ||
+          this->type == Type::Array ||
+          this->type == Type::Raw ||
+          (this->type == Type::String && this->data.string.size == NODE_STRING)
+        );
+      }
+
+      // the bytes of a string value, empty for any other type
+      std::string_view stringView () const;
+
+      /**
+       * Objects, arrays and raw values are returned by reference to the
+       * shared node. Booleans, numbers, strings and null are returned by
+       * value. A `JSON::Error` named `BadCastError` is thrown if the value
+       * is of another type.
+       */
+      template <typename T> decltype(auto) as () const {
+        if (this->type != T::TYPE) {
+          throw Error(
+            "BadCastError",
+            "cannot cast " + this->typeof() + " value",
+            __PRETTY_FUNCTION__
+          );
         }
 
-        throw Error("BadCastError", "cannot cast to null value", __PRETTY_FUNCTION__);
+        if constexpr (T::TYPE == Type::Object || T::TYPE == Type::Array || T::TYPE == Type::Raw) {
+          return (reinterpret_cast<ValueNode<T>*>(this->data.node)->value);
+        } else if constexpr (T::TYPE == Type::Boolean) {
+          return T(this->data.boolean);
+        } else if constexpr (T::TYPE == Type::Number) {
+          return T(this->data.number);
+        } else if constexpr (T::TYPE == Type::String) {
+          return T(std::string(this->stringView()));
+        } else {
+          return T();
+        }
       }
+
+    private:
+      void setString (const char* bytes, size_t size);
+      void release ();
   };
 
   class Raw : public Value<std::string, Type::Raw> {
     public:
       Raw (const Raw& raw) { this->data = raw.data; }
+      Raw (Raw&& raw) { this->data = std::move(raw.data); }
       Raw (const Raw* raw) { this->data = raw->data; }
       Raw (const std::string& source) { this->data = source; }
+      Raw (std::string&& source) { this->data = std::move(source); }
 
       const std::string str () const {
         return this->data;
@@ -179,10 +303,113 @@ namespace SSC::JSON {
     return any.typeof();
   }
 
+  /**
+   * Object entries in insertion order. Objects are small in practice so a
+   * flat vector with a linear lookup is cheaper to build, copy and walk
+   * than a tree, and serialization follows the order keys were set in.
+   * The interface mirrors the subset of `std::map` used in the tree.
+   */
+  class ObjectEntries {
+    public:
+      using Entry = std::pair<std::string, Any>;
+      using Container = std::vector<Entry>;
+      using iterator = Container::iterator;
+      using const_iterator = Container::const_iterator;
+
+      Container entries;
+
+      ObjectEntries () = default;
+      ObjectEntries (std::initializer_list<Entry> entries) {
+        this->entries.reserve(entries.size());
+        for (const auto& entry : entries) {
+          // like `std::map`, the first of duplicate keys is kept
+          if (this->find(entry.first) == this->end()) {
+            this->entries.push_back(entry);
+          }
+        }
+      }
+
+      iterator begin () { return this->entries.begin(); }
+      iterator end () { return this->entries.end(); }
+      const_iterator begin () const { return this->entries.begin(); }
+      const_iterator end () const { return this->entries.end(); }
+      size_t size () const { return this->entries.size(); }
+      bool empty () const { return this->entries.empty(); }
+      void clear () { this->entries.clear(); }
+      void reserve (size_t size) { this->entries.reserve(size); }
+
+      iterator find (std::string_view key) {
+        auto it = this->entries.begin();
+        for (; it != this->entries.end(); ++it) {
+          if (it->first == key) break;
+        }
+        return it;
+      }
+
+      const_iterator find (std::string_view key) const {
+        auto it = this->entries.begin();
+        for (; it != this->entries.end(); ++it) {
+          if (it->first == key) break;
+        }
+        return it;
+      }
+
+      size_t count (std::string_view key) const {
+        return this->find(key) != this->end() ? 1 : 0;
+      }
+
+      Any& at (std::string_view key) {
+        auto it = this->find(key);
+        if (it == this->end()) throw std::out_of_range(std::string(key));
+        return it->second;
+      }
+
+      const Any& at (std::string_view key) const {
+        auto it = this->find(key);
+        if (it == this->end()) throw std::out_of_range(std::string(key));
+        return it->second;
+      }
+
+      Any& operator [] (const std::string& key) {
+        auto it = this->find(key);
+        if (it != this->end()) return it->second;
+        return this->entries.emplace_back(key, nullptr).second;
+      }
+
+      std::pair<iterator, bool> insert_or_assign (std::string key, Any value) {
+        auto it = this->find(key);
+
+        if (it != this->end()) {
+          it->second = std::move(value);
+          return { it, false };
+        }
+
+        this->entries.emplace_back(std::move(key), std::move(value));
+        return { this->entries.end() - 1, true };
+      }
+
+      // appends without looking for an existing `key`
+      void append (std::string key, Any value) {
+        this->entries.emplace_back(std::move(key), std::move(value));
+      }
+
+      size_t erase (std::string_view key) {
+        auto it = this->find(key);
+        if (it == this->end()) return 0;
+        this->entries.erase(it);
+        return 1;
+      }
+  };
+
   class Object : public Value<ObjectEntries, Type::Object> {
     public:
       using Entries = ObjectEntries;
       Object () = default;
+      Object (const Object&) = default;
+      Object (Object&&) = default;
+      Object& operator= (const Object&) = default;
+      Object& operator= (Object&&) = default;
+
       Object (std::map<std::string, int> entries) {
         for (auto const &tuple : entries) {
           auto key = tuple.first;
@@ -215,16 +442,12 @@ namespace SSC::JSON {
         }
       }
 
-      Object (const Object::Entries entries) {
-        for (const auto& tuple : entries) {
-          auto key = tuple.first;
-          auto value = tuple.second;
-          this->data.insert_or_assign(key, value);
-        }
+      Object (const Object::Entries& entries) {
+        this->data = entries;
       }
 
-      Object (const Object& object) {
-        this->data = object.value();
+      Object (Object::Entries&& entries) {
+        this->data = std::move(entries);
       }
 
       Object (const std::map<std::string, std::string> map) {
@@ -242,15 +465,16 @@ namespace SSC::JSON {
       }
 
       Any& get (const std::string key) {
-        if (this->data.find(key) != this->data.end()) {
-          return this->data.at(key);
+        auto it = this->data.find(key);
+        if (it != this->data.end()) {
+          return it->second;
         }
 
         return anyNull;
       }
 
       void set (const std::string key, Any value) {
-        this->data[key] = value;
+        this->data.insert_or_assign(key, std::move(value));
       }
 
       bool has (const std::string& key) const {
@@ -258,8 +482,9 @@ namespace SSC::JSON {
       }
 
       Any operator [] (const std::string& key) const {
-        if (this->data.find(key) != this->data.end()) {
-          return this->data.at(key);
+        auto it = this->data.find(key);
+        if (it != this->data.end()) {
+          return it->second;
         }
 
         return nullptr;
@@ -278,14 +503,17 @@ namespace SSC::JSON {
     public:
       using Entries = ArrayEntries;
       Array () = default;
-      Array (const Array& array) {
-        this->data = array.value();
+      Array (const Array&) = default;
+      Array (Array&&) = default;
+      Array& operator= (const Array&) = default;
+      Array& operator= (Array&&) = default;
+
+      Array (const Array::Entries& entries) {
+        this->data = entries;
       }
 
-      Array (const Array::Entries entries) {
-        for (const auto& value : entries) {
-          this->data.push_back(value);
-        }
+      Array (Array::Entries&& entries) {
+        this->data = std::move(entries);
       }
 
       std::string str () const;
@@ -295,7 +523,7 @@ namespace SSC::JSON {
       }
 
       bool has (const unsigned int index) const {
-        return this->data.size() < index;
+        return index < this->data.size();
       }
 
       auto size () const {
@@ -315,19 +543,19 @@ namespace SSC::JSON {
           this->data.resize(index + 1);
         }
 
-        this->data[index] = value;
+        this->data[index] = std::move(value);
       }
 
       void push (Any value) {
-        this->set(this->size(), value);
+        this->data.push_back(std::move(value));
       }
 
-      Any& pop () {
+      Any pop () {
         if (this->size() == 0) {
-          return anyNull;
+          return nullptr;
         }
 
-        auto& value = this->data.back();
+        auto value = std::move(this->data.back());
         this->data.pop_back();
         return value;
       }
@@ -418,7 +646,7 @@ namespace SSC::JSON {
 
       Number (const String& string);
 
-      float value () const {
+      double value () const {
         return this->data;
       }
 
@@ -428,14 +656,19 @@ namespace SSC::JSON {
   class String : public Value<std::string, Type::String> {
     public:
       String () = default;
-      String (const String& data) {
-        this->data = std::string(data.value());
-      }
+      String (const String&) = default;
+      String (String&&) = default;
+      String& operator= (const String&) = default;
+      String& operator= (String&&) = default;
 
-      String (const std::string data) {
+      String (const std::string& data) {
         this->data = data;
       }
 
+      String (std::string&& data) {
+        this->data = std::move(data);
+      }
+
       String (const char data) {
         this->data = std::string(1, data);
       }
@@ -454,10 +687,7 @@ namespace SSC::JSON {
         this->data = boolean.str();
       }
 
-      std::string str () const {
-        auto escaped = replace(this->data, "\"", "\\\"");
-        return "\"" + replace(escaped, "\n", "\\n") + "\"";
-      }
+      std::string str () const;
 
       std::string value () const {
         return this->data;
@@ -467,6 +697,223 @@ namespace SSC::JSON {
         return this->data.size();
       }
   };
+
+  /**
+   * Serializes `value` by appending to `output`. The `output` buffer is
+   * never cleared so callers can reuse one buffer (and its capacity) across
+   * many writes with `output.clear()`.
+   */
+  void write (std::string& output, const Any& value);
+  void write (std::string& output, const Object& object);
+  void write (std::string& output, const Array& array);
+
+  /**
+   * Appends `value` as a quoted JSON string to `output`, escaping quotes,
+   * backslashes, and control characters.
+   */
+  void writeString (std::string& output, std::string_view value);
+
+  /**
+   * Appends `value` as a JSON number to `output`. NaN and infinity are
+   * written as `null`.
+   */
+  void writeNumber (std::string& output, double value);
+
+  /**
+   * Parses JSON `source` into a value. A `JSON::Error` named `SyntaxError`
+   * is thrown for malformed input with the byte offset of the first
+   * unexpected character as its location.
+   */
+  Any parse (const char* source, size_t size);
+  Any parse (const std::string& source);
+
+  /**
+   * A string literal that can be given as a template argument.
+   */
+  template <size_t N> struct Literal {
+    char bytes[N] = {};
+
+    constexpr Literal (const char (&string)[N]) {
+      for (size_t i = 0; i < N; ++i) {
+        this->bytes[i] = string[i];
+      }
+    }
+
+    constexpr size_t size () const {
+      return N - 1;
+    }
+
+    // true if the literal can be written between quotes as is
+    constexpr bool isPlain () const {
+      for (size_t i = 0; i < N - 1; ++i) {
+        const auto c = (unsigned char) this->bytes[i];
+        if (c < 0x20 || c == '"' || c == '\\') {
+          return false;
+        }
+      }
+
+      return true;
+    }
+  };
+
+  template <typename T> void writeValue (std::string& output, const T& value);
+
+  /**
+   * A member of a `Shape`: the key `name` and the value of `member`. The
+   * `,"name":` prefix is computed at compile time. A quoted field writes an
+   * integer as a JSON string, for values JavaScript reads with `BigInt()`.
+   */
+  template <Literal name, auto member, bool quoted = false> struct Field {
+    static_assert(name.isPlain(), "JSON::Field names are not escaped");
+
+    static constexpr auto prefix = []() {
+      std::array<char, name.size() + 4> prefix = {};
+      prefix[0] = ',';
+      prefix[1] = '"';
+
+      for (size_t i = 0; i < name.size(); ++i) {
+        prefix[i + 2] = name.bytes[i];
+      }
+
+      prefix[name.size() + 2] = '"';
+      prefix[name.size() + 3] = ':';
+      return prefix;
+    }();
+
+    template <bool first, typename T>
+    static void write (std::string& output, const T& value) {
+      output.append(prefix.data() + first, prefix.size() - first);
+
+      if constexpr (quoted) {
+        static_assert(
+          std::is_integral_v<std::remove_cvref_t<decltype(value.*member)>>,
+          "only integers can be quoted"
+        );
+
+        output.push_back('"');
+        writeValue(output, value.*member);
+        output.push_back('"');
+      } else {
+        writeValue(output, value.*member);
+      }
+    }
+  };
+
+  template <Literal name, auto member>
+  using QuotedField = Field<name, member, true>;
+
+  /**
+   * A member of a `Shape` with a string value known at compile time, such
+   * as the `source` of an IPC result.
+   */
+  template <Literal name, Literal value> struct Constant {
+    static_assert(name.isPlain(), "JSON::Constant names are not escaped");
+    static_assert(value.isPlain(), "JSON::Constant values are not escaped");
+
+    static constexpr auto text = []() {
+      std::array<char, name.size() + value.size() + 6> text = {};
+      size_t i = 0;
+      text[i++] = ',';
+      text[i++] = '"';
+
+      for (size_t j = 0; j < name.size(); ++j) {
+        text[i++] = name.bytes[j];
+      }
+
+      text[i++] = '"';
+      text[i++] = ':';
+      text[i++] = '"';
+
+      for (size_t j = 0; j < value.size(); ++j) {
+        text[i++] = value.bytes[j];
+      }
+
+      text[i++] = '"';
+      return text;
+    }();
+
+    template <bool first, typename T>
+    static void write (std::string& output, const T&) {
+      output.append(text.data() + first, text.size() - first);
+    }
+  };
+
+  /**
+   * Declares how a struct is written as a JSON object, for responses that
+   * always have the same keys. Writing one is a fixed sequence of appends
+   * with no intermediate `Object`:
+   *
+   *   struct Point {
+   *     int x;
+   *     int y;
+   *     using Shape = JSON::Shape<
+   *       JSON::Field<"x", &Point::x>,
+   *       JSON::Field<"y", &Point::y>
+   *     >;
+   *   };
+   *
+   * A shaped value converts to a `JSON::Any` holding the written `Raw` JSON.
+   */
+  template <typename... Fields> struct Shape {
+    template <typename T>
+    static void write (std::string& output, const T& value) {
+      output.push_back('{');
+      writeFields(output, value, std::index_sequence_for<Fields...>());
+      output.push_back('}');
+    }
+
+    private:
+      template <typename T, size_t... I>
+      static void writeFields (
+        std::string& output,
+        const T& value,
+        std::index_sequence<I...>
+      ) {
+        (Fields::template write<I == 0>(output, value), ...);
+      }
+  };
+
+  template <typename T> void writeValue (std::string& output, const T& value) {
+    if constexpr (Shaped<T>) {
+      T::Shape::write(output, value);
+    } else if constexpr (std::is_same_v<T, bool>) {
+      output.append(value ? "true" : "false");
+    } else if constexpr (std::is_integral_v<T>) {
+      char buffer[24];
+      const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+      output.append(buffer, result.ptr - buffer);
+    } else if constexpr (std::is_floating_point_v<T>) {
+      writeNumber(output, (double) value);
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+      writeString(output, value);
+    } else if constexpr (requires { value.begin(); value.end(); }) {
+      bool first = true;
+      output.push_back('[');
+
+      for (const auto& item : value) {
+        if (!first) {
+          output.push_back(',');
+        }
+
+        first = false;
+        writeValue(output, item);
+      }
+
+      output.push_back(']');
+    } else {
+      write(output, Any(value));
+    }
+  }
+
+  template <Shaped T> void write (std::string& output, const T& value) {
+    T::Shape::write(output, value);
+  }
+
+  template <Shaped T> Any::Any (const T& value) {
+    std::string output;
+    T::Shape::write(output, value);
+    *this = Any(Raw(std::move(output)));
+  }
 }
 
 #endif
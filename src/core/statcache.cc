@@ -0,0 +1,224 @@
+#include "core.hh"
+
+namespace SSC {
+  Core::FS::StatCache::~StatCache () {
+    // the loop is gone by now, so the watches are not closed
+    for (const auto& entry : this->watches) {
+      delete entry.second;
+    }
+  }
+
+  bool Core::FS::StatCache::isEnabled () {
+    static auto userConfig = SSC::getUserConfig();
+
+    if (!this->initialized) {
+      this->initialized = true;
+
+      try {
+        if (userConfig["filesystem_stat_cache"].size() > 0) {
+          this->capacity = std::stoull(userConfig["filesystem_stat_cache"]);
+        }
+      } catch (...) {
+        this->capacity = 0;
+      }
+    }
+
+    return this->capacity > 0;
+  }
+
+  Core::FS::StatCache::Entry * Core::FS::StatCache::get (const String& path) {
+    const auto entry = this->index.find(path);
+
+    if (entry == this->index.end()) {
+      return nullptr;
+    }
+
+    this->entries.splice(this->entries.begin(), this->entries, entry->second);
+    return &*entry->second;
+  }
+
+  // whether `result` is of a directory, whose own watch sees entries come
+  // and go in it and change its `mtime` and `nlink`
+  static bool isDirectoryResult (const Core::FS::StatCache::Result& result) {
+    return result.known && result.err >= 0 && (result.stat.st_mode & S_IFMT) == S_IFDIR;
+  }
+
+  void Core::FS::StatCache::set (
+    uv_loop_t *loop,
+    const String& path,
+    uint64_t generation,
+    const std::function<void(Entry&)>& update
+  ) {
+    // something changed while the result was being found
+    if (!this->isEnabled() || generation != this->generation) {
+      return;
+    }
+
+    auto entry = this->index.find(path) != this->index.end()
+      ? this->index.at(path)
+      : this->entries.end();
+
+    if (entry != this->entries.end()) {
+      this->entries.splice(this->entries.begin(), this->entries, entry);
+    } else {
+      auto directory = std::filesystem::path(path).parent_path().string();
+
+      if (directory.size() == 0) {
+        directory = ".";
+      }
+
+      // a path whose directory cannot be watched is not kept
+      auto watch = this->watch(loop, directory);
+      if (watch == nullptr) {
+        return;
+      }
+
+      this->entries.emplace_front();
+      entry = this->entries.begin();
+      entry->path = path;
+      entry->watch = watch;
+      this->index[path] = entry;
+      watch->paths.insert(path);
+    }
+
+    update(*entry);
+
+    if (
+      entry->self == nullptr &&
+      entry->watch->path != path &&
+      (isDirectoryResult(entry->stat) || isDirectoryResult(entry->lstat))
+    ) {
+      // nor is a directory that cannot be watched itself
+      entry->self = this->watch(loop, path);
+
+      if (entry->self == nullptr) {
+        return this->remove(entry);
+      }
+
+      entry->self->paths.insert(path);
+    }
+
+    while (this->entries.size() > this->capacity) {
+      this->evictions++;
+      this->remove(std::prev(this->entries.end()));
+    }
+  }
+
+  void Core::FS::StatCache::invalidate (const String& path) {
+    if (!this->isEnabled()) {
+      return;
+    }
+
+    this->generation++;
+
+    // a change to a path changes its directory too
+    for (const auto& key : { path, std::filesystem::path(path).parent_path().string() }) {
+      const auto entry = this->index.find(key);
+      if (entry != this->index.end()) {
+        this->invalidations++;
+        this->remove(entry->second);
+      }
+    }
+  }
+
+  void Core::FS::StatCache::invalidate (Watch *watch) {
+    const auto directory = watch->path;
+    const auto paths = Vector<String>(watch->paths.begin(), watch->paths.end());
+
+    this->generation++;
+
+    // the last path removed closes `watch`
+    for (const auto& path : paths) {
+      const auto entry = this->index.find(path);
+      if (entry != this->index.end()) {
+        this->invalidations++;
+        this->remove(entry->second);
+      }
+    }
+
+    const auto entry = this->index.find(directory);
+    if (entry != this->index.end()) {
+      this->invalidations++;
+      this->remove(entry->second);
+    }
+  }
+
+  void Core::FS::StatCache::remove (Entries::iterator entry) {
+    const auto path = entry->path;
+    const auto watches = { entry->watch, entry->self };
+
+    this->index.erase(path);
+    this->entries.erase(entry);
+
+    for (auto watch : watches) {
+      if (watch == nullptr) {
+        continue;
+      }
+
+      watch->paths.erase(path);
+
+      if (watch->paths.size() == 0) {
+        this->unwatch(watch);
+      }
+    }
+  }
+
+  Core::FS::StatCache::Watch * Core::FS::StatCache::watch (
+    uv_loop_t *loop,
+    const String& directory
+  ) {
+    if (this->watches.contains(directory)) {
+      return this->watches.at(directory);
+    }
+
+    auto watch = new Watch();
+    watch->cache = this;
+    watch->path = directory;
+
+    uv_fs_event_init(loop, &watch->handle);
+    watch->handle.data = (void *) watch;
+
+    auto err = uv_fs_event_start(
+      &watch->handle,
+      [](uv_fs_event_t *handle, const char *filename, int events, int status) {
+        auto watch = (Watch *) handle->data;
+        watch->cache->invalidate(watch);
+      },
+      directory.c_str(),
+      0
+    );
+
+    if (err < 0) {
+      uv_close((uv_handle_t *) &watch->handle, [](uv_handle_t *handle) {
+        delete (Watch *) handle->data;
+      });
+
+      return nullptr;
+    }
+
+    // the cache does not keep the loop alive
+    uv_unref((uv_handle_t *) &watch->handle);
+    this->watches[directory] = watch;
+    return watch;
+  }
+
+  void Core::FS::StatCache::unwatch (Watch *watch) {
+    this->watches.erase(watch->path);
+    uv_close((uv_handle_t *) &watch->handle, [](uv_handle_t *handle) {
+      delete (Watch *) handle->data;
+    });
+  }
+
+  JSON::Object Core::FS::StatCache::json () {
+    return JSON::Object::Entries {
+      {"enabled", this->isEnabled()},
+      {"capacity", this->capacity},
+      {"paths", this->entries.size()},
+      {"watches", this->watches.size()},
+      {"hits", this->hits},
+      {"misses", this->misses},
+      {"invalidations", this->invalidations},
+      {"evictions", this->evictions}
+    };
+  }
+}
@@ -91,6 +91,60 @@ namespace SSC {
     };
   }
 
+  template <JSON::Literal source, typename T> struct UDPResultJSON {
+    T data;
+
+    using Shape = JSON::Shape<
+      JSON::Constant<"source", source>,
+      JSON::Field<"data", &UDPResultJSON::data>
+    >;
+  };
+
+  struct UDPStateJSON {
+    uint64_t id;
+    bool bound;
+    bool active;
+    bool closed;
+    bool closing;
+    bool connected;
+    bool ephemeral;
+
+    using Shape = JSON::Shape<
+      JSON::QuotedField<"id", &UDPStateJSON::id>,
+      JSON::Constant<"type", "udp">,
+      JSON::Field<"bound", &UDPStateJSON::bound>,
+      JSON::Field<"active", &UDPStateJSON::active>,
+      JSON::Field<"closed", &UDPStateJSON::closed>,
+      JSON::Field<"closing", &UDPStateJSON::closing>,
+      JSON::Field<"connected", &UDPStateJSON::connected>,
+      JSON::Field<"ephemeral", &UDPStateJSON::ephemeral>
+    >;
+  };
+
+  struct UDPReadJSON {
+    uint64_t id;
+    int port;
+    uint64_t bytes;
+    String address;
+
+    using Shape = JSON::Shape<
+      JSON::QuotedField<"id", &UDPReadJSON::id>,
+      JSON::Field<"port", &UDPReadJSON::port>,
+      JSON::QuotedField<"bytes", &UDPReadJSON::bytes>,
+      JSON::Field<"address", &UDPReadJSON::address>
+    >;
+  };
+
+  struct UDPReadEndJSON {
+    uint64_t id;
+    bool eof = true;
+
+    using Shape = JSON::Shape<
+      JSON::QuotedField<"id", &UDPReadEndJSON::id>,
+      JSON::Field<"EOF", &UDPReadEndJSON::eof>
+    >;
+  };
+
   void Core::UDP::bind (
     const String seq,
     uint64_t peerId,
@@ -327,19 +381,15 @@ namespace SSC {
       return cb(seq, json, Post{});
     }
 
-    auto json = JSON::Object::Entries {
-      {"source", "udp.getState"},
-      {"data", JSON::Object::Entries {
-        {"id", std::to_string(peerId)},
-        {"type", "udp"},
-        {"bound", peer->isBound()},
-        {"active", peer->isActive()},
-        {"closed", peer->isClosed()},
-        {"closing", peer->isClosing()},
-        {"connected", peer->isConnected()},
-        {"ephemeral", peer->isEphemeral()}
-      }}
-    };
+    auto json = UDPResultJSON<"udp.getState", UDPStateJSON> {{
+      peerId,
+      peer->isBound(),
+      peer->isActive(),
+      peer->isClosed(),
+      peer->isClosing(),
+      peer->isConnected(),
+      peer->isEphemeral()
+    }};
 
     cb(seq, json, Post{});
   }
@@ -425,13 +475,7 @@ namespace SSC {
 
     auto err = peer->recvstart([=](auto nread, auto buf, auto addr) {
       if (nread == UV_EOF) {
-        auto json = JSON::Object::Entries {
-          {"source", "udp.readStart"},
-          {"data", JSON::Object::Entries {
-            {"id", std::to_string(peerId)},
-            {"EOF", true}
-          }}
-        };
+        auto json = UDPResultJSON<"udp.readStart", UDPReadEndJSON> {{ peerId }};
 
         cb("-1", json, Post{});
       } else if (nread > 0) {
@@ -451,15 +495,12 @@ namespace SSC {
         post.length = (int) nread;
         post.headers = headers.str();
 
-        auto json = JSON::Object::Entries {
-          {"source", "udp.readStart"},
-          {"data", JSON::Object::Entries {
-            {"id", std::to_string(peerId)},
-            {"port", port},
-            {"bytes", std::to_string(post.length)},
-            {"address", address}
-          }}
-        };
+        auto json = UDPResultJSON<"udp.readStart", UDPReadJSON> {{
+          peerId,
+          port,
+          (uint64_t) post.length,
+          address
+        }};
 
         cb("-1", json, post);
       }
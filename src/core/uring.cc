@@ -0,0 +1,600 @@
+#include "core.hh"
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/sysmacros.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
+namespace SSC {
+#if defined(__linux__) && !defined(__ANDROID__)
+  // submission queue entries, the completion queue is twice as large
+  static constexpr unsigned int URING_ENTRIES = 256;
+
+  struct Core::FS::URing::Operation {
+    uv_fs_t *req = nullptr;
+    uv_fs_cb cb = nullptr;
+    // what the kernel reads or writes until the operation completes
+    String path;
+    Vector<struct iovec> iovecs;
+    struct statx statx;
+  };
+
+  struct Core::FS::URing::Ring {
+    int fd = -1;
+    int eventfd = -1;
+    uint32_t features = 0;
+
+    void *sqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    void *cqRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    struct io_uring_sqe *sqes = (struct io_uring_sqe *) MAP_FAILED;
+    size_t sqesSize = 0;
+
+    unsigned int *sqHead = nullptr;
+    unsigned int *sqTail = nullptr;
+    unsigned int *sqArray = nullptr;
+    unsigned int sqMask = 0;
+    unsigned int sqEntries = 0;
+
+    unsigned int *cqHead = nullptr;
+    unsigned int *cqTail = nullptr;
+    struct io_uring_cqe *cqes = nullptr;
+    unsigned int cqMask = 0;
+    unsigned int cqEntries = 0;
+
+    // written to the submission queue but not yet given to the kernel
+    unsigned int queued = 0;
+    // queued or submitted and not yet completed
+    unsigned int pending = 0;
+
+    uv_poll_t poll;
+    uv_prepare_t prepare;
+    uv_check_t check;
+
+    Vector<Operation*> operations;
+
+    ~Ring () {
+      for (auto operation : this->operations) {
+        delete operation;
+      }
+
+      if (this->sqes != MAP_FAILED) munmap(this->sqes, this->sqesSize);
+      if (this->cqRing != MAP_FAILED && this->cqRing != this->sqRing) {
+        munmap(this->cqRing, this->cqRingSize);
+      }
+      if (this->sqRing != MAP_FAILED) munmap(this->sqRing, this->sqRingSize);
+      if (this->eventfd >= 0) ::close(this->eventfd);
+      if (this->fd >= 0) ::close(this->fd);
+    }
+  };
+
+  static int uringSetup (unsigned int entries, struct io_uring_params *params) {
+    return (int) syscall(__NR_io_uring_setup, entries, params);
+  }
+
+  static int uringEnter (int fd, unsigned int submit) {
+    return (int) syscall(__NR_io_uring_enter, fd, submit, 0, 0, nullptr, 0);
+  }
+
+  static int uringRegister (int fd, unsigned int opcode, void *arg, unsigned int count) {
+    return (int) syscall(__NR_io_uring_register, fd, opcode, arg, count);
+  }
+
+  static bool isSupported (int fd) {
+    static const int required[] = {
+      IORING_OP_READV,
+      IORING_OP_WRITEV,
+      IORING_OP_OPENAT,
+      IORING_OP_CLOSE,
+      IORING_OP_STATX
+    };
+
+    const auto size = sizeof(struct io_uring_probe) +
+      IORING_OP_LAST * sizeof(struct io_uring_probe_op);
+
+    Vector<char> bytes(size, 0);
+    auto probe = (struct io_uring_probe *) bytes.data();
+
+    if (uringRegister(fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0) {
+      return false;
+    }
+
+    for (auto op : required) {
+      if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // gives queued entries to the kernel, entries the kernel could not take
+  // now are given again at the next flush
+  static void flush (Core::FS::URing::Ring *ring) {
+    while (ring->queued > 0) {
+      auto submitted = uringEnter(ring->fd, ring->queued);
+
+      if (submitted < 0 && errno == EINTR) {
+        continue;
+      }
+
+      if (submitted <= 0) {
+        break;
+      }
+
+      ring->queued -= submitted;
+    }
+  }
+
+  static void reap (Core::FS::URing *uring) {
+    auto ring = uring->ring;
+    uint64_t count = 0;
+
+    // the eventfd is only a wake up, the completion queue is the source of
+    // truth and is drained regardless of what was read here
+    while (::read(ring->eventfd, &count, sizeof(count)) < 0 && errno == EINTR);
+
+    while (true) {
+      auto head = *ring->cqHead;
+      auto tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+
+      if (head == tail) {
+        break;
+      }
+
+      auto cqe = &ring->cqes[head & ring->cqMask];
+      auto operation = (Core::FS::URing::Operation *) cqe->user_data;
+      auto result = cqe->res;
+
+      __atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+
+      auto req = operation->req;
+      auto cb = operation->cb;
+
+      req->result = result;
+
+      if (req->fs_type == UV_FS_STAT && result >= 0) {
+        const auto& statx = operation->statx;
+        auto& stats = req->statbuf;
+
+        stats.st_dev = makedev(statx.stx_dev_major, statx.stx_dev_minor);
+        stats.st_mode = statx.stx_mode;
+        stats.st_nlink = statx.stx_nlink;
+        stats.st_uid = statx.stx_uid;
+        stats.st_gid = statx.stx_gid;
+        stats.st_rdev = makedev(statx.stx_rdev_major, statx.stx_rdev_minor);
+        stats.st_ino = statx.stx_ino;
+        stats.st_size = statx.stx_size;
+        stats.st_blksize = statx.stx_blksize;
+        stats.st_blocks = statx.stx_blocks;
+        stats.st_flags = 0;
+        stats.st_gen = 0;
+        stats.st_atim = { statx.stx_atime.tv_sec, statx.stx_atime.tv_nsec };
+        stats.st_mtim = { statx.stx_mtime.tv_sec, statx.stx_mtime.tv_nsec };
+        stats.st_ctim = { statx.stx_ctime.tv_sec, statx.stx_ctime.tv_nsec };
+        stats.st_birthtim = { statx.stx_btime.tv_sec, statx.stx_btime.tv_nsec };
+        req->ptr = &req->statbuf;
+      }
+
+      // the operation is reusable before `cb` runs, `cb` may queue more
+      operation->req = nullptr;
+      operation->cb = nullptr;
+      ring->operations.push_back(operation);
+      ring->pending--;
+      uring->completed++;
+
+      if (ring->pending == 0) {
+        uv_unref((uv_handle_t *) &ring->poll);
+      }
+
+      cb(req);
+    }
+  }
+
+  Core::FS::URing::~URing () {
+    // the loop is gone by now, so its handles are not closed
+    delete this->ring;
+  }
+
+  bool Core::FS::URing::init (uv_loop_t *loop) {
+    static auto userConfig = SSC::getUserConfig();
+
+    if (this->initialized) {
+      return this->ring != nullptr;
+    }
+
+    this->initialized = true;
+
+    if (userConfig["linux_io_uring"] != "true") {
+      return false;
+    }
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    auto ring = new Ring();
+    ring->fd = uringSetup(URING_ENTRIES, &params);
+
+    if (ring->fd < 0 || !isSupported(ring->fd)) {
+      delete ring;
+      return false;
+    }
+
+    ring->features = params.features;
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      ring->sqRingSize = std::max(ring->sqRingSize, ring->cqRingSize);
+    }
+
+    ring->sqRing = mmap(
+      nullptr,
+      ring->sqRingSize,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      ring->fd,
+      IORING_OFF_SQ_RING
+    );
+
+    if (ring->sqRing == MAP_FAILED) {
+      delete ring;
+      return false;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      ring->cqRing = ring->sqRing;
+    } else {
+      ring->cqRing = mmap(
+        nullptr,
+        ring->cqRingSize,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE,
+        ring->fd,
+        IORING_OFF_CQ_RING
+      );
+    }
+
+    ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe *) mmap(
+      nullptr,
+      ring->sqesSize,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      ring->fd,
+      IORING_OFF_SQES
+    );
+
+    if (ring->cqRing == MAP_FAILED || ring->sqes == MAP_FAILED) {
+      delete ring;
+      return false;
+    }
+
+    auto sq = (char *) ring->sqRing;
+    ring->sqHead = (unsigned int *) (sq + params.sq_off.head);
+    ring->sqTail = (unsigned int *) (sq + params.sq_off.tail);
+    ring->sqArray = (unsigned int *) (sq + params.sq_off.array);
+    ring->sqMask = *(unsigned int *) (sq + params.sq_off.ring_mask);
+    ring->sqEntries = *(unsigned int *) (sq + params.sq_off.ring_entries);
+
+    auto cq = (char *) ring->cqRing;
+    ring->cqHead = (unsigned int *) (cq + params.cq_off.head);
+    ring->cqTail = (unsigned int *) (cq + params.cq_off.tail);
+    ring->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+    ring->cqMask = *(unsigned int *) (cq + params.cq_off.ring_mask);
+    ring->cqEntries = *(unsigned int *) (cq + params.cq_off.ring_entries);
+
+    ring->eventfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (
+      ring->eventfd < 0 ||
+      uringRegister(ring->fd, IORING_REGISTER_EVENTFD, &ring->eventfd, 1) < 0
+    ) {
+      delete ring;
+      return false;
+    }
+
+    this->ring = ring;
+
+    ring->poll.data = this;
+    uv_poll_init(loop, &ring->poll, ring->eventfd);
+    uv_poll_start(&ring->poll, UV_READABLE, [](uv_poll_t *handle, int status, int events) {
+      reap(reinterpret_cast<URing *>(handle->data));
+    });
+
+    // the poll handle only keeps the loop alive while requests are pending
+    uv_unref((uv_handle_t *) &ring->poll);
+
+    ring->prepare.data = ring;
+    uv_prepare_init(loop, &ring->prepare);
+    uv_prepare_start(&ring->prepare, [](uv_prepare_t *handle) {
+      flush(reinterpret_cast<Ring *>(handle->data));
+    });
+    uv_unref((uv_handle_t *) &ring->prepare);
+
+    ring->check.data = ring;
+    uv_check_init(loop, &ring->check);
+    uv_check_start(&ring->check, [](uv_check_t *handle) {
+      flush(reinterpret_cast<Ring *>(handle->data));
+    });
+    uv_unref((uv_handle_t *) &ring->check);
+
+    return true;
+  }
+
+  bool Core::FS::URing::isAvailable () {
+    return this->ring != nullptr;
+  }
+
+  // an entry in the submission queue and the operation it completes, or
+  // `nullptr` when the ring is unavailable or full
+  static struct io_uring_sqe* queue (
+    Core::FS::URing *uring,
+    uv_loop_t *loop,
+    uv_fs_t *req,
+    uv_fs_type type,
+    uv_fs_cb cb,
+    Core::FS::URing::Operation **operation
+  ) {
+    if (!uring->init(loop) || cb == nullptr) {
+      return nullptr;
+    }
+
+    auto ring = uring->ring;
+    auto head = __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+    auto tail = *ring->sqTail;
+
+    // every pending operation has a completion queue entry waiting for it
+    if (tail - head >= ring->sqEntries || ring->pending >= ring->cqEntries) {
+      return nullptr;
+    }
+
+    if (ring->operations.size() > 0) {
+      *operation = ring->operations.back();
+      ring->operations.pop_back();
+    } else {
+      *operation = new Core::FS::URing::Operation();
+    }
+
+    // `req` is completed like a `uv_fs_*()` request, so it is left in a
+    // state `uv_fs_req_cleanup()` and `uv_fs_get_statbuf()` understand
+    auto data = req->data;
+    memset(req, 0, sizeof(uv_fs_t));
+    req->data = data;
+    req->type = UV_FS;
+    req->fs_type = type;
+    req->loop = loop;
+    req->cb = cb;
+
+    (*operation)->req = req;
+    (*operation)->cb = cb;
+
+    auto index = tail & ring->sqMask;
+    auto sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->user_data = (uint64_t) *operation;
+    ring->sqArray[index] = index;
+
+    __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+    ring->queued++;
+    ring->pending++;
+    uring->submitted++;
+
+    if (ring->pending == 1) {
+      uv_ref((uv_handle_t *) &ring->poll);
+    }
+
+    return sqe;
+  }
+
+  int Core::FS::URing::open (
+    uv_loop_t *loop,
+    uv_fs_t *req,
+    const char *path,
+    int flags,
+    int mode,
+    uv_fs_cb cb
+  ) {
+    Operation *operation = nullptr;
+    auto sqe = queue(this, loop, req, UV_FS_OPEN, cb, &operation);
+
+    if (sqe == nullptr) {
+      this->fallbacks++;
+      return uv_fs_open(loop, req, path, flags, mode, cb);
+    }
+
+    // as `uv_fs_open()` does
+    req->flags = flags;
+    req->mode = mode;
+
+    operation->path = path;
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t) operation->path.c_str();
+    sqe->len = mode;
+    sqe->open_flags = flags | O_CLOEXEC;
+    return 0;
+  }
+
+  int Core::FS::URing::close (uv_loop_t *loop, uv_fs_t *req, uv_file fd, uv_fs_cb cb) {
+    Operation *operation = nullptr;
+    auto sqe = queue(this, loop, req, UV_FS_CLOSE, cb, &operation);
+
+    if (sqe == nullptr) {
+      this->fallbacks++;
+      return uv_fs_close(loop, req, fd, cb);
+    }
+
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = fd;
+    return 0;
+  }
+
+  static int queueVectored (
+    Core::FS::URing *uring,
+    uv_loop_t *loop,
+    uv_fs_t *req,
+    uv_fs_type type,
+    uv_file fd,
+    const uv_buf_t bufs[],
+    unsigned int nbufs,
+    int64_t offset,
+    uv_fs_cb cb
+  ) {
+    // reading or writing at the current position needs the kernel to
+    // support it, otherwise the request goes to the threadpool
+    if (
+      offset < 0 &&
+      uring->init(loop) &&
+      !(uring->ring->features & IORING_FEAT_RW_CUR_POS)
+    ) {
+      return -1;
+    }
+
+    Core::FS::URing::Operation *operation = nullptr;
+    auto sqe = queue(uring, loop, req, type, cb, &operation);
+
+    if (sqe == nullptr) {
+      return -1;
+    }
+
+    operation->iovecs.resize(nbufs);
+    for (unsigned int i = 0; i < nbufs; ++i) {
+      operation->iovecs[i].iov_base = bufs[i].base;
+      operation->iovecs[i].iov_len = bufs[i].len;
+    }
+
+    sqe->opcode = type == UV_FS_READ ? IORING_OP_READV : IORING_OP_WRITEV;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) operation->iovecs.data();
+    sqe->len = nbufs;
+    sqe->off = (uint64_t) offset;
+    return 0;
+  }
+
+  int Core::FS::URing::read (
+    uv_loop_t *loop,
+    uv_fs_t *req,
+    uv_file fd,
+    const uv_buf_t bufs[],
+    unsigned int nbufs,
+    int64_t offset,
+    uv_fs_cb cb
+  ) {
+    if (queueVectored(this, loop, req, UV_FS_READ, fd, bufs, nbufs, offset, cb) < 0) {
+      this->fallbacks++;
+      return uv_fs_read(loop, req, fd, bufs, nbufs, offset, cb);
+    }
+
+    return 0;
+  }
+
+  int Core::FS::URing::write (
+    uv_loop_t *loop,
+    uv_fs_t *req,
+    uv_file fd,
+    const uv_buf_t bufs[],
+    unsigned int nbufs,
+    int64_t offset,
+    uv_fs_cb cb
+  ) {
+    if (queueVectored(this, loop, req, UV_FS_WRITE, fd, bufs, nbufs, offset, cb) < 0) {
+      this->fallbacks++;
+      return uv_fs_write(loop, req, fd, bufs, nbufs, offset, cb);
+    }
+
+    return 0;
+  }
+
+  int Core::FS::URing::stat (uv_loop_t *loop, uv_fs_t *req, const char *path, uv_fs_cb cb) {
+    Operation *operation = nullptr;
+    auto sqe = queue(this, loop, req, UV_FS_STAT, cb, &operation);
+
+    if (sqe == nullptr) {
+      this->fallbacks++;
+      return uv_fs_stat(loop, req, path, cb);
+    }
+
+    operation->path = path;
+    sqe->opcode = IORING_OP_STATX;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t) operation->path.c_str();
+    sqe->len = STATX_BASIC_STATS | STATX_BTIME;
+    sqe->off = (uint64_t) &operation->statx;
+    sqe->statx_flags = 0;
+    return 0;
+  }
+#else
+  // io_uring is Linux only, every request goes to the threadpool
+  struct Core::FS::URing::Ring {};
+
+  Core::FS::URing::~URing () {}
+
+  bool Core::FS::URing::init (uv_loop_t *loop) {
+    this->initialized = true;
+    return false;
+  }
+
+  bool Core::FS::URing::isAvailable () {
+    return false;
+  }
+
+  int Core::FS::URing::open (
+    uv_loop_t *loop,
+    uv_fs_t *req,
+    const char *path,
+    int flags,
+    int mode,
+    uv_fs_cb cb
+  ) {
+    return uv_fs_open(loop, req, path, flags, mode, cb);
+  }
+
+  int Core::FS::URing::close (uv_loop_t *loop, uv_fs_t *req, uv_file fd, uv_fs_cb cb) {
+    return uv_fs_close(loop, req, fd, cb);
+  }
+
+  int Core::FS::URing::read (
+    uv_loop_t *loop,
+    uv_fs_t *req,
+    uv_file fd,
+    const uv_buf_t bufs[],
+    unsigned int nbufs,
+    int64_t offset,
+    uv_fs_cb cb
+  ) {
+    return uv_fs_read(loop, req, fd, bufs, nbufs, offset, cb);
+  }
+
+  int Core::FS::URing::write (
+    uv_loop_t *loop,
+    uv_fs_t *req,
+    uv_file fd,
+    const uv_buf_t bufs[],
+    unsigned int nbufs,
+    int64_t offset,
+    uv_fs_cb cb
+  ) {
+    return uv_fs_write(loop, req, fd, bufs, nbufs, offset, cb);
+  }
+
+  int Core::FS::URing::stat (uv_loop_t *loop, uv_fs_t *req, const char *path, uv_fs_cb cb) {
+    return uv_fs_stat(loop, req, path, cb);
+  }
+#endif
+
+  JSON::Object Core::FS::URing::json () {
+    return JSON::Object::Entries {
+      {"available", this->isAvailable()},
+      {"submitted", this->submitted},
+      {"completed", this->completed},
+      {"fallbacks", this->fallbacks}
+    };
+  }
+}
@@ -0,0 +1,361 @@
+#include "core.hh"
+
+namespace SSC {
+  // `name` in `directory`, both relative to the watched path
+  static String joinWatchPath (const String& directory, const String& name) {
+    if (directory.size() == 0) {
+      return name;
+    }
+
+    if (name.size() == 0) {
+      return directory;
+    }
+
+    return directory + "/" + name;
+  }
+
+  Core::FS::Watcher::Watcher (
+    FS *fs,
+    uv_loop_t *loop,
+    uint64_t id,
+    const String& path,
+    bool recursive,
+    uint64_t window,
+    Module::Callback callback
+  ) {
+    this->fs = fs;
+    this->loop = loop;
+    this->id = id;
+    this->path = path;
+    this->recursive = recursive;
+    this->window = window;
+    this->callback = callback;
+
+    while (this->path.size() > 1 && this->path.ends_with("/")) {
+      this->path.pop_back();
+    }
+
+    uv_timer_init(loop, &this->timer);
+    this->timer.data = (void *) this;
+    this->pending++;
+  }
+
+  int Core::FS::Watcher::start (const std::function<void()> onStarted) {
+    auto err = this->add("");
+
+    if (err < 0) {
+      return err;
+    }
+
+  #if defined(__linux__)
+    // started once every directory under `path` is watched
+    if (this->recursive) {
+      this->scan({ "" }, false, onStarted);
+      return 0;
+    }
+  #endif
+
+    onStarted();
+    return 0;
+  }
+
+  int Core::FS::Watcher::add (const String& directory) {
+    if (this->handles.contains(directory)) {
+      return 0;
+    }
+
+    auto handle = new Handle();
+    auto target = directory.size() > 0
+      ? this->path + "/" + directory
+      : this->path;
+
+    auto flags = 0;
+
+  #if !defined(__linux__)
+    if (this->recursive) {
+      flags |= UV_FS_EVENT_RECURSIVE;
+    }
+  #endif
+
+    handle->watcher = this;
+    handle->path = directory;
+    handle->handle.data = (void *) handle;
+    uv_fs_event_init(this->loop, &handle->handle);
+
+    auto err = uv_fs_event_start(
+      &handle->handle,
+      [](uv_fs_event_t *req, const char *filename, int events, int status) {
+        auto handle = (Handle *) req->data;
+        auto watcher = handle->watcher;
+
+        if (watcher->closed || status < 0) {
+          return;
+        }
+
+        const auto path = joinWatchPath(
+          handle->path,
+          filename != nullptr ? String(filename) : String("")
+        );
+
+      #if defined(__linux__)
+        // a renamed path may be a directory that came or went
+        if (watcher->recursive && (events & UV_RENAME)) {
+          watcher->renamed.insert(path);
+        }
+      #endif
+
+        watcher->change(path, events);
+      },
+      target.c_str(),
+      flags
+    );
+
+    if (err < 0) {
+      uv_close((uv_handle_t *) &handle->handle, [](uv_handle_t *req) {
+        delete (Handle *) req->data;
+      });
+
+      return err;
+    }
+
+    this->handles[directory] = handle;
+    this->pending++;
+    return 0;
+  }
+
+  void Core::FS::Watcher::remove (const String& directory) {
+    auto entry = this->handles.begin();
+
+    while (entry != this->handles.end()) {
+      const auto& path = entry->first;
+
+      if (
+        directory.size() > 0 &&
+        path != directory &&
+        !path.starts_with(directory + "/")
+      ) {
+        ++entry;
+        continue;
+      }
+
+      auto handle = entry->second;
+      entry = this->handles.erase(entry);
+
+      uv_close((uv_handle_t *) &handle->handle, [](uv_handle_t *req) {
+        auto handle = (Handle *) req->data;
+        auto watcher = handle->watcher;
+        delete handle;
+        watcher->release();
+      });
+    }
+  }
+
+  void Core::FS::Watcher::scan (
+    const Vector<String>& paths,
+    bool report,
+    const std::function<void()> onScanned
+  ) {
+    auto scan = new Scan();
+    scan->watcher = this;
+    scan->root = this->path;
+    scan->paths = paths;
+    scan->report = report;
+    scan->callback = onScanned;
+    scan->req.data = (void *) scan;
+
+    this->pending++;
+
+    uv_queue_work(
+      this->loop,
+      &scan->req,
+      [](uv_work_t *req) {
+        using std::filesystem::directory_options;
+        using std::filesystem::recursive_directory_iterator;
+
+        auto scan = (Scan *) req->data;
+
+        for (const auto& path : scan->paths) {
+          const auto target = path.size() > 0
+            ? scan->root + "/" + path
+            : scan->root;
+
+          std::error_code error;
+          const auto status = std::filesystem::symlink_status(target, error);
+
+          if (error || !std::filesystem::exists(status)) {
+            scan->removed.push_back(path);
+            continue;
+          }
+
+          if (!std::filesystem::is_directory(status)) {
+            continue;
+          }
+
+          scan->directories.push_back(path);
+
+          // entries are named relative to `target`, so its length is skipped
+          const auto prefix = target.ends_with("/")
+            ? target.size()
+            : target.size() + 1;
+
+          auto entries = recursive_directory_iterator(
+            target,
+            directory_options::skip_permission_denied,
+            error
+          );
+
+          while (!error && entries != recursive_directory_iterator()) {
+            const auto name = joinWatchPath(
+              path,
+              entries->path().string().substr(prefix)
+            );
+
+            // symbolic links to directories are not followed
+            std::error_code statusError;
+            if (std::filesystem::is_directory(entries->symlink_status(statusError))) {
+              scan->directories.push_back(name);
+            }
+
+            if (scan->report) {
+              scan->entries.push_back(name);
+            }
+
+            entries.increment(error);
+          }
+        }
+      },
+      [](uv_work_t *req, int status) {
+        auto scan = (Scan *) req->data;
+        auto watcher = scan->watcher;
+
+        if (!watcher->closed) {
+          for (const auto& path : scan->removed) {
+            watcher->remove(path);
+          }
+
+          // a directory that is gone by now is simply not watched
+          for (const auto& directory : scan->directories) {
+            watcher->add(directory);
+          }
+
+          // entries of a directory that came may have changed before it
+          // was watched, so they are reported as changes of their own
+          for (const auto& entry : scan->entries) {
+            watcher->change(entry, UV_RENAME);
+          }
+        }
+
+        if (scan->callback != nullptr) {
+          scan->callback();
+        }
+
+        delete scan;
+        watcher->release();
+      }
+    );
+  }
+
+  void Core::FS::Watcher::change (const String& path, int events) {
+    const auto now = uv_now(this->loop);
+
+    if (this->changes.size() == 0) {
+      this->firstChangeAt = now;
+    }
+
+    this->changes[path] |= events;
+    this->events++;
+    this->fs->watchEvents++;
+
+    if (this->changes.size() >= MAX_WATCH_BATCH) {
+      return this->flush();
+    }
+
+    const auto due = std::min(
+      now + this->window,
+      this->firstChangeAt + this->window * WATCH_MAX_WINDOWS
+    );
+
+    uv_timer_start(
+      &this->timer,
+      [](uv_timer_t *timer) {
+        ((Watcher *) timer->data)->flush();
+      },
+      due > now ? due - now : 0,
+      0
+    );
+  }
+
+  void Core::FS::Watcher::flush () {
+    uv_timer_stop(&this->timer);
+
+    if (this->closed) {
+      return;
+    }
+
+    if (this->renamed.size() > 0) {
+      auto paths = Vector<String>(this->renamed.begin(), this->renamed.end());
+      this->renamed.clear();
+      this->scan(paths, true, nullptr);
+    }
+
+    if (this->changes.size() == 0) {
+      return;
+    }
+
+    JSON::Array events;
+
+    for (const auto& change : this->changes) {
+      events.push(JSON::Object::Entries {
+        {"type", (change.second & UV_RENAME) ? "rename" : "change"},
+        {"path", change.first}
+      });
+    }
+
+    this->changes.clear();
+    this->batches++;
+    this->fs->watchBatches++;
+
+    auto json = JSON::Object::Entries {
+      {"source", "fs.watch"},
+      {"data", JSON::Object::Entries {
+        {"id", std::to_string(this->id)},
+        {"events", events}
+      }}
+    };
+
+    this->callback("-1", json, Post{});
+  }
+
+  void Core::FS::Watcher::close () {
+    if (this->closed) {
+      return;
+    }
+
+    this->closed = true;
+    this->changes.clear();
+    this->renamed.clear();
+    this->remove("");
+
+    uv_close((uv_handle_t *) &this->timer, [](uv_handle_t *req) {
+      ((Watcher *) req->data)->release();
+    });
+  }
+
+  void Core::FS::Watcher::release () {
+    if (--this->pending == 0 && this->closed) {
+      delete this;
+    }
+  }
+
+  JSON::Object Core::FS::Watcher::json () {
+    return JSON::Object::Entries {
+      {"id", std::to_string(this->id)},
+      {"path", this->path},
+      {"recursive", this->recursive},
+      {"window", this->window},
+      {"handles", this->handles.size()},
+      {"events", this->events},
+      {"batches", this->batches}
+    };
+  }
+}
@@ -27,7 +27,8 @@ const char* sapi_env_get (
     return nullptr;
   }
 
-  auto pointer = ctx->memory.alloc<char>(value.size());
+  // zeroed, so the copy is null terminated
+  auto pointer = ctx->memory.allocArray<char>(value.size() + 1);
   return reinterpret_cast<const char*>(
     memcpy(pointer, value.c_str(), value.size())
   );
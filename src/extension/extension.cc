@@ -22,11 +22,6 @@ namespace SSC {
     GetModuleFileNameW(NULL, filename, MAX_PATH);
     auto path = fs::path { filename }.remove_filename();
     cwd = path.string();
-    size_t last_pos = 0;
-    while ((last_pos = cwd.find('\\', last_pos)) != std::string::npos) {
-      cwd.replace(last_pos, 1, "\\\\");
-      last_pos += 2;
-    }
   #endif
 
   #ifndef _WIN32
@@ -36,8 +31,10 @@ namespace SSC {
     return cwd;
   }
 
+  Extension::Context::Memory::Stats Extension::Context::Memory::stats;
+
   // explicit template instantiations
-  template char* SSC::Extension::Context::Memory::alloc<char> (size_t);
+  template char* SSC::Extension::Context::Memory::allocArray<char> (size_t);
   template sapi_context_t*
   SSC::Extension::Context::Memory::alloc<sapi_context_t> ();
 
@@ -88,6 +85,11 @@ namespace SSC {
     const char*
   );
 
+  template sapi_json_null_t*
+  SSC::Extension::Context::Memory::alloc<sapi_json_null_t> (
+    sapi_context_t*
+  );
+
   Extension::Context::Context (const Extension* extension) {
     this->extension = extension;
     this->router = extension->context.router;
@@ -188,15 +190,49 @@ namespace SSC {
     this->release();
   }
 
+  void* Extension::Context::Memory::allocate (size_t size, size_t alignment) {
+    Lock lock(this->mutex);
+
+    if (this->arena == nullptr) {
+      this->arena = new JSON::Arena();
+    }
+
+    return this->arena->allocate(size, alignment);
+  }
+
   void Extension::Context::Memory::release () {
     Lock lock(this->mutex);
-    if (this->pool.size() > 0) {
-      for (const auto& releaseCallback: this->pool) {
-        releaseCallback();
-      }
 
-      this->pool.clear();
+    if (this->arena == nullptr) {
+      return;
+    }
+
+    // most recently allocated objects are destroyed first
+    auto destructor = this->destructors;
+    while (destructor != nullptr) {
+      auto next = destructor->next;
+      destructor->destroy(destructor->pointer);
+      destructor = next;
     }
+
+    uint64_t blocks = 0;
+    for (auto block = this->arena->blocks; block != nullptr; block = block->next) {
+      blocks++;
+    }
+
+    stats.releases.fetch_add(1, std::memory_order_relaxed);
+    stats.allocations.fetch_add(
+      this->arena->allocations - this->destructorsCount,
+      std::memory_order_relaxed
+    );
+    stats.destructors.fetch_add(this->destructorsCount, std::memory_order_relaxed);
+    stats.bytes.fetch_add(this->arena->bytes, std::memory_order_relaxed);
+    stats.blocks.fetch_add(blocks, std::memory_order_relaxed);
+
+    this->arena->release();
+    this->arena = nullptr;
+    this->destructors = nullptr;
+    this->destructorsCount = 0;
   }
 
   String Extension::getExtensionsDirectory (const String& name) {
@@ -208,11 +244,6 @@ namespace SSC {
   #endif
   }
 
-  void Extension::Context::Memory::push (std::function<void()> callback) {
-    Lock lock(this->mutex);
-    this->pool.push_back(callback);
-  }
-
   Extension::Extension (const String& name, const Initializer initializer)
     : name(name), initializer(initializer)
   {
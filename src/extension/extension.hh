@@ -5,6 +5,9 @@
 #  include <dlfcn.h>
 #endif
 
+#include <condition_variable>
+#include <deque>
+
 #include "../../include/socket/extension.h"
 #include "../process/process.hh"
 #include "../core/json.hh"
@@ -38,33 +41,84 @@ namespace SSC {
           {}
         };
 
+        // Memory for everything an extension allocates through a context
+        // (`sapi_json_*` values, results, string copies, ...) is bump
+        // allocated from an arena. Objects that need a destructor are linked
+        // into a typed destructor list in the same arena, so `release()`
+        // runs the destructors and frees the arena blocks in one pass.
         struct Memory {
-          std::vector<std::function<void()>> pool;
+          struct Destructor {
+            void (*destroy)(void*) = nullptr;
+            void* pointer = nullptr;
+            Destructor* next = nullptr;
+          };
+
+          // totals over every released context, see `extension.stats`
+          struct Stats {
+            std::atomic<uint64_t> releases = 0;
+            std::atomic<uint64_t> allocations = 0;
+            std::atomic<uint64_t> destructors = 0;
+            std::atomic<uint64_t> bytes = 0;
+            std::atomic<uint64_t> blocks = 0;
+          };
+
+          static Stats stats;
+
+          JSON::Arena* arena = nullptr;
+          Destructor* destructors = nullptr;
+          size_t destructorsCount = 0;
           Mutex mutex;
 
+          Memory () = default;
+          Memory (const Memory&) = delete;
           ~Memory ();
+
           void release ();
-          void push (std::function<void()> callback);
+          void* allocate (size_t size, size_t alignment);
+
+          template <typename T> static void destroy (void* pointer) {
+            reinterpret_cast<T*>(pointer)->~T();
+          }
+
+          template <typename T, typename... Args> T* construct (Args&&... args) {
+            Lock lock(this->mutex);
+            auto memory = new (this->allocate(sizeof(T), alignof(T))) T(
+              std::forward<Args>(args)...
+            );
+
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+              auto destructor = new (this->allocate(
+                sizeof(Destructor),
+                alignof(Destructor)
+              )) Destructor { &destroy<T>, memory, this->destructors };
+
+              this->destructors = destructor;
+              this->destructorsCount++;
+            }
+
+            return memory;
+          }
+
           template <typename T, typename C, typename... Args> T* alloc (
             C* ctx,
             Args... args
           ) {
-            auto memory = new T(args...);
+            auto memory = construct<T>(args...);
             memory->context = ctx;
-            push([memory]() { delete memory; });
             return memory;
           }
 
           template <typename T, typename... Args> T* alloc (Args... args) {
-            auto memory = new T(args...);
-            push([memory]() { delete memory; });
-            return memory;
+            return construct<T>(args...);
           }
 
-          template <typename T> T* alloc (unsigned int size) {
-            auto memory = new T[size]{0};
-            push([memory]() { delete [] memory; });
-            return memory;
+          // `size` zeroed values of a trivial type `T`
+          template <typename T> T* allocArray (size_t size) {
+            static_assert(std::is_trivial_v<T>);
+            Lock lock(this->mutex);
+            auto memory = this->allocate(sizeof(T) * size, alignof(T));
+            std::memset(memory, 0, sizeof(T) * size);
+            return reinterpret_cast<T*>(memory);
           }
         };
 
@@ -151,6 +205,28 @@ namespace SSC {
         const void* data = nullptr // owned by caller
       );
 
+      // a fixed number of threads shared by all extensions that run the
+      // work submitted with `sapi_work_submit()`, started on first use
+      class WorkPool {
+        public:
+          using Task = std::function<void()>;
+
+          static WorkPool& shared ();
+
+          const size_t size;
+
+          WorkPool (size_t size);
+          ~WorkPool ();
+          void enqueue (Task task);
+
+        private:
+          Mutex mutex;
+          std::condition_variable_any condition;
+          std::deque<Task> tasks;
+          Vector<Thread> threads;
+          bool stopped = false;
+      };
+
       Extension (const String& name, const Initializer initializer);
       Extension (Extension& extension);
   };
@@ -198,6 +274,30 @@ extern "C" {
       {}
   };
 
+  struct sapi_work_queue {
+    sapi_context_t* context = nullptr;
+    unsigned int concurrency = 0;
+    bool destroyed = false;
+    // one for the queue and one for each work item that has not completed
+    std::atomic<size_t> references = 1;
+    std::deque<sapi_work_t*> pending;
+    SSC::Vector<sapi_work_t*> scheduled;
+    SSC::Mutex mutex;
+
+    void release ();
+  };
+
+  struct sapi_work {
+    enum class State { Pending, Running, Finished };
+
+    sapi_work_queue_t* queue = nullptr;
+    sapi_work_callback_t callback = nullptr;
+    sapi_work_complete_callback_t oncomplete = nullptr;
+    void* data = nullptr;
+    std::atomic<State> state = State::Pending;
+    std::atomic<bool> cancelled = false;
+  };
+
   struct sapi_ipc_router : public SSC::IPC::Router {};
   struct sapi_ipc_message : public SSC::IPC::Message {};
 
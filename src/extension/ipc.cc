@@ -1,5 +1,39 @@
 #include "extension.hh"
 
+struct OwnedBytes {
+  sapi_ipc_bytes_free_callback_t free = nullptr;
+  void* data = nullptr;
+};
+
+static void freeOwnedBytes (char* body, void* data) {
+  auto owned = reinterpret_cast<OwnedBytes*>(data);
+
+  if (owned->free != nullptr) {
+    owned->free(reinterpret_cast<unsigned char*>(body), owned->data);
+  }
+
+  delete owned;
+}
+
+// a post that hands `bytes` back to the extension when it is freed
+static SSC::Post createOwnedPost (
+  const unsigned int size,
+  unsigned char* bytes,
+  sapi_ipc_bytes_free_callback_t free,
+  void* data
+) {
+  SSC::Post post;
+
+  if (bytes != nullptr) {
+    post.body = reinterpret_cast<char*>(bytes);
+    post.length = size;
+    post.deallocate = freeOwnedBytes;
+    post.deallocateData = new OwnedBytes { free, data };
+  }
+
+  return post;
+}
+
 void sapi_ipc_router_map (
   sapi_context_t* ctx,
   const char* name,
@@ -41,6 +75,44 @@ void sapi_ipc_router_map (
   });
 }
 
+void sapi_ipc_router_map_binary (
+  sapi_context_t* ctx,
+  const char* name,
+  sapi_ipc_router_binary_callback_t callback,
+  const void* data
+) {
+  if (
+    ctx == nullptr ||
+    ctx->router == nullptr ||
+    ctx->state > SSC::Extension::Context::State::Init
+  ) {
+    return;
+  }
+
+  if (!ctx->isAllowed("ipc_router_map")) {
+    sapi_debug(ctx, "'ipc_router_map' is not allowed.");
+    return;
+  }
+
+  sapi_context_t context(ctx);
+  ctx->router->mapBinary(name, [data, callback, context](
+    auto& message,
+    auto router,
+    auto reply
+  ) {
+    auto ctx = new sapi_context_t(context);
+    auto msg = SSC::IPC::Message(message);
+    ctx->internal = ctx->memory.alloc<SSC::IPC::Router::ReplyCallback>(reply);
+    callback(
+      ctx,
+      (sapi_ipc_message_t*) &msg,
+      reinterpret_cast<const unsigned char*>(msg.buffer.bytes),
+      msg.buffer.size,
+      reinterpret_cast<const sapi_ipc_router_t*>(router)
+    );
+  });
+}
+
 void sapi_ipc_router_unmap (sapi_context_t* ctx, const char* name) {
   if (ctx == nullptr || ctx->router == nullptr) {
     return;
@@ -151,6 +223,30 @@ bool sapi_ipc_send_bytes (
   );
 }
 
+bool sapi_ipc_send_bytes_owned (
+  sapi_context_t* ctx,
+  const char* seq,
+  const unsigned int size,
+  unsigned char* bytes,
+  const char* headers,
+  sapi_ipc_bytes_free_callback_t free,
+  void* data
+) {
+  auto post = createOwnedPost(size, bytes, free, data);
+
+  if (ctx == nullptr || ctx->router == nullptr || bytes == nullptr || size == 0) {
+    SSC::freePostBody(post);
+    return false;
+  }
+
+  post.headers = headers ? headers : "";
+  return ctx->router->send(
+    seq == nullptr || SSC::String(seq) == "" ? "-1" : seq,
+    "",
+    post
+  );
+}
+
 bool sapi_ipc_send_json (
   sapi_context_t* ctx,
   const char* seq,
@@ -426,12 +522,53 @@ void sapi_ipc_result_set_bytes (
   const unsigned char* bytes
 ) {
   if (result && size && bytes) {
-    auto pointer = const_cast<char*>(reinterpret_cast<const char*>(bytes));
+    // `bytes` were allocated with `new[]`, a post without `deallocate` is
+    // freed with `delete[]`
+    SSC::freePostBody(result->post);
+    result->post.deallocate = nullptr;
+    result->post.deallocateData = nullptr;
+    result->post.length = size;
+    result->post.body = const_cast<char*>(reinterpret_cast<const char*>(bytes));
+  }
+}
+
+void sapi_ipc_result_set_bytes_copy (
+  sapi_ipc_result_t* result,
+  const unsigned int size,
+  const unsigned char* bytes
+) {
+  if (result && size && bytes) {
+    auto body = new char[size];
+    memcpy(body, bytes, size);
+    SSC::freePostBody(result->post);
+    result->post.deallocate = nullptr;
+    result->post.deallocateData = nullptr;
     result->post.length = size;
-    result->post.body = pointer;
+    result->post.body = body;
   }
 }
 
+void sapi_ipc_result_set_bytes_owned (
+  sapi_ipc_result_t* result,
+  const unsigned int size,
+  unsigned char* bytes,
+  sapi_ipc_bytes_free_callback_t free,
+  void* data
+) {
+  auto post = createOwnedPost(size, bytes, free, data);
+
+  if (result == nullptr || size == 0 || bytes == nullptr) {
+    SSC::freePostBody(post);
+    return;
+  }
+
+  SSC::freePostBody(result->post);
+  result->post.deallocate = post.deallocate;
+  result->post.deallocateData = post.deallocateData;
+  result->post.length = post.length;
+  result->post.body = post.body;
+}
+
 const unsigned char* sapi_ipc_result_get_bytes (
   const sapi_ipc_result_t* result
 ) {
@@ -446,6 +583,19 @@ const unsigned int sapi_ipc_result_get_bytes_size (
   return result ? result->post.length : 0;
 }
 
+void sapi_ipc_result_set_status (
+  sapi_ipc_result_t* result,
+  const int status
+) {
+  if (result) {
+    result->status = status;
+  }
+}
+
+const int sapi_ipc_result_get_status (const sapi_ipc_result_t* result) {
+  return result ? result->status : 0;
+}
+
 void sapi_ipc_result_set_header (
   sapi_ipc_result_t* result,
   const char* name,
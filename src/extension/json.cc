@@ -12,6 +12,97 @@ const sapi_json_type_t sapi_json_typeof (const sapi_json_any_t* json) {
   return SAPI_JSON_TYPE_ANY;
 }
 
+// Moves `value` into a `sapi_json_*` value owned by `ctx`. An object or
+// array that is also held elsewhere, such as one copied into another value
+// with `sapi_json_*_set()`, is copied instead, so the other holders keep
+// their entries. Scalars are stored inline in `SSC::JSON::Any`, so this is
+// also how they are handed out from objects and arrays.
+static sapi_json_any_t* toSAPIValue (
+  sapi_context_t* ctx,
+  SSC::JSON::Any value
+) {
+  // `value` itself holds one reference to its node
+  const auto shared = (
+    (value.isObject() || value.isArray()) &&
+    value.data.node->references.load(std::memory_order_acquire) > 1
+  );
+
+  switch (value.type) {
+    case SSC::JSON::Type::Object: {
+      auto object = ctx->memory.alloc<sapi_json_object_t>(ctx);
+      auto& data = value.as<SSC::JSON::Object>().data;
+      object->data = shared ? data : std::move(data);
+      return reinterpret_cast<sapi_json_any_t*>(object);
+    }
+
+    case SSC::JSON::Type::Array: {
+      auto array = ctx->memory.alloc<sapi_json_array_t>(ctx);
+      auto& data = value.as<SSC::JSON::Array>().data;
+      array->data = shared ? data : std::move(data);
+      return reinterpret_cast<sapi_json_any_t*>(array);
+    }
+
+    case SSC::JSON::Type::String: {
+      auto string = ctx->memory.alloc<sapi_json_string_t>(ctx, "");
+      string->data = std::string(value.stringView());
+      return reinterpret_cast<sapi_json_any_t*>(string);
+    }
+
+    case SSC::JSON::Type::Boolean: {
+      auto boolean = value.as<SSC::JSON::Boolean>().data;
+      return reinterpret_cast<sapi_json_any_t*>(
+        ctx->memory.alloc<sapi_json_boolean_t>(ctx, boolean)
+      );
+    }
+
+    case SSC::JSON::Type::Number: {
+      auto number = ctx->memory.alloc<sapi_json_number_t>(ctx, (int64_t) 0);
+      number->data = value.as<SSC::JSON::Number>().data;
+      return reinterpret_cast<sapi_json_any_t*>(number);
+    }
+
+    case SSC::JSON::Type::Raw: {
+      auto raw = value.as<SSC::JSON::Raw>().data;
+      return reinterpret_cast<sapi_json_any_t*>(
+        ctx->memory.alloc<sapi_json_raw_t>(ctx, raw.c_str())
+      );
+    }
+
+    default:
+      return reinterpret_cast<sapi_json_any_t*>(
+        ctx->memory.alloc<sapi_json_null_t>(ctx)
+      );
+  }
+}
+
+// Nested objects and arrays are returned in place so changes made through
+// the extension API are visible in their parent. The node reserves room for
+// the `context` of a `sapi_json_*` value directly after the value.
+static sapi_json_any_t* toSAPIReference (
+  sapi_context_t* ctx,
+  const SSC::JSON::Any& value
+) {
+  if (value.isObject()) {
+    auto node = reinterpret_cast<SSC::JSON::ValueNode<SSC::JSON::Object>*>(
+      value.data.node
+    );
+
+    node->context = ctx;
+    return reinterpret_cast<sapi_json_any_t*>(&node->value);
+  }
+
+  if (value.isArray()) {
+    auto node = reinterpret_cast<SSC::JSON::ValueNode<SSC::JSON::Array>*>(
+      value.data.node
+    );
+
+    node->context = ctx;
+    return reinterpret_cast<sapi_json_any_t*>(&node->value);
+  }
+
+  return toSAPIValue(ctx, value);
+}
+
 sapi_json_object_t* sapi_json_object_create (sapi_context_t* ctx) {
   return ctx->memory.alloc<sapi_json_object_t>(ctx);
 }
@@ -50,6 +141,29 @@ sapi_json_any_t* sapi_json_raw_from (
   );
 }
 
+// The `sapi_json_*` value types are laid out differently, so the `context`
+// after the value is found through the type of the value it carries.
+static sapi_context_t* getSAPIContext (const sapi_json_any_t* json) {
+  switch (sapi_json_typeof(json)) {
+    case SAPI_JSON_TYPE_NULL:
+      return reinterpret_cast<const sapi_json_null_t*>(json)->context;
+    case SAPI_JSON_TYPE_OBJECT:
+      return reinterpret_cast<const sapi_json_object_t*>(json)->context;
+    case SAPI_JSON_TYPE_ARRAY:
+      return reinterpret_cast<const sapi_json_array_t*>(json)->context;
+    case SAPI_JSON_TYPE_BOOLEAN:
+      return reinterpret_cast<const sapi_json_boolean_t*>(json)->context;
+    case SAPI_JSON_TYPE_NUMBER:
+      return reinterpret_cast<const sapi_json_number_t*>(json)->context;
+    case SAPI_JSON_TYPE_STRING:
+      return reinterpret_cast<const sapi_json_string_t*>(json)->context;
+    case SAPI_JSON_TYPE_RAW:
+      return reinterpret_cast<const sapi_json_raw_t*>(json)->context;
+    default:
+      return json->context;
+  }
+}
+
 const char * sapi_json_stringify (const sapi_json_any_t* json) {
   SSC::String string;
   switch (sapi_json_typeof(json)) {
@@ -85,7 +199,7 @@ const char * sapi_json_stringify (const sapi_json_any_t* json) {
   auto length = string.size();
 
   if (length > 0) {
-    auto bytes = json->context->memory.alloc<char>(length);
+    auto bytes = getSAPIContext(json)->memory.allocArray<char>(length + 1);
     if (bytes != nullptr) {
       memcpy(bytes, string.c_str(), length);
     }
@@ -96,6 +210,29 @@ const char * sapi_json_stringify (const sapi_json_any_t* json) {
   return nullptr;
 }
 
+sapi_json_any_t* sapi_json_parse (
+  sapi_context_t* ctx,
+  const char* source,
+  const unsigned int size
+) {
+  if (ctx == nullptr || source == nullptr) {
+    return nullptr;
+  }
+
+  SSC::JSON::Any value;
+
+  try {
+    value = SSC::JSON::parse(source, size > 0 ? size : strlen(source));
+  } catch (const SSC::JSON::Error& error) {
+    ctx->error.name = error.name;
+    ctx->error.message = error.message;
+    ctx->error.location = error.location;
+    return nullptr;
+  }
+
+  return toSAPIValue(ctx, std::move(value));
+}
+
 void sapi_json_object_set (
   sapi_json_object_t* json,
   const char* key,
@@ -133,8 +270,7 @@ sapi_json_any_t* sapi_json_object_get (
   const char* key
 ) {
   if (json->has(key)) {
-    auto pointer = json->data.at(key).pointer.get();
-    return reinterpret_cast<sapi_json_any_t*>(pointer);
+    return toSAPIReference(json->context, json->data.at(key));
   }
 
   return nullptr;
@@ -208,8 +344,7 @@ sapi_json_any_t* sapi_json_array_get (
   const unsigned int index
 ) {
   if (json->has(index)) {
-    auto pointer = json->data.at(index).pointer.get();
-    return reinterpret_cast<sapi_json_any_t*>(pointer);
+    return toSAPIReference(json->context, json->data.at(index));
   }
 
   return nullptr;
@@ -218,6 +353,9 @@ sapi_json_any_t* sapi_json_array_get (
 sapi_json_any_t* sapi_json_array_pop (
   sapi_json_array_t* json
 ) {
-  auto pointer = json->pop().pointer.get();
-  return reinterpret_cast<sapi_json_any_t*>(pointer);
+  if (json->size() == 0) {
+    return nullptr;
+  }
+
+  return toSAPIValue(json->context, json->pop());
 }
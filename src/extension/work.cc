@@ -0,0 +1,266 @@
+#include "extension.hh"
+
+namespace SSC {
+  Extension::WorkPool& Extension::WorkPool::shared () {
+    static auto userConfig = SSC::getUserConfig();
+    static WorkPool pool([]() -> size_t {
+      try {
+        if (userConfig["extensions_workers"].size() > 0) {
+          return std::max(1, std::stoi(userConfig["extensions_workers"]));
+        }
+      } catch (...) {}
+
+      const auto cores = std::thread::hardware_concurrency();
+      return cores > 0 ? cores : 4;
+    }());
+
+    return pool;
+  }
+
+  Extension::WorkPool::WorkPool (size_t size) : size(size) {}
+
+  Extension::WorkPool::~WorkPool () {
+    do {
+      Lock lock(this->mutex);
+      this->stopped = true;
+    } while (0);
+
+    this->condition.notify_all();
+
+    for (auto& thread : this->threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+  void Extension::WorkPool::enqueue (Task task) {
+    do {
+      Lock lock(this->mutex);
+
+      if (this->stopped) {
+        return;
+      }
+
+      this->tasks.push_back(std::move(task));
+
+      // threads are started as tasks arrive, so an application that never
+      // submits work never starts a thread
+      if (this->threads.size() < this->size) {
+        this->threads.emplace_back([this]() {
+          while (true) {
+            Task task;
+
+            do {
+              std::unique_lock<Mutex> lock(this->mutex);
+              this->condition.wait(lock, [this]() {
+                return this->stopped || this->tasks.size() > 0;
+              });
+
+              if (this->stopped) {
+                return;
+              }
+
+              task = std::move(this->tasks.front());
+              this->tasks.pop_front();
+            } while (0);
+
+            task();
+          }
+        });
+      }
+    } while (0);
+
+    this->condition.notify_one();
+  }
+}
+
+void sapi_work_queue::release () {
+  if (this->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+// calls `oncomplete` on the event loop and then frees `work`, which must be
+// `Finished` and no longer in the queue, see `sapi_work_cancel()`
+static void completeWork (sapi_work_t* work) {
+  auto queue = work->queue;
+  auto context = queue->context;
+  auto complete = [work, queue, context]() {
+    const auto status = work->cancelled
+      ? SAPI_WORK_STATUS_CANCELLED
+      : SAPI_WORK_STATUS_COMPLETED;
+
+    if (work->oncomplete != nullptr) {
+      work->oncomplete(context, work, status, work->data);
+    }
+
+    delete work;
+    queue->release();
+  };
+
+  if (
+    context->router != nullptr &&
+    context->router->core != nullptr
+  ) {
+    context->router->core->dispatchEventLoop(complete);
+  } else {
+    complete();
+  }
+}
+
+static void scheduleWork (sapi_work_t* work) {
+  SSC::Extension::WorkPool::shared().enqueue([work]() {
+    auto queue = work->queue;
+
+    if (!work->cancelled) {
+      work->state = sapi_work::State::Running;
+      work->callback(work, work->data);
+    }
+
+    sapi_work_t* next = nullptr;
+
+    do {
+      SSC::Lock lock(queue->mutex);
+      work->state = sapi_work::State::Finished;
+      auto& scheduled = queue->scheduled;
+      scheduled.erase(std::find(scheduled.begin(), scheduled.end(), work));
+
+      if (queue->pending.size() > 0) {
+        next = queue->pending.front();
+        queue->pending.pop_front();
+        scheduled.push_back(next);
+      }
+    } while (0);
+
+    completeWork(work);
+
+    if (next != nullptr) {
+      scheduleWork(next);
+    }
+  });
+}
+
+sapi_work_queue_t* sapi_work_queue_create (
+  sapi_context_t* ctx,
+  const unsigned int concurrency
+) {
+  if (ctx == nullptr) return nullptr;
+  if (!ctx->isAllowed("work_queue_create")) {
+    sapi_debug(ctx, "'work_queue_create' is not allowed.");
+    return nullptr;
+  }
+
+  const auto size = SSC::Extension::WorkPool::shared().size;
+  auto queue = new sapi_work_queue_t();
+  queue->context = ctx;
+  queue->concurrency = concurrency > 0 && concurrency < size
+    ? concurrency
+    : (unsigned int) size;
+
+  return queue;
+}
+
+void sapi_work_queue_destroy (sapi_work_queue_t* queue) {
+  if (queue == nullptr) return;
+
+  std::deque<sapi_work_t*> pending;
+
+  do {
+    SSC::Lock lock(queue->mutex);
+    if (queue->destroyed) return;
+    queue->destroyed = true;
+    pending.swap(queue->pending);
+
+    for (auto work : pending) {
+      work->cancelled = true;
+      work->state = sapi_work::State::Finished;
+    }
+
+    for (auto work : queue->scheduled) {
+      work->cancelled = true;
+    }
+  } while (0);
+
+  for (auto work : pending) {
+    completeWork(work);
+  }
+
+  queue->release();
+}
+
+sapi_work_t* sapi_work_submit (
+  sapi_work_queue_t* queue,
+  sapi_work_callback_t callback,
+  sapi_work_complete_callback_t oncomplete,
+  void* data
+) {
+  if (queue == nullptr || callback == nullptr) return nullptr;
+  if (!queue->context->isAllowed("work_submit")) {
+    sapi_debug(queue->context, "'work_submit' is not allowed.");
+    return nullptr;
+  }
+
+  auto work = new sapi_work_t();
+  work->queue = queue;
+  work->callback = callback;
+  work->oncomplete = oncomplete;
+  work->data = data;
+
+  do {
+    SSC::Lock lock(queue->mutex);
+
+    if (queue->destroyed) {
+      delete work;
+      return nullptr;
+    }
+
+    queue->references++;
+
+    if (queue->scheduled.size() >= queue->concurrency) {
+      queue->pending.push_back(work);
+      return work;
+    }
+
+    queue->scheduled.push_back(work);
+  } while (0);
+
+  scheduleWork(work);
+  return work;
+}
+
+bool sapi_work_cancel (sapi_work_t* work) {
+  if (work == nullptr) return false;
+
+  auto queue = work->queue;
+
+  do {
+    // a worker finishes work under the same lock, so work that is not
+    // `Finished` here cannot be completed and freed until it is released
+    SSC::Lock lock(queue->mutex);
+
+    if (work->state == sapi_work::State::Finished) {
+      return false;
+    }
+
+    work->cancelled = true;
+    auto& pending = queue->pending;
+    auto iterator = std::find(pending.begin(), pending.end(), work);
+
+    // scheduled work sees `cancelled` when the pool gets to it, work still
+    // waiting in the queue is completed now
+    if (iterator == pending.end()) {
+      return true;
+    }
+
+    pending.erase(iterator);
+    work->state = sapi_work::State::Finished;
+  } while (0);
+
+  completeWork(work);
+  return true;
+}
+
+bool sapi_work_cancelled (const sapi_work_t* work) {
+  return work != nullptr && work->cancelled;
+}
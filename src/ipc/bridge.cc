@@ -79,11 +79,6 @@ static String getcwd () {
   GetModuleFileNameW(NULL, filename, MAX_PATH);
   auto path = fs::path { filename }.remove_filename();
   cwd = path.string();
-  size_t last_pos = 0;
-  while ((last_pos = cwd.find('\\', last_pos)) != std::string::npos) {
-    cwd.replace(last_pos, 1, "\\\\");
-    last_pos += 2;
-  }
 #endif
 
 #ifndef _WIN32
@@ -94,6 +89,106 @@ static String getcwd () {
   return cwd;
 }
 
+// replies are serialized into a per thread buffer that keeps its capacity
+// between replies, unless a reply was unusually large
+static constexpr size_t MAX_RETAINED_REPLY_BUFFER_SIZE = 1024 * 1024;
+
+static String& acquireReplyBuffer () {
+  static thread_local String buffer;
+  buffer.clear();
+  return buffer;
+}
+
+static void releaseReplyBuffer (String& buffer) {
+  if (buffer.capacity() > MAX_RETAINED_REPLY_BUFFER_SIZE) {
+    String().swap(buffer);
+  }
+}
+
+// the hostname of an `ipc://` URI, as `Message` would parse it
+static String getMessageName (const String& uri) {
+  auto offset = uri.find("ipc://");
+
+  if (offset == String::npos) {
+    return "";
+  }
+
+  offset += 6;
+
+  while (offset < uri.size() && uri[offset] == '/') {
+    offset++;
+  }
+
+  const auto end = uri.find_first_of("/?", offset);
+  return uri.substr(offset, end == String::npos ? String::npos : end - offset);
+}
+
+// a message for a binary route: arguments are in the request body, so only
+// `seq` and `index` are read from the query and nothing is decoded but `seq`
+static Message createBinaryMessage (const String& uri, const String& name) {
+  Message message;
+  message.uri = uri;
+  message.name = name;
+
+  const auto query = uri.find('?');
+
+  if (query == String::npos) {
+    return message;
+  }
+
+  auto offset = query + 1;
+
+  while (offset < uri.size()) {
+    auto end = uri.find('&', offset);
+
+    if (end == String::npos) {
+      end = uri.size();
+    }
+
+    const auto pair = std::string_view(uri).substr(offset, end - offset);
+
+    if (pair.starts_with("seq=")) {
+      message.seq = decodeURIComponent(String(pair.substr(4)));
+    } else if (pair.starts_with("index=") && pair.size() > 6) {
+      try {
+        message.index = std::stoi(String(pair.substr(6)));
+      } catch (...) {}
+    }
+
+    offset = end + 1;
+  }
+
+  return message;
+}
+
+// the comma separated buffer sizes of `fs.readv` and `fs.writev`, throws
+// for a size that is not an unsigned number or sizes that add up to more
+// than one request reads or writes
+static Vector<size_t> parseBufferSizes (const String& value) {
+  Vector<size_t> sizes;
+  size_t total = 0;
+
+  for (const auto& part : split(value, ',')) {
+    const auto token = trim(part);
+
+    // `std::stoull()` takes a sign, so "-1" would be the largest size
+    if (token.size() == 0 || !std::all_of(token.begin(), token.end(), ::isdigit)) {
+      throw std::invalid_argument("Invalid buffer size");
+    }
+
+    const auto size = (size_t) std::stoull(token);
+
+    if (size > Core::FS::MAX_VECTORED_BYTES - total) {
+      throw std::out_of_range("Buffer sizes are too large");
+    }
+
+    total += size;
+    sizes.push_back(size);
+  }
+
+  return sizes;
+}
+
 #define RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)                     \
   [message, reply](auto seq, auto json, auto post) {                           \
     reply(Result { seq, message, json, post });                                \
@@ -117,9 +212,7 @@ static String getcwd () {
   }                                                                            \
                                                                                \
   if (!router->core->hasPostBody(result.post.body)) {                          \
-    if (result.post.body != nullptr) {                                         \
-      delete [] result.post.body;                                              \
-    }                                                                          \
+    freePostBody(result.post);                                                 \
   }                                                                            \
 }
 
@@ -230,6 +323,75 @@ void initRouterTable (Router *router) {
     reply(Result { message.seq, message });
   });
 
+  /**
+   * Query and control per route IPC metrics (calls, errors, bytes and
+   * latency histograms for the dispatch, handler and reply phases).
+   * @param enabled Optional `true` or `false` to toggle metrics collection
+   * @param reset Optional `true` to zero all counters and histograms
+   * @param dump Optional file path to periodically write metrics to
+   * @param interval Optional dump interval in milliseconds [default = 1000]
+   * @param record Optional file path to record a replayable trace of IPC
+   * invocations to, an empty value stops recording
+   */
+  router->map("diagnostics.ipc", [](auto message, auto router, auto reply) {
+    uint64_t interval = 1000;
+
+    if (message.has("interval")) {
+      REQUIRE_AND_GET_MESSAGE_VALUE(interval, "interval", std::stoull);
+    }
+
+    if (message.has("enabled")) {
+      router->metrics.enabled = message.get("enabled") == "true";
+    }
+
+    if (message.get("reset") == "true") {
+      router->metrics.reset();
+    }
+
+    if (message.has("dump")) {
+      auto path = message.get("dump");
+      if (path.size() > 0 && interval > 0) {
+        router->metrics.startDump(router->core, path, interval);
+      } else {
+        router->metrics.stopDump(router->core);
+      }
+    }
+
+    if (message.has("record")) {
+      auto path = message.get("record");
+      if (path.size() > 0) {
+        if (!router->recorder.start(path)) {
+          return reply(Result::Err { message, JSON::Object::Entries {
+            {"message", "Unable to open '" + path + "' for recording"}
+          }});
+        }
+      } else {
+        router->recorder.stop();
+      }
+    }
+
+    auto data = router->metrics.json();
+    data["recording"] = router->recorder.isEnabled();
+
+    auto json = JSON::Object::Entries {
+      {"source", "diagnostics.ipc"},
+      {"data", data}
+    };
+
+    reply(Result { message.seq, message, json });
+  });
+
+  /**
+   * Query the pools behind `Core::FS` (read buffers by size class and
+   * request contexts by operation shape).
+   */
+  router->map("diagnostics.fs", [](auto message, auto router, auto reply) {
+    router->core->fs.diagnostics(
+      message.seq,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
   /**
    * Look up an IP address by `hostname`.
    * @param hostname Host name to lookup
@@ -263,11 +425,19 @@ void initRouterTable (Router *router) {
       }
     }
 
+    const auto& memory = Extension::Context::Memory::stats;
     auto json = JSON::Object::Entries {
       {"source", "extension.stats"},
       {"data", JSON::Object::Entries {
         {"abi", SOCKET_RUNTIME_EXTENSION_ABI_VERSION},
-        {"loaded", loaded}
+        {"loaded", loaded},
+        {"memory", JSON::Object::Entries {
+          {"releases", memory.releases.load()},
+          {"allocations", memory.allocations.load()},
+          {"destructors", memory.destructors.load()},
+          {"bytes", memory.bytes.load()},
+          {"blocks", memory.blocks.load()}
+        }}
       }}
     };
 
@@ -599,6 +769,25 @@ void initRouterTable (Router *router) {
     router->core->fs.fstat(message.seq, id, RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply));
   });
 
+  /**
+   * Writes what the file system holds of an open file descriptor to its
+   * storage device. Writes held by `fs.setWriteBehind` are written first.
+   * @param id
+   * @see fsync(2)
+   */
+  router->map("fs.fsync", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+
+    router->core->fs.fsync(message.seq, id, RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply));
+  });
+
   /**
    * Returns all open file or directory descriptors.
    */
@@ -744,6 +933,60 @@ void initRouterTable (Router *router) {
     );
   });
 
+  /**
+   * Reads into several buffers at `offset` from the underlying file
+   * descriptor with one request. The result is the bytes read, in order,
+   * to be split by `sizes`.
+   * @param id
+   * @param sizes Comma separated sizes of the buffers
+   * @param offset
+   * @see readv(2)
+   */
+  router->map("fs.readv", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id", "sizes", "offset"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    Vector<size_t> sizes;
+    int offset = 0;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(sizes, "sizes", parseBufferSizes);
+    REQUIRE_AND_GET_MESSAGE_VALUE(offset, "offset", std::stoi);
+
+    router->core->fs.readv(
+      message.seq,
+      id,
+      sizes,
+      offset,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
+  /**
+   * Reads the entire contents of the file at `path` in one request. With
+   * `[filesystem] map_read_files`, large files are mapped into memory and
+   * given to the WebView without a copy.
+   * @param path
+   * @see mmap(2)
+   * @see pread(2)
+   */
+  router->map("fs.readFile", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"path"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    router->core->fs.readFile(
+      message.seq,
+      message.get("path"),
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
   /**
    * Reads next `entries` of from the underlying directory descriptor.
    * @param id
@@ -830,6 +1073,79 @@ void initRouterTable (Router *router) {
     );
   });
 
+  /**
+   * Reads an open file descriptor ahead once it is read sequentially, so
+   * that the next reads are replied to with chunks already read. Chunks are
+   * only replied with while the size and modification time of the file are
+   * unchanged. A `chunks` of 0 stops reading ahead.
+   * @param id
+   * @param chunks
+   * @see read(2)
+   */
+  router->map("fs.setReadAhead", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    size_t chunks = 0;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(
+      chunks,
+      "chunks",
+      std::stoull,
+      std::to_string(Core::FS::READ_AHEAD_CHUNKS)
+    );
+
+    router->core->fs.setReadAhead(
+      message.seq,
+      id,
+      chunks,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
+  /**
+   * Holds small writes to an open file descriptor and writes those that
+   * follow each other with one vectored write once `size` bytes are held,
+   * `delay` milliseconds after the first one, or before the descriptor is
+   * read, synced or closed. Each write is replied to once it is written.
+   * A `size` of 0 writes what is held and stops holding writes.
+   * @param id
+   * @param size
+   * @param delay
+   * @see writev(2)
+   */
+  router->map("fs.setWriteBehind", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id", "size"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    size_t size = 0;
+    uint64_t delay = 0;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(size, "size", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(
+      delay,
+      "delay",
+      std::stoull,
+      std::to_string(Core::FS::WRITE_BEHIND_DELAY)
+    );
+
+    router->core->fs.setWriteBehind(
+      message.seq,
+      id,
+      size,
+      delay,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
   /**
    * Computes stats for a file at `path`.
    * @param path
@@ -868,6 +1184,111 @@ void initRouterTable (Router *router) {
     );
   });
 
+  /**
+   * Stops a watcher started with `fs.watch`. Changes not delivered yet are
+   * delivered first.
+   * @param id Watcher ID given to `fs.watch`
+   */
+  router->map("fs.unwatch", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+
+    router->core->fs.unwatch(
+      message.seq,
+      id,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
+  /**
+   * Walks the tree at `path`, reading its directories in parallel on the
+   * threadpool. Entries are sent in posts as JSON arrays of
+   * `{ name, type, stat? }`, with `name` relative to `path`. The request is
+   * replied to with the number of posts sent once the tree is walked.
+   * @param id Walk ID
+   * @param path
+   * @param depth Levels of directories below `path` to read, -1 for all
+   * @param include Comma separated globs of the entries to send
+   * @param ignore Comma separated globs of the entries to skip
+   * @param stat Send every entry with its `lstat(2)`
+   */
+  router->map("fs.walk", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id", "path"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    Core::FS::WalkOptions options;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(options.depth, "depth", std::stoll, "-1");
+
+    options.include = split(message.get("include"), ',');
+    options.ignore = split(message.get("ignore"), ',');
+    options.stat = message.get("stat") == "true";
+
+    router->core->fs.walk(
+      message.seq,
+      id,
+      message.get("path"),
+      options,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
+  /**
+   * Watches `path` for changes. The request is replied to once the path is
+   * watched. Changes are then emitted in batches as `fs.watch` events with
+   * `{ id, events: [{ type, path }] }`, one batch for the changes made until
+   * `window` milliseconds pass without another one.
+   * @param id Watcher ID
+   * @param path
+   * @param recursive Watch every directory under `path`
+   * @param window Milliseconds to wait for more changes before a batch
+   * @see inotify(7)
+   */
+  router->map("fs.watch", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id", "path"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    uint64_t window;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(
+      window,
+      "window",
+      std::stoull,
+      std::to_string(Core::FS::WATCH_WINDOW)
+    );
+
+    router->core->fs.watch(
+      message.seq,
+      id,
+      message.get("path"),
+      message.get("recursive") == "true",
+      window,
+      [message, reply, router](auto seq, auto json, auto post) {
+        if (seq != "-1") {
+          return reply(Result { seq, message, json, post });
+        }
+
+        router->dispatch([router, json]() {
+          router->emit("fs.watch", json.str());
+        });
+      }
+    );
+  });
+
   /**
    * Writes buffer at `message.buffer.bytes` of size `message.buffers.size`
    * at `offset` for an opened file handle.
@@ -903,6 +1324,57 @@ void initRouterTable (Router *router) {
     );
   });
 
+  /**
+   * Writes the buffers in `message.buffer.bytes`, one after the other and
+   * sized by `sizes`, at `offset` for an opened file handle with one
+   * request.
+   * @param id Handle ID for an open file descriptor
+   * @param sizes Comma separated sizes of the buffers
+   * @param offset The offset to start writing at
+   * @see writev(2)
+   */
+  router->map("fs.writev", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id", "sizes", "offset"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    if (message.buffer.bytes == nullptr || message.buffer.size == 0) {
+      auto err = JSON::Object::Entries {{ "message", "Missing buffer in message" }};
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    Vector<size_t> sizes;
+    int offset = 0;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(sizes, "sizes", parseBufferSizes);
+    REQUIRE_AND_GET_MESSAGE_VALUE(offset, "offset", std::stoi);
+
+    size_t size = 0;
+    for (const auto bufferSize : sizes) {
+      size += bufferSize;
+    }
+
+    if (size != (size_t) message.buffer.size) {
+      auto err = JSON::Object::Entries {
+        {"message", "Buffer sizes do not add up to the size of the buffer in message"}
+      };
+
+      return reply(Result::Err { message, err });
+    }
+
+    router->core->fs.writev(
+      message.seq,
+      id,
+      message.buffer.bytes,
+      sizes,
+      offset,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
   /**
    * A private API for artifically setting the current cached CWD value.
    * This is only useful on platforms that need to set this value from an
@@ -1398,20 +1870,49 @@ static void registerSchemeHandler (Router *router) {
     auto uri = String(webkit_uri_scheme_request_get_uri(request));
     auto router = reinterpret_cast<Router *>(ptr);
     auto invoked = router->invoke(uri, [=](auto result) {
-      auto json = result.str();
-      auto size = result.post.body != nullptr ? result.post.length : json.size();
-      auto body = result.post.body != nullptr ? result.post.body : json.c_str();
+      auto& json = acquireReplyBuffer();
+      auto post = result.post;
+
+      if (post.body != nullptr && !router->core->hasPostBody(post.body)) {
+        // the body is streamed as is: it is kept as a post (which is not
+        // freed after this callback) until the stream is closed
+        if (post.id == 0) {
+          post.id = rand64();
+        }
 
-      char* data = nullptr;
+        router->core->putPost(post.id, post);
+      } else {
+        if (post.body == nullptr) {
+          result.writeTo(json);
+        }
 
-      if (size > 0) {
-        data = new char[size]{0};
-        memcpy(data, body, size);
+        auto body = post.body != nullptr ? post.body : json.data();
+        post.length = post.body != nullptr ? post.length : json.size();
+        post.body = nullptr;
+        post.id = 0;
+        post.deallocate = nullptr;
+
+        if (post.length > 0) {
+          post.body = new char[post.length];
+          memcpy(post.body, body, post.length);
+        }
       }
 
+      releaseReplyBuffer(json);
+
+      auto size = post.length;
+      auto data = post.body;
+      auto context = new std::pair<Core*, Post>(router->core, post);
+
+      router->metrics.addBytesOut(result.message.name, size);
+
       auto stream = g_memory_input_stream_new_from_data(data, size, nullptr);
       auto response = webkit_uri_scheme_response_new(stream, size);
 
+      if (result.status != 200) {
+        webkit_uri_scheme_response_set_status(response, result.status, nullptr);
+      }
+
       if (result.post.body) {
         webkit_uri_scheme_response_set_content_type(response, IPC_BINARY_CONTENT_TYPE);
       } else {
@@ -1435,11 +1936,21 @@ static void registerSchemeHandler (Router *router) {
             return G_SOURCE_REMOVE;
           },
           userData,
-           [](gpointer userData) {
-            delete [] static_cast<char *>(userData);
+          [](gpointer userData) {
+            auto context = static_cast<std::pair<Core*, Post>*>(userData);
+            auto core = context->first;
+            auto& post = context->second;
+
+            if (post.id == 0) {
+              freePostBody(post);
+            } else {
+              core->removePost(post.id);
+            }
+
+            delete context;
           }
         );
-      }, data);
+      }, context);
     });
 
     if (!invoked) {
@@ -1483,10 +1994,7 @@ static void registerSchemeHandler (Router *router) {
     auto path = fs::path(cwd) / "socket" / (uri + ext);
 
     uri = "file://" + path.string();
-    auto moduleSource = trim(tmpl(
-      moduleTemplate,
-      Map { {"url", String(uri)} }
-    ));
+    const auto& moduleSource = getModuleProxySource(uri);
 
     auto size = moduleSource.size();
     auto bytes = moduleSource.data();
@@ -1576,10 +2084,9 @@ static void registerSchemeHandler (Router *router) {
 
     auto data = [NSData dataWithContentsOfURL: components.URL];
 
-    auto moduleSource = trim(tmpl(
-      moduleTemplate,
-      Map { {"url", String(components.URL.absoluteString.UTF8String)} }
-    ));
+    const auto& moduleSource = getModuleProxySource(
+      String(components.URL.absoluteString.UTF8String)
+    );
 
     headers[@"access-control-allow-origin"] = @"*";
     headers[@"access-control-allow-methods"] = @"*";
@@ -1671,10 +2178,44 @@ static void registerSchemeHandler (Router *router) {
   }
 
   auto invoked = self.router->invoke(url, body, bufsize, [=](auto result) {
-    auto json = result.str();
+    auto& json = acquireReplyBuffer();
+
+    if (result.post.body == nullptr) {
+      result.writeTo(json);
+    }
+
     auto size = result.post.body != nullptr ? result.post.length : json.size();
     auto body = result.post.body != nullptr ? result.post.body : json.c_str();
-    auto data = [NSData dataWithBytes: body length: size];
+    self.router->metrics.addBytesOut(result.message.name, size);
+
+    NSData* data = nil;
+
+    if (result.post.body != nullptr && !self.router->core->hasPostBody(body)) {
+      // hand the body to the web view as is and keep it as a post (which
+      // is not freed after this callback) until the data is deallocated
+      auto core = self.router->core;
+      auto post = result.post;
+
+      if (post.id == 0) {
+        post.id = rand64();
+      }
+
+      core->putPost(post.id, post);
+      data = [[NSData alloc]
+        initWithBytesNoCopy: post.body
+                     length: size
+                deallocator: ^(void* bytes, NSUInteger length) {
+        core->removePost(post.id);
+      }];
+
+    #if !__has_feature(objc_arc)
+      [data autorelease];
+    #endif
+    } else {
+      data = [NSData dataWithBytes: body length: size];
+    }
+
+    releaseReplyBuffer(json);
     auto  headers = [NSMutableDictionary dictionary];
 
     headers[@"access-control-allow-origin"] = @"*";
@@ -1700,7 +2241,7 @@ static void registerSchemeHandler (Router *router) {
 
     auto response = [[NSHTTPURLResponse alloc]
       initWithURL: task.request.URL
-       statusCode: 200
+       statusCode: result.status
       HTTPVersion: @"HTTP/1.1"
      headerFields: headers
     ];
@@ -1750,10 +2291,67 @@ static void registerSchemeHandler (Router *router) {
 #endif
 
 namespace SSC::IPC {
+  const String& getModuleProxySource (const String& url) {
+    static const Template proxy(moduleTemplate);
+    static std::unordered_map<String, String> sources;
+    static Mutex mutex;
+
+    Lock lock(mutex);
+    auto it = sources.find(url);
+
+    if (it == sources.end()) {
+      it = sources.emplace(url, trim(proxy.render(Map {{"url", url}}))).first;
+    }
+
+    return it->second;
+  }
+
+  static inline void recordReplyMetrics (
+    Metrics::Route* stats,
+    const Result& result,
+    uint64_t repliedAt
+  ) {
+    auto failed = !result.err.isNull();
+
+    if (!failed && result.value.isObject()) {
+      failed = result.value.as<JSON::Object>().has("err");
+    }
+
+    if (failed) {
+      stats->errors.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    stats->reply.record(Metrics::now() - repliedAt);
+  }
+
   Bridge::Bridge (Core *core) : router() {
+    static auto userConfig = SSC::getUserConfig();
+
     this->core = core;
     this->router.core = core;
     this->router.bridge = this;
+
+    if (userConfig["diagnostics_ipc"] == "true") {
+      this->router.metrics.enabled = true;
+    }
+
+    if (userConfig["diagnostics_ipc_record"].size() > 0) {
+      this->router.recorder.start(userConfig["diagnostics_ipc_record"]);
+    }
+
+    if (userConfig["diagnostics_ipc_dump"].size() > 0) {
+      uint64_t interval = 1000;
+
+      try {
+        interval = std::stoull(userConfig["diagnostics_ipc_dump_interval"]);
+      } catch (...) {}
+
+      this->router.metrics.startDump(
+        core,
+        userConfig["diagnostics_ipc_dump"],
+        interval
+      );
+    }
   }
 
   bool Router::hasMappedBuffer (int index, const Message::Seq seq) {
@@ -1822,6 +2420,10 @@ namespace SSC::IPC {
   }
 
   Router::~Router () {
+    if (this->core != nullptr) {
+      this->metrics.stopDump(this->core);
+    }
+
 #if defined(__APPLE__)
     if (this->networkStatusObserver != nullptr) {
       #if !__has_feature(objc_arc)
@@ -1893,6 +2495,18 @@ namespace SSC::IPC {
     }
   }
 
+  void Router::mapBinary (const String& name, MessageCallback callback) {
+    Lock lock(mutex);
+
+    String data = name;
+    // URI hostnames are not case sensitive. Convert to lowercase.
+    std::transform(data.begin(), data.end(), data.begin(),
+      [](unsigned char c) { return std::tolower(c); });
+    if (callback != nullptr) {
+      table.insert_or_assign(data, MessageCallbackContext { true, callback, true });
+    }
+  }
+
   void Router::unmap (const String& name) {
     Lock lock(mutex);
 
@@ -1907,7 +2521,7 @@ namespace SSC::IPC {
 
   bool Router::invoke (const String& uri, const char *bytes, size_t size) {
     return this->invoke(uri, bytes, size, [this](auto result) {
-      this->send(result.seq, result.str(), result.post);
+      this->send(result);
     });
   }
 
@@ -1921,8 +2535,8 @@ namespace SSC::IPC {
     size_t size,
     ResultCallback callback
   ) {
-    auto message = Message { uri };
-    auto name = message.name;
+    const auto hostname = getMessageName(uri);
+    auto name = hostname;
     MessageCallbackContext ctx;
 
     // URI hostnames are not case sensitive. Convert to lowercase.
@@ -1942,6 +2556,29 @@ namespace SSC::IPC {
       }
     } while (0);
 
+    // binary routes take their arguments from the request body, so the
+    // query is not parsed for them
+    const auto message = ctx.binary
+      ? createBinaryMessage(uri, hostname)
+      : Message { uri };
+
+    // per route metrics are only gathered when enabled with the
+    // `diagnostics.ipc` route so this path stays free of any bookkeeping
+    Metrics::Route* stats = nullptr;
+    uint64_t invokedAt = 0;
+
+    // controlling the recorder is not part of a recording
+    if (this->recorder.isEnabled() && name != "diagnostics.ipc") {
+      this->recorder.record(uri, bytes, size);
+    }
+
+    if (this->metrics.isEnabled()) {
+      stats = this->metrics.get(name);
+      stats->calls.fetch_add(1, std::memory_order_relaxed);
+      stats->bytesIn.fetch_add(uri.size() + size, std::memory_order_relaxed);
+      invokedAt = Metrics::now();
+    }
+
     if (ctx.callback != nullptr) {
       Message msg(message);
       // decorate message with buffer if buffer was previously
@@ -1974,9 +2611,28 @@ namespace SSC::IPC {
       } while (0);
 
       if (ctx.async) {
-        auto dispatched = this->dispatch([ctx, msg, callback, this]() mutable {
-          ctx.callback(msg, this, [msg, callback, this](const auto result) mutable {
+        auto dispatched = this->dispatch([=, this]() mutable {
+          const auto dispatchedAt = stats != nullptr ? Metrics::now() : 0;
+          // values built while handling the request come from one arena
+          JSON::Arena::Scope arena;
+
+          if (stats != nullptr) {
+            stats->dispatch.record(dispatchedAt - invokedAt);
+          }
+
+          ctx.callback(msg, this, [=, this](const auto result) mutable {
+            const auto repliedAt = stats != nullptr ? Metrics::now() : 0;
+
+            if (stats != nullptr) {
+              stats->handler.record(repliedAt - dispatchedAt);
+            }
+
             callback(result);
+
+            if (stats != nullptr) {
+              recordReplyMetrics(stats, result, repliedAt);
+            }
+
             CLEANUP_AFTER_INVOKE_CALLBACK(this, msg, result);
           });
         });
@@ -1987,8 +2643,20 @@ namespace SSC::IPC {
 
         return dispatched;
       } else {
-        ctx.callback(msg, this, [msg, callback, this](const auto result) mutable {
+        JSON::Arena::Scope arena;
+        ctx.callback(msg, this, [=, this](const auto result) mutable {
+          const auto repliedAt = stats != nullptr ? Metrics::now() : 0;
+
+          if (stats != nullptr) {
+            stats->handler.record(repliedAt - invokedAt);
+          }
+
           callback(result);
+
+          if (stats != nullptr) {
+            recordReplyMetrics(stats, result, repliedAt);
+          }
+
           CLEANUP_AFTER_INVOKE_CALLBACK(this, msg, result);
         });
 
@@ -1999,9 +2667,18 @@ namespace SSC::IPC {
     return false;
   }
 
+  bool Router::send (const Result& result) {
+    auto& data = acquireReplyBuffer();
+    result.writeTo(data);
+    this->metrics.addBytesOut(result.message.name, data.size() + result.post.length);
+    auto sent = this->send(result.seq, data, result.post);
+    releaseReplyBuffer(data);
+    return sent;
+  }
+
   bool Router::send (
     const Message::Seq& seq,
-    const String data,
+    const String& data,
     const Post post
   ) {
     Lock lock(this->mutex);
@@ -2010,10 +2687,10 @@ namespace SSC::IPC {
       return this->evaluateJavaScript(script);
     }
 
-    // this had a sequence, we need to try to resolve it.
+    // this had a sequence, we need to try to resolve it. The reply is
+    // embedded in the script as is and parsed once by the WebView
     if (seq != "-1" && seq.size() > 0) {
-      auto value = encodeURIComponent(data);
-      auto script = getResolveToRenderProcessJavaScript(seq, "0", value);
+      auto script = getResolveJSONToRenderProcessJavaScript(seq, "0", data);
       return this->evaluateJavaScript(script);
     }
 
@@ -2029,8 +2706,7 @@ namespace SSC::IPC {
     const String data
   ) {
     Lock lock(this->mutex);
-    auto value = encodeURIComponent(data);
-    auto script = getEmitToRenderProcessJavaScript(name, value);
+    auto script = getEmitJSONToRenderProcessJavaScript(name, data);
     return this->evaluateJavaScript(script);
   }
 
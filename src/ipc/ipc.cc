@@ -183,8 +183,71 @@ namespace SSC::IPC {
   }
 
   String Result::str () const {
-    auto json = this->json();
-    return json.str();
+    String output;
+    this->writeTo(output);
+    return output;
+  }
+
+  // Writes the same JSON as `json().str()` to `buffer` without copying
+  // `value` to decorate it with `source`. Objects keep their insertion
+  // order, so `source` replaces an existing key in place or comes last.
+  void Result::writeTo (String& buffer) const {
+    if (!this->value.isNull()) {
+      if (!this->value.isObject()) {
+        JSON::write(buffer, this->value);
+        return;
+      }
+
+      const auto& object = this->value.as<JSON::Object>();
+      bool wroteSource = false;
+      bool first = true;
+
+      auto writeKey = [&](const String& key) {
+        if (!first) {
+          buffer.push_back(',');
+        }
+
+        first = false;
+        JSON::writeString(buffer, key);
+        buffer.push_back(':');
+      };
+
+      buffer.push_back('{');
+
+      for (const auto& tuple : object.data) {
+        writeKey(tuple.first);
+
+        if (tuple.first == "source") {
+          JSON::writeString(buffer, this->source);
+          wroteSource = true;
+        } else {
+          JSON::write(buffer, tuple.second);
+        }
+      }
+
+      if (!wroteSource) {
+        writeKey("source");
+        JSON::writeString(buffer, this->source);
+      }
+
+      buffer.push_back('}');
+      return;
+    }
+
+    buffer.append("{\"source\":");
+    JSON::writeString(buffer, this->source);
+    buffer.append(",\"result_id\":");
+    JSON::writeString(buffer, std::to_string(this->id));
+
+    if (!this->err.isNull()) {
+      buffer.append(",\"err\":");
+      JSON::write(buffer, this->err);
+    } else {
+      buffer.append(",\"data\":");
+      JSON::write(buffer, this->data);
+    }
+
+    buffer.append("}");
   }
 
   Result::Err::Err (
@@ -212,4 +275,336 @@ namespace SSC::IPC {
     this->value = value;
     this->post = post;
   }
+
+  static inline int getHistogramBucketIndex (uint64_t value) {
+    if (value < Histogram::SUB_BUCKETS) {
+      return (int) value;
+    }
+
+    // the most significant bit selects the magnitude and the next
+    // `SUB_BUCKET_BITS` bits select the linear bucket within it
+    const int shift = std::bit_width(value) - 1 - Histogram::SUB_BUCKET_BITS;
+    const int magnitude = shift + 1;
+    const int sub = (int) ((value >> shift) & (Histogram::SUB_BUCKETS - 1));
+
+    if (magnitude >= Histogram::MAGNITUDES) {
+      return Histogram::BUCKETS - 1;
+    }
+
+    return magnitude * Histogram::SUB_BUCKETS + sub;
+  }
+
+  static inline uint64_t getHistogramBucketUpperBound (int index) {
+    const int magnitude = index / Histogram::SUB_BUCKETS;
+    const uint64_t sub = index % Histogram::SUB_BUCKETS;
+
+    if (magnitude == 0) {
+      return sub;
+    }
+
+    return ((Histogram::SUB_BUCKETS + sub + 1) << (magnitude - 1)) - 1;
+  }
+
+  Histogram::Histogram () {
+    this->reset();
+  }
+
+  void Histogram::record (uint64_t value) {
+    const auto index = getHistogramBucketIndex(value);
+    this->buckets[index].fetch_add(1, std::memory_order_relaxed);
+    this->count.fetch_add(1, std::memory_order_relaxed);
+    this->sum.fetch_add(value, std::memory_order_relaxed);
+
+    auto min = this->min.load(std::memory_order_relaxed);
+    while (value < min && !this->min.compare_exchange_weak(min, value)) {}
+
+    auto max = this->max.load(std::memory_order_relaxed);
+    while (value > max && !this->max.compare_exchange_weak(max, value)) {}
+  }
+
+  void Histogram::reset () {
+    for (auto& bucket : this->buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+
+    this->count = 0;
+    this->sum = 0;
+    this->min = UINT64_MAX;
+    this->max = 0;
+  }
+
+  uint64_t Histogram::percentile (double p) const {
+    const auto count = this->count.load(std::memory_order_relaxed);
+
+    if (count == 0) {
+      return 0;
+    }
+
+    const auto target = std::max((uint64_t) 1, (uint64_t) std::ceil(p * count));
+    uint64_t seen = 0;
+
+    for (int i = 0; i < Histogram::BUCKETS; ++i) {
+      seen += this->buckets[i].load(std::memory_order_relaxed);
+      if (seen >= target) {
+        return std::clamp(
+          getHistogramBucketUpperBound(i),
+          this->min.load(std::memory_order_relaxed),
+          this->max.load(std::memory_order_relaxed)
+        );
+      }
+    }
+
+    return this->max.load(std::memory_order_relaxed);
+  }
+
+  JSON::Object Histogram::json () const {
+    const auto count = this->count.load(std::memory_order_relaxed);
+    const auto sum = this->sum.load(std::memory_order_relaxed);
+
+    return JSON::Object::Entries {
+      {"count", count},
+      {"min", count > 0 ? this->min.load() : 0},
+      {"max", this->max.load()},
+      {"mean", count > 0 ? sum / count : 0},
+      {"p50", this->percentile(0.50)},
+      {"p90", this->percentile(0.90)},
+      {"p99", this->percentile(0.99)},
+      {"p999", this->percentile(0.999)}
+    };
+  }
+
+  void Metrics::Route::reset () {
+    this->calls = 0;
+    this->errors = 0;
+    this->bytesIn = 0;
+    this->bytesOut = 0;
+    this->dispatch.reset();
+    this->handler.reset();
+    this->reply.reset();
+  }
+
+  JSON::Object Metrics::Route::json () const {
+    return JSON::Object::Entries {
+      {"calls", this->calls.load()},
+      {"errors", this->errors.load()},
+      {"bytes", JSON::Object::Entries {
+        {"in", this->bytesIn.load()},
+        {"out", this->bytesOut.load()}
+      }},
+      {"latency", JSON::Object::Entries {
+        {"dispatch", this->dispatch.json()},
+        {"handler", this->handler.json()},
+        {"reply", this->reply.json()}
+      }}
+    };
+  }
+
+  Metrics::Route* Metrics::get (const String& name) {
+    Lock lock(this->mutex);
+
+    String key = name;
+    // URI hostnames are not case sensitive. Convert to lowercase.
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) {
+      return std::tolower(c);
+    });
+
+    auto& route = this->routes[key];
+
+    // routes are never removed, only reset, so pointers handed out to
+    // in-flight invocations stay valid for the life time of the router
+    if (route == nullptr) {
+      route = std::make_unique<Route>();
+    }
+
+    return route.get();
+  }
+
+  void Metrics::addBytesOut (const String& name, size_t size) {
+    if (this->isEnabled()) {
+      this->get(name)->bytesOut.fetch_add(size, std::memory_order_relaxed);
+    }
+  }
+
+  void Metrics::reset () {
+    Lock lock(this->mutex);
+    for (auto& tuple : this->routes) {
+      tuple.second->reset();
+    }
+  }
+
+  JSON::Object Metrics::json () {
+    Lock lock(this->mutex);
+    JSON::Object::Entries routes;
+
+    for (const auto& tuple : this->routes) {
+      routes[tuple.first] = tuple.second->json();
+    }
+
+    return JSON::Object::Entries {
+      {"enabled", this->isEnabled()},
+      {"unit", "ns"},
+      {"routes", routes}
+    };
+  }
+
+  bool Metrics::dump (const String& path) {
+    auto output = std::ofstream(path, std::ios::trunc);
+
+    if (!output.is_open()) {
+      return false;
+    }
+
+    output << this->json().str() << std::endl;
+    return output.good();
+  }
+
+  void Metrics::startDump (Core* core, const String& path, uint64_t interval) {
+    this->stopDump(core);
+
+    auto ctx = new DumpContext();
+    ctx->metrics = this;
+    ctx->path = path;
+    ctx->timer.data = ctx;
+
+    do {
+      Lock lock(this->mutex);
+      this->dumpContext = ctx;
+    } while (0);
+
+    core->dispatchEventLoop([=]() {
+      auto loop = core->getEventLoop();
+      uv_timer_init(loop, &ctx->timer);
+      uv_timer_start(&ctx->timer, [](uv_timer_t* handle) {
+        auto ctx = reinterpret_cast<DumpContext*>(handle->data);
+        auto metrics = ctx->metrics.load();
+        if (metrics != nullptr) {
+          metrics->dump(ctx->path);
+        }
+      }, interval, interval);
+    });
+  }
+
+  void Metrics::stopDump (Core* core) {
+    DumpContext* ctx = nullptr;
+
+    do {
+      Lock lock(this->mutex);
+      ctx = this->dumpContext;
+      this->dumpContext = nullptr;
+    } while (0);
+
+    if (ctx == nullptr) {
+      return;
+    }
+
+    // detach from this instance now, the timer handle is closed
+    // and free'd on the loop thread
+    ctx->metrics = nullptr;
+    core->dispatchEventLoop([=]() {
+      uv_timer_stop(&ctx->timer);
+      uv_close((uv_handle_t*) &ctx->timer, [](uv_handle_t* handle) {
+        delete reinterpret_cast<DumpContext*>(handle->data);
+      });
+    });
+  }
+
+  // a trace is a header line followed by entries of the form
+  // `<time> <size> <uri>\n<size bytes>\n`
+  static constexpr auto RECORDER_TRACE_HEADER = "# socket-runtime ipc trace v1";
+
+  Recorder::Entries Recorder::load (const String& path) {
+    auto input = std::ifstream(path, std::ios::binary);
+    Entries entries;
+    String line;
+
+    if (!input.is_open() || !std::getline(input, line)) {
+      return entries;
+    }
+
+    if (line != RECORDER_TRACE_HEADER) {
+      return entries;
+    }
+
+    while (std::getline(input, line)) {
+      if (line.size() == 0) {
+        continue;
+      }
+
+      Entry entry;
+      size_t size = 0;
+      auto stream = StringStream(line);
+
+      if (!(stream >> entry.time >> size)) {
+        break;
+      }
+
+      stream.get(); // ' '
+      std::getline(stream, entry.uri);
+
+      if (size > 0) {
+        entry.bytes.resize(size);
+        if (!input.read(entry.bytes.data(), size)) {
+          break;
+        }
+      }
+
+      input.get(); // '\n'
+      entries.push_back(std::move(entry));
+    }
+
+    return entries;
+  }
+
+  bool Recorder::start (const String& path) {
+    Lock lock(this->mutex);
+
+    if (this->stream.is_open()) {
+      this->stream.close();
+    }
+
+    this->stream.open(path, std::ios::binary | std::ios::trunc);
+
+    if (!this->stream.is_open()) {
+      this->enabled = false;
+      return false;
+    }
+
+    this->stream << RECORDER_TRACE_HEADER << "\n";
+    this->startedAt = uv_hrtime();
+    this->enabled = true;
+    return true;
+  }
+
+  void Recorder::stop () {
+    Lock lock(this->mutex);
+    this->enabled = false;
+
+    if (this->stream.is_open()) {
+      this->stream.close();
+    }
+  }
+
+  void Recorder::record (const String& uri, const char* bytes, size_t size) {
+    Lock lock(this->mutex);
+
+    if (!this->isEnabled() || !this->stream.is_open()) {
+      return;
+    }
+
+    if (bytes == nullptr) {
+      size = 0;
+    }
+
+    this->stream
+      << (uv_hrtime() - this->startedAt) << " "
+      << size << " "
+      << uri << "\n";
+
+    if (size > 0) {
+      this->stream.write(bytes, size);
+    }
+
+    this->stream << "\n";
+    this->stream.flush();
+  }
 }
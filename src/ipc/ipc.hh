@@ -130,6 +130,7 @@ namespace SSC::IPC {
       JSON::Any err = nullptr;
       Headers headers;
       Post post;
+      int status = 200; // HTTP status of an `ipc://` scheme response
 
       Result () = default;
       Result (const Err error);
@@ -139,6 +140,109 @@ namespace SSC::IPC {
       Result (const Message::Seq&, const Message&, JSON::Any, Post);
       String str () const;
       JSON::Any json () const;
+      void writeTo (String& buffer) const;
+  };
+
+  /**
+   * A log-linear (HDR style) histogram of nanosecond latencies. Each power
+   * of two is split into `SUB_BUCKETS` linear buckets so the relative error
+   * of a reported percentile is bounded. Recording is lock free.
+   */
+  class Histogram {
+    public:
+      static constexpr int SUB_BUCKET_BITS = 3;
+      static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+      static constexpr int MAGNITUDES = 44; // ~19 hours in nanoseconds
+      static constexpr int BUCKETS = MAGNITUDES * SUB_BUCKETS;
+
+      std::atomic<uint64_t> buckets[BUCKETS];
+      std::atomic<uint64_t> count = 0;
+      std::atomic<uint64_t> sum = 0;
+      std::atomic<uint64_t> min = UINT64_MAX;
+      std::atomic<uint64_t> max = 0;
+
+      Histogram ();
+      Histogram (const Histogram&) = delete;
+      void record (uint64_t value);
+      void reset ();
+      uint64_t percentile (double p) const;
+      JSON::Object json () const;
+  };
+
+  class Metrics {
+    public:
+      struct Route {
+        std::atomic<uint64_t> calls = 0;
+        std::atomic<uint64_t> errors = 0;
+        std::atomic<uint64_t> bytesIn = 0;
+        std::atomic<uint64_t> bytesOut = 0;
+        Histogram dispatch; // `Router::invoke()` -> route handler called
+        Histogram handler; // route handler called -> reply
+        Histogram reply; // reply -> result delivered to the WebView
+
+        void reset ();
+        JSON::Object json () const;
+      };
+
+      struct DumpContext {
+        uv_timer_t timer;
+        std::atomic<Metrics*> metrics = nullptr;
+        String path;
+      };
+
+      using Routes = std::map<String, std::unique_ptr<Route>>;
+
+      std::atomic<bool> enabled = false;
+      DumpContext* dumpContext = nullptr;
+      Routes routes;
+      Mutex mutex;
+
+      static inline uint64_t now () {
+        return uv_hrtime();
+      }
+
+      inline bool isEnabled () const {
+        return this->enabled.load(std::memory_order_relaxed);
+      }
+
+      Route* get (const String& name);
+      void addBytesOut (const String& name, size_t size);
+      void reset ();
+      JSON::Object json ();
+      bool dump (const String& path);
+      void startDump (Core* core, const String& path, uint64_t interval);
+      void stopDump (Core* core);
+  };
+
+  /**
+   * Records `ipc://` URIs and their payloads, as they are given to
+   * `Router::invoke()`, to a trace file that can be replayed without a
+   * WebView by the IPC benchmark (`src/bench/ipc.cc`).
+   */
+  class Recorder {
+    public:
+      struct Entry {
+        uint64_t time = 0; // nanoseconds since recording started
+        String uri;
+        Vector<char> bytes;
+      };
+
+      using Entries = Vector<Entry>;
+
+      std::atomic<bool> enabled = false;
+      std::ofstream stream;
+      uint64_t startedAt = 0;
+      Mutex mutex;
+
+      static Entries load (const String& path);
+
+      inline bool isEnabled () const {
+        return this->enabled.load(std::memory_order_relaxed);
+      }
+
+      bool start (const String& path);
+      void stop ();
+      void record (const String& uri, const char* bytes, size_t size);
   };
 
   class Router {
@@ -153,6 +257,9 @@ namespace SSC::IPC {
       struct MessageCallbackContext {
         bool async = true;
         MessageCallback callback;
+        // the callback is given the request body as is, and a message with
+        // only `name`, `seq` and `index` from the URI
+        bool binary = false;
       };
 
       struct MessageCallbackListenerContext {
@@ -174,6 +281,8 @@ namespace SSC::IPC {
       Mutex mutex;
       Table table;
       Listeners listeners;
+      Metrics metrics;
+      Recorder recorder;
       Core *core = nullptr;
       Bridge *bridge = nullptr;
     #if defined(__APPLE__)
@@ -197,11 +306,13 @@ namespace SSC::IPC {
       bool unlisten (const String& name, uint64_t token);
       void map (const String& name, MessageCallback callback);
       void map (const String& name, bool async, MessageCallback callback);
+      void mapBinary (const String& name, MessageCallback callback);
       void unmap (const String& name);
       bool dispatch (DispatchCallback callback);
       bool emit (const String& name, const String data);
       bool evaluateJavaScript (const String javaScript);
-      bool send (const Message::Seq& seq, const String data, const Post post);
+      bool send (const Result& result);
+      bool send (const Message::Seq& seq, const String& data, const Post post);
       bool invoke (const String& msg, ResultCallback callback);
       bool invoke (const String& msg, const char *bytes, size_t size);
       bool invoke (
@@ -235,5 +346,10 @@ namespace SSC::IPC {
   ) {
     return String("ipc://resolve?seq=" + seq + "&state=" + state + "&value=" + value);
   }
+
+  // Returns the `moduleTemplate` proxy for the module at `url`. Proxies are
+  // rendered once per URL and live for the life of the process, so the
+  // returned source can be handed to a response without a copy.
+  const String& getModuleProxySource (const String& url);
 } // SSC::IPC
 #endif
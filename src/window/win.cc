@@ -884,9 +884,11 @@ namespace SSC {
                               memcpy(body, result.post.body, length);
                               headers = "Content-Type: application/octet-stream\n";
                             } else {
-                              length = result.str().size();
+                              String json;
+                              result.writeTo(json);
+                              length = json.size();
                               body = new char[length];
-                              memcpy(body, result.str().c_str(), length);
+                              memcpy(body, json.c_str(), length);
                               headers = "Content-Type: application/json\n";
                             }
 
@@ -901,13 +903,14 @@ namespace SSC {
                             // put_Response() must be called from the same thread that made
                             // the request. This assumes that the request was made from the
                             // main thread, since that's where dispatch() will call its cb.
-                            app.dispatch([&, body, length, headers, args, deferral, env] {
+                            auto status = result.status;
+                            app.dispatch([&, body, length, headers, status, args, deferral, env] {
                               ICoreWebView2WebResourceResponse* res = nullptr;
                               IStream* bytes = SHCreateMemStream((const BYTE*)body, length);
                               env->CreateWebResourceResponse(
                                 bytes,
-                                200,
-                                L"OK",
+                                status,
+                                status == 200 ? L"OK" : L"",
                                 StringToWString(headers).c_str(),
                                 &res
                               );
@@ -952,10 +955,7 @@ namespace SSC {
                               char* body;
 
                               auto moduleUri = "file://" + replace(path.string(), "\\\\", "/");
-                              auto moduleSource = trim(tmpl(
-                                moduleTemplate,
-                                Map { {"url", String(moduleUri)} }
-                              ));
+                              const auto& moduleSource = IPC::getModuleProxySource(moduleUri);
 
                               size_t length = moduleSource.size();
                               body = new char[length];
@@ -1,2 +1,4 @@
 // import './diagnostics/channels.js'
+import './diagnostics/fs.js'
+import './diagnostics/ipc.js'
 import './diagnostics/window.js'
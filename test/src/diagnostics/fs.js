@@ -0,0 +1,173 @@
+import { test } from 'socket:test'
+import process from 'socket:process'
+import path from 'socket:path'
+import ipc from 'socket:ipc'
+import fs from 'socket:fs/promises'
+import os from 'socket:os'
+
+// FIXME: make this work on iOS
+if (process.platform !== 'ios') {
+  test('diagnostics - fs - pools', async (t) => {
+    const filename = path.join(os.tmpdir(), `diagnostics-fs-${Date.now()}.bin`)
+    const size = 512 * 1024
+    const bytes = new Uint8Array(size).map((_, i) => i % 251)
+
+    await fs.writeFile(filename, bytes)
+
+    // a `FileHandle` reads with sequential `fs.read` requests
+    const handle = await fs.open(filename, 'r', 0o666, { readAhead: true })
+    const data = await handle.readFile()
+    await handle.close()
+
+    t.equal(data.length, size, 'file is read')
+    t.ok(data.every((byte, i) => byte === bytes[i]), 'read buffers hold the file bytes in order')
+
+    const response = await ipc.send('diagnostics.fs')
+    t.ifError(response.err, 'diagnostics.fs does not fail')
+
+    const { buffers, contexts, uring, readAhead } = response.data
+    const sizes = buffers.classes.map((sizeClass) => sizeClass.size)
+    const acquired = buffers.classes.reduce(
+      (count, sizeClass) => count + sizeClass.allocations + sizeClass.reuses,
+      0
+    )
+
+    t.equal(sizes[0], 4 * 1024, 'smallest read buffer is 4 KB')
+    t.equal(sizes[sizes.length - 1], 1024 * 1024, 'largest read buffer is 1 MB')
+    t.ok(acquired > 0, 'reads use pooled buffers')
+    t.ok(contexts.buffer.allocations > 0, 'reads use pooled contexts')
+    t.ok(contexts.path.allocations > 0, 'path operations use pooled contexts')
+    t.equal(typeof uring.available, 'boolean', 'io_uring availability is reported')
+    t.ok(uring.available || uring.submitted === 0, 'nothing is submitted without io_uring')
+    t.ok(readAhead.prefetches > 0, 'sequential reads are read ahead')
+    t.ok(readAhead.hits > 0, 'reads are replied to with chunks read ahead')
+
+    await fs.unlink(filename)
+  })
+
+  test('diagnostics - fs - descriptors', async (t) => {
+    const filename = path.join(os.tmpdir(), `diagnostics-fs-descriptors-${Date.now()}.txt`)
+    await fs.writeFile(filename, 'descriptors')
+
+    const handle = await fs.open(filename)
+    const opened = (await ipc.send('diagnostics.fs')).data.descriptors
+    await handle.close()
+    const closed = (await ipc.send('diagnostics.fs')).data.descriptors
+
+    t.ok(opened.files >= 1, 'open files are counted')
+    t.equal(opened.open, opened.files + opened.directories, 'open descriptors are files or directories')
+    t.equal(closed.open, opened.open - 1, 'closed descriptors are no longer counted')
+    t.equal(typeof closed.stale, 'number', 'stale descriptors are counted')
+  })
+
+  test('diagnostics - fs - stat cache', async (t) => {
+    const filename = path.join(os.tmpdir(), `diagnostics-fs-stat-cache-${Date.now()}.txt`)
+    await fs.writeFile(filename, 'a')
+
+    const before = (await ipc.send('diagnostics.fs')).data.statCache
+    const first = await fs.stat(filename)
+    const second = await fs.stat(filename)
+    const after = (await ipc.send('diagnostics.fs')).data.statCache
+
+    t.ok(after.enabled, 'stat cache is enabled with [filesystem] stat_cache')
+    t.equal(second.size, first.size, 'kept stats are the stats of the file')
+    t.ok(after.hits > before.hits, 'a repeated stat is a hit')
+
+    await fs.writeFile(filename, 'abc')
+    const written = await fs.stat(filename)
+    t.equal(written.size, 3, 'writing a file drops its kept stats')
+
+    await fs.unlink(filename)
+    try {
+      await fs.stat(filename)
+      t.fail('stat of an unlinked file fails')
+    } catch (err) {
+      t.ok(err instanceof Error, 'unlinking a file drops its kept stats')
+    }
+  })
+
+  test('diagnostics - fs - watch', async (t) => {
+    const directory = path.join(os.tmpdir(), `diagnostics-fs-watch-${Date.now()}`)
+    await fs.mkdir(directory)
+
+    const before = (await ipc.send('diagnostics.fs')).data.watch
+    const changes = fs.watch(directory, { window: 100 })[Symbol.asyncIterator]()
+    const first = changes.next()
+
+    await Promise.all(Array.from({ length: 200 }, (_, i) =>
+      fs.writeFile(path.join(directory, `${i}.txt`), String(i))
+    ))
+
+    t.ok((await first).value?.filename, 'changes are yielded')
+    await new Promise((resolve) => setTimeout(resolve, 300))
+
+    const after = (await ipc.send('diagnostics.fs')).data.watch
+    await changes.return()
+
+    const events = after.events - before.events
+    const batches = after.batches - before.batches
+
+    t.ok(events >= 200, 'changes are seen')
+    t.ok(batches < events / 10, 'changes are delivered in batches')
+  })
+
+  test('diagnostics - fs - read ahead', async (t) => {
+    const filename = path.join(os.tmpdir(), `diagnostics-fs-read-ahead-${Date.now()}.bin`)
+    const chunk = 4096
+    const buffer = new Uint8Array(chunk)
+
+    await fs.writeFile(filename, new Uint8Array(16 * chunk).map((_, i) => i % 251))
+
+    const before = (await ipc.send('diagnostics.fs')).data.readAhead
+    const plain = await fs.open(filename)
+
+    for (let i = 0; i < 4; ++i) {
+      await plain.read(buffer, 0, chunk, i * chunk)
+    }
+
+    await plain.close()
+
+    const after = (await ipc.send('diagnostics.fs')).data.readAhead
+    t.equal(after.prefetches, before.prefetches, 'files are not read ahead unless asked')
+
+    const handle = await fs.open(filename, 'r', 0o666, { readAhead: true })
+
+    for (let i = 0; i < 3; ++i) {
+      await handle.read(buffer, 0, chunk, i * chunk)
+    }
+
+    // another descriptor changes the chunk read ahead for the next read
+    await new Promise((resolve) => setTimeout(resolve, 50))
+    const writer = await fs.open(filename, 'r+')
+    await writer.write(new Uint8Array(chunk).fill(7), 0, chunk, 3 * chunk)
+    await writer.close()
+
+    const { bytesRead } = await handle.read(buffer, 0, chunk, 3 * chunk)
+    await handle.close()
+
+    t.equal(bytesRead, chunk, 'the changed chunk is read')
+    t.ok(buffer.every((byte) => byte === 7), 'chunks read before a change are not replied with')
+
+    await fs.unlink(filename)
+  })
+
+  test('diagnostics - fs - write behind', async (t) => {
+    const filename = path.join(os.tmpdir(), `diagnostics-fs-write-behind-${Date.now()}.bin`)
+    const handle = await fs.open(filename, 'w', 0o666, { writeBehind: true })
+    const chunk = new Uint8Array(256).fill(7)
+
+    await Promise.all(Array.from({ length: 32 }, (_, i) =>
+      handle.write(chunk, 0, chunk.length, i * chunk.length)
+    ))
+
+    await handle.sync()
+    await handle.close()
+
+    const response = await ipc.send('diagnostics.fs')
+    t.ifError(response.err, 'diagnostics.fs does not fail')
+
+    const { writeBehind } = response.data
+    t.ok(writeBehind.writes >= 32, 'small writes are held')
+    t.ok(writeBehind.flushes < writeBehind.writes, 'held writes are written together')
+  })
+}
@@ -0,0 +1,29 @@
+import ipc from 'socket:ipc'
+import test from 'socket:test'
+
+test('diagnostics - ipc - metrics', async (t) => {
+  let response = await ipc.send('diagnostics.ipc', { enabled: true, reset: true })
+  t.ifError(response.err, 'diagnostics.ipc does not fail')
+  t.equal(response.data.enabled, true, 'metrics are enabled')
+  t.equal(response.data.unit, 'ns', 'latencies are in nanoseconds')
+
+  await ipc.send('ping')
+  await ipc.send('ping')
+
+  response = await ipc.send('diagnostics.ipc', { enabled: false })
+  const ping = response.data.routes.ping
+  t.equal(response.data.enabled, false, 'metrics are disabled')
+  t.ok(ping, 'metrics for ping route')
+  t.equal(ping?.calls, 2, 'ping.calls === 2')
+  t.equal(ping?.errors, 0, 'ping.errors === 0')
+  t.ok(ping?.bytes.in > 0, 'ping.bytes.in > 0')
+  t.equal(ping?.latency.handler.count, 2, 'ping.latency.handler.count === 2')
+  t.ok(
+    ping?.latency.handler.p50 <= ping?.latency.handler.max,
+    'ping.latency.handler.p50 <= ping.latency.handler.max'
+  )
+
+  await ipc.send('ping')
+  response = await ipc.send('diagnostics.ipc')
+  t.equal(response.data.routes.ping.calls, 2, 'calls are not counted when disabled')
+})
@@ -13,6 +13,199 @@ test('extension.load(name) - simple', async (t) => {
     t.equal(simple.description, 'a simple IPC ping extension', 'description === "a simple IPC ping extension"')
     t.equal(simple.version, '0.1.2', 'version === "0.1.2"')
     t.equal(result.data, 'hello world', 'ipc://simple.ping mapped')
+
+    const json = await ipc.request('simple.json', {
+      value: JSON.stringify({ array: [1, -2, 3e2], nested: { ok: true }, text: 'a\tb\u00e9' })
+    })
+
+    t.deepEqual(
+      json.data,
+      { array: [1, -2, 300], nested: { ok: true }, text: 'a\tb\u00e9' },
+      'sapi_json_parse()'
+    )
+
+    const invalid = await ipc.request('simple.json', { value: '{"a":' })
+    t.ok(invalid.err, 'sapi_json_parse() fails on invalid input')
+    t.ok(await simple.unload(), 'unload')
+
+    const { memory } = await extension.stats()
+    t.ok(memory.releases > stats.memory.releases, 'extension.stats() memory.releases')
+    t.ok(memory.allocations > stats.memory.allocations, 'extension.stats() memory.allocations')
+    t.ok(memory.blocks <= memory.allocations, 'extension.stats() memory.blocks')
+  } catch (err) {
+    t.ifError(err)
+  }
+})
+
+test('sapi_json_parse() - number exactness', async (t) => {
+  const numbers = [
+    0,
+    1,
+    -1,
+    0.1,
+    0.1 + 0.2,
+    1.5,
+    -123.456,
+    1 / 3,
+    Math.PI,
+    1e21,
+    1e-7,
+    2.5e-5,
+    5e-324,
+    Number.MAX_VALUE,
+    Number.MIN_VALUE,
+    Number.EPSILON,
+    Number.MAX_SAFE_INTEGER,
+    Number.MIN_SAFE_INTEGER,
+    2 ** 53,
+    2 ** 53 + 2,
+    2 ** 64,
+    1681234567890.123,
+    123456789012345680000
+  ]
+
+  try {
+    const simple = await extension.load('simple-ipc-ping')
+    const result = await ipc.request('simple.json', {
+      value: JSON.stringify(numbers)
+    })
+
+    t.equal(result.data.length, numbers.length, 'every number is returned')
+
+    for (let i = 0; i < numbers.length; ++i) {
+      t.ok(Object.is(result.data[i], numbers[i]), `${numbers[i]} round trips`)
+    }
+
+    t.ok(await simple.unload(), 'unload')
+  } catch (err) {
+    t.ifError(err)
+  }
+})
+
+test('ipc replies are embedded in scripts as is', async (t) => {
+  const strings = [
+    '`template`',
+    '${globalThis.location}',
+    '$${}{',
+    '"quoted"',
+    'line\nline\r\nline',
+    '%41%2B+100%'
+  ]
+
+  try {
+    const simple = await extension.load('simple-ipc-ping')
+    const result = await ipc.request('simple.json', {
+      value: JSON.stringify(strings)
+    })
+
+    t.deepEqual(result.data, strings, 'strings round trip unchanged')
+    t.ok(await simple.unload(), 'unload')
+  } catch (err) {
+    t.ifError(err)
+  }
+})
+
+test('sapi_json_parse() - backslashes round trip', async (t) => {
+  const value = {
+    path: 'C:\\Users\\socket',
+    backspace: 'not\\back\\bspace',
+    quoted: '\\"quoted\\"',
+    escaped: JSON.parse('"\\u005c"'),
+    nested: ['\\', { '\\key': 'x\\y' }]
+  }
+
+  try {
+    const simple = await extension.load('simple-ipc-ping')
+    const json = await ipc.request('simple.json', { value: JSON.stringify(value) })
+    t.deepEqual(json.data, value, 'sapi_json_parse() reply')
+
+    const result = await ipc.request('simple.stringify', {
+      value: JSON.stringify(value)
+    }, {
+      responseType: 'arraybuffer'
+    })
+
+    t.deepEqual(
+      JSON.parse(new TextDecoder().decode(result.data)),
+      value,
+      'sapi_json_stringify(sapi_json_parse())'
+    )
+
+    // keys are looked up as given, so these only match decoded strings
+    const decoded = await ipc.request('simple.stringify', {
+      value: JSON.stringify({ 'C:\\Users\\socket': 'x\\y' }),
+      key: 'C:\\Users\\socket'
+    }, {
+      responseType: 'arraybuffer'
+    })
+
+    t.equal(
+      new TextDecoder().decode(decoded.data),
+      '"x\\\\y"',
+      'sapi_json_parse() decodes escaped backslashes'
+    )
+
+    const ping = await ipc.request('simple.ping', { value: 'C:\\Users' })
+    t.equal(ping.data, 'C:\\Users', 'sapi_json_string_create() escapes backslashes')
+
+    const invalid = await ipc.request('simple.stringify', { value: '"\\' })
+    t.ok(invalid.err, 'simple.stringify replies with the parse error')
+
+    t.ok(await simple.unload(), 'unload')
+  } catch (err) {
+    t.ifError(err)
+  }
+})
+
+test('sapi_ipc_result_set_bytes_owned() - owned bytes reply', async (t) => {
+  try {
+    const simple = await extension.load('simple-ipc-ping')
+    const value = 'x'.repeat(64 * 1024)
+    const result = await ipc.request('simple.bytes', { value }, {
+      responseType: 'arraybuffer'
+    })
+
+    t.equal(result.data?.byteLength, value.length, 'byte length')
+    t.equal(new TextDecoder().decode(result.data), value, 'bytes')
+    t.ok(await simple.unload(), 'unload')
+  } catch (err) {
+    t.ifError(err)
+  }
+})
+
+test('sapi_work_submit() - work runs off the event loop', async (t) => {
+  try {
+    const simple = await extension.load('simple-ipc-ping')
+    const results = await Promise.all([1000, 10000, 100000].map((value) =>
+      ipc.request('simple.primes', { value })
+    ))
+
+    t.deepEqual(results.map((result) => result.data), [168, 1229, 9592], 'prime counts')
+    t.ok(await simple.unload(), 'unload')
+  } catch (err) {
+    t.ifError(err)
+  }
+})
+
+test('sapi_ipc_router_map_binary() - raw request and reply bytes', async (t) => {
+  try {
+    const simple = await extension.load('simple-ipc-ping')
+    const bytes = new Uint8Array([1, 2, 3, 4, 5, 0, 255])
+    const result = await ipc.write('simple.reverse', {}, bytes, {
+      responseType: 'arraybuffer'
+    })
+
+    t.deepEqual(
+      Array.from(new Uint8Array(result.data)),
+      Array.from(bytes).reverse(),
+      'bytes reversed'
+    )
+
+    const empty = await ipc.write('simple.reverse', {}, null, {
+      responseType: 'arraybuffer'
+    })
+
+    t.ok(empty.err, 'missing bytes is an error')
     t.ok(await simple.unload(), 'unload')
   } catch (err) {
     t.ifError(err)
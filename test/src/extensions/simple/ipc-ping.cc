@@ -1,4 +1,6 @@
 #include <socket/extension.h>
+#include <stdlib.h>
+#include <string.h>
 
 void onping (
   sapi_context_t* context,
@@ -14,9 +16,202 @@ void onping (
   sapi_ipc_reply(result);
 }
 
+void onjson (
+  sapi_context_t* context,
+  sapi_ipc_message_t* message,
+  const sapi_ipc_router_t* router
+) {
+  const char* source = sapi_ipc_message_get_value(message);
+  sapi_json_any_t* json = sapi_json_parse(context, source, 0);
+  sapi_ipc_result_t* result = sapi_ipc_result_create(context, message);
+
+  if (json == NULL) {
+    sapi_ipc_result_set_json_error(
+      result,
+      sapi_json_any(sapi_json_string_create(
+        context,
+        sapi_context_error_get_message(context)
+      ))
+    );
+  } else {
+    sapi_ipc_result_set_json_data(result, json);
+  }
+
+  sapi_ipc_reply(result);
+}
+
+void onbytesfree (unsigned char* bytes, void* data) {
+  free(bytes);
+}
+
+void onbytes (
+  sapi_context_t* context,
+  sapi_ipc_message_t* message,
+  const sapi_ipc_router_t* router
+) {
+  const char* value = sapi_ipc_message_get_value(message);
+  const unsigned int size = value != NULL ? strlen(value) : 0;
+  unsigned char* bytes = (unsigned char*) malloc(size);
+  sapi_ipc_result_t* result = sapi_ipc_result_create(context, message);
+
+  // handed to the runtime as is and freed with `onbytesfree()`
+  memcpy(bytes, value, size);
+  sapi_ipc_result_set_bytes_owned(result, size, bytes, onbytesfree, NULL);
+  sapi_ipc_reply(result);
+}
+
+void onstringify (
+  sapi_context_t* context,
+  sapi_ipc_message_t* message,
+  const sapi_ipc_router_t* router
+) {
+  const char* source = sapi_ipc_message_get_value(message);
+  const char* key = sapi_ipc_message_get(message, "key");
+  sapi_json_any_t* json = sapi_json_parse(context, source, 0);
+  sapi_ipc_result_t* result = sapi_ipc_result_create(context, message);
+
+  if (json == NULL) {
+    sapi_ipc_result_set_json_error(
+      result,
+      sapi_json_any(sapi_json_string_create(
+        context,
+        sapi_context_error_get_message(context)
+      ))
+    );
+
+    sapi_ipc_reply(result);
+    return;
+  }
+
+  // look `key` up as given, so it only matches a decoded key
+  if (key != NULL && key[0] != 0) {
+    json = sapi_json_value_is_object(json)
+      ? sapi_json_object_get((sapi_json_object_t*) json, key)
+      : NULL;
+
+    if (json == NULL) {
+      sapi_ipc_result_set_status(result, 404);
+      sapi_ipc_result_set_json_error(
+        result,
+        sapi_json_any(sapi_json_string_create(context, "Missing key"))
+      );
+
+      sapi_ipc_reply(result);
+      return;
+    }
+  }
+
+  const char* string = sapi_json_stringify(json);
+  const unsigned int size = strlen(string);
+  unsigned char* bytes = (unsigned char*) malloc(size);
+
+  // replied to as bytes, so the page parses what `sapi_json_stringify()`
+  // wrote and not a value the runtime serialized
+  memcpy(bytes, string, size);
+  sapi_ipc_result_set_bytes_owned(result, size, bytes, onbytesfree, NULL);
+  sapi_ipc_reply(result);
+}
+
+void onreverse (
+  sapi_context_t* context,
+  sapi_ipc_message_t* message,
+  const unsigned char* bytes,
+  const unsigned int size,
+  const sapi_ipc_router_t* router
+) {
+  sapi_ipc_result_t* result = sapi_ipc_result_create(context, message);
+
+  if (size == 0) {
+    sapi_ipc_result_set_status(result, 400);
+    sapi_ipc_result_set_json_error(
+      result,
+      sapi_json_any(sapi_json_string_create(context, "Missing bytes"))
+    );
+  } else {
+    unsigned char* reversed = (unsigned char*) malloc(size);
+    for (unsigned int i = 0; i < size; ++i) {
+      reversed[i] = bytes[size - i - 1];
+    }
+
+    sapi_ipc_result_set_bytes_owned(result, size, reversed, onbytesfree, NULL);
+  }
+
+  sapi_ipc_reply(result);
+}
+
+struct primes {
+  sapi_context_t* context;
+  sapi_ipc_result_t* result;
+  long limit;
+  long count;
+};
+
+static sapi_work_queue_t* queue = NULL;
+
+void onprimeswork (sapi_work_t* work, void* data) {
+  struct primes* primes = (struct primes*) data;
+
+  for (long n = 2; n < primes->limit && !sapi_work_cancelled(work); ++n) {
+    bool prime = true;
+    for (long d = 2; d * d <= n; ++d) {
+      if (n % d == 0) {
+        prime = false;
+        break;
+      }
+    }
+
+    if (prime) {
+      primes->count++;
+    }
+  }
+}
+
+void onprimescomplete (
+  sapi_context_t* context,
+  sapi_work_t* work,
+  sapi_work_status_t status,
+  void* data
+) {
+  struct primes* primes = (struct primes*) data;
+  sapi_json_number_t* count = sapi_json_number_create(
+    primes->context,
+    status == SAPI_WORK_STATUS_COMPLETED ? primes->count : -1
+  );
+
+  sapi_ipc_result_set_json_data(primes->result, sapi_json_any(count));
+  sapi_ipc_reply(primes->result);
+  free(primes);
+}
+
+void onprimes (
+  sapi_context_t* context,
+  sapi_ipc_message_t* message,
+  const sapi_ipc_router_t* router
+) {
+  const char* value = sapi_ipc_message_get_value(message);
+  struct primes* primes = (struct primes*) malloc(sizeof(struct primes));
+
+  primes->context = context;
+  primes->result = sapi_ipc_result_create(context, message);
+  primes->limit = value != NULL ? atol(value) : 0;
+  primes->count = 0;
+
+  // counted on a worker thread and replied to on the event loop
+  sapi_work_submit(queue, onprimeswork, onprimescomplete, primes);
+}
+
 bool initialize (sapi_context_t* context, const void *data) {
   if (sapi_extension_is_allowed(context, "ipc,ipc_router,ipc_router_map")) {
     sapi_ipc_router_map(context, "simple.ping", onping, data);
+    sapi_ipc_router_map(context, "simple.json", onjson, data);
+    sapi_ipc_router_map(context, "simple.stringify", onstringify, data);
+    sapi_ipc_router_map(context, "simple.bytes", onbytes, data);
+    sapi_ipc_router_map_binary(context, "simple.reverse", onreverse, data);
+  }
+
+  if (sapi_extension_is_allowed(context, "work,work_queue,work_queue_create")) {
+    queue = sapi_work_queue_create(context, 2);
+    sapi_ipc_router_map(context, "simple.primes", onprimes, data);
   }
   return true;
 }
@@ -24,6 +219,16 @@ bool initialize (sapi_context_t* context, const void *data) {
 bool deinitialize (sapi_context_t* context, const void *data) {
   if (sapi_extension_is_allowed(context, "ipc,ipc_router,ipc_router_unmap")) {
     sapi_ipc_router_unmap(context, "simple.ping");
+    sapi_ipc_router_unmap(context, "simple.json");
+    sapi_ipc_router_unmap(context, "simple.stringify");
+    sapi_ipc_router_unmap(context, "simple.bytes");
+    sapi_ipc_router_unmap(context, "simple.reverse");
+    sapi_ipc_router_unmap(context, "simple.primes");
+  }
+
+  if (queue != NULL) {
+    sapi_work_queue_destroy(queue);
+    queue = NULL;
   }
   return true;
 }
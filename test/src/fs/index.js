@@ -162,11 +162,59 @@ if (process.platform !== 'ios') {
   })
 
   test('fs.fstat', async (t) => {})
+
+  test('fs.fsync', async (t) => {
+    const filename = `${TMPDIR}fs-fsync-${Date.now()}.bin`
+    const chunks = Array.from({ length: 64 }, () => crypto.randomBytes(512))
+    const expected = Buffer.concat(chunks)
+
+    await new Promise((resolve) => {
+      fs.open(filename, 'w', 0o666, { writeBehind: true }, (err, fd) => {
+        if (err) {
+          t.fail(err)
+          return resolve()
+        }
+
+        let pending = chunks.length
+        let failed = false
+
+        // positioned small writes are held and written together
+        chunks.forEach((chunk, i) => {
+          fs.write(fd, chunk, 0, chunk.length, i * chunk.length, (err, bytesWritten) => {
+            if (err || bytesWritten !== chunk.length) failed = true
+            if (--pending > 0) return
+
+            t.ok(!failed, 'held writes are replied to with their own size')
+
+            fs.fsync(fd, (err) => {
+              t.ifError(err, 'fs.fsync writes held writes')
+
+              fs.readFile(filename, (err, data) => {
+                if (err) t.fail(err)
+                t.ok(Buffer.compare(data, expected) === 0, 'held writes are written in order')
+                fs.close(fd, resolve)
+              })
+            })
+          })
+        })
+      })
+    })
+  })
   test('fs.lchmod', async (t) => {})
   test('fs.lchown', async (t) => {})
   test('fs.lutimes', async (t) => {})
   test('fs.link', async (t) => {})
-  test('fs.lstat', async (t) => {})
+  test('fs.lstat', async (t) => {
+    await new Promise((resolve) => {
+      fs.lstat(FIXTURES + 'file.txt', (err, stats) => {
+        if (err) t.fail(err)
+        t.equal(stats?.isFile(), true, 'stats are for a file')
+        t.equal(stats?.size, 9, 'stats have the size of the file')
+        resolve()
+      })
+    })
+  })
+
   if (os.platform() !== 'android') {
     test('fs.mkdir', async (t) => {
       const dirname = FIXTURES + Math.random().toString(16).slice(2)
@@ -218,6 +266,29 @@ if (process.platform !== 'ios') {
   })
 
   test('fs.readlink', async (t) => {})
+  test('fs.readv', async (t) => {
+    await new Promise((resolve) => {
+      fs.open(FIXTURES + 'file.txt', (err, fd) => {
+        if (err) {
+          t.fail(err)
+          return resolve()
+        }
+
+        const buffers = [Buffer.alloc(4), new Uint8Array(1), Buffer.alloc(16)]
+
+        fs.readv(fd, buffers, 0, (err, bytesRead) => {
+          if (err) t.fail(err)
+
+          t.equal(bytesRead, 9, 'fs.readv reads the whole file')
+          t.equal(buffers[0].toString(), 'test', 'first buffer is filled first')
+          t.equal(buffers[1][0], 0x20, 'a typed array buffer is filled in place')
+          t.equal(buffers[2].subarray(0, 4).toString(), '123\n', 'last buffer holds the rest')
+          fs.close(fd, resolve)
+        })
+      })
+    })
+  })
+
   test('fs.realpath', async (t) => {})
   test('fs.rename', async (t) => {})
   test('fs.rmdir', async (t) => {})
@@ -227,7 +298,41 @@ if (process.platform !== 'ios') {
   test('fs.truncate', async (t) => {})
   test('fs.unlink', async (t) => {})
   test('fs.utimes', async (t) => {})
-  test('fs.watch', async (t) => {})
+  test('fs.watch', async (t) => {
+    const directory = `${TMPDIR}fs-watch-${Date.now()}`
+    const filenames = Array.from({ length: 100 }, (_, i) => `file-${i}.txt`)
+    const changed = new Set()
+
+    await fs.promises.mkdir(directory)
+    await fs.promises.mkdir(path.join(directory, 'sub'))
+
+    const watcher = fs.watch(directory, { recursive: true, window: 20 }, (type, filename) => {
+      t.ok(type === 'rename' || type === 'change', 'changes have a type')
+      changed.add(filename)
+    })
+
+    await watcher.started
+
+    for (const filename of filenames) {
+      await fs.promises.writeFile(path.join(directory, filename), filename)
+    }
+
+    await fs.promises.writeFile(path.join(directory, 'sub', 'nested.txt'), 'nested')
+
+    for (let i = 0; i < 50 && changed.size < filenames.length + 1; ++i) {
+      await new Promise((resolve) => setTimeout(resolve, 20))
+    }
+
+    t.ok(filenames.every((filename) => changed.has(filename)), 'every written file is a change')
+    t.ok(changed.has(path.join('sub', 'nested.txt')), 'files in subdirectories are changes')
+
+    await new Promise((resolve) => {
+      watcher.once('close', resolve)
+      watcher.close()
+    })
+
+    t.ok(watcher.closed, 'watcher is closed')
+  })
   test('fs.write', async (t) => {})
 
   if (os.platform() !== 'android') {
@@ -284,5 +389,35 @@ if (process.platform !== 'ios') {
     })
   }
 
-  test('fs.writev', async (t) => {})
+  test('fs.writev', async (t) => {
+    const filename = `${TMPDIR}fs-writev-${Date.now()}.bin`
+    const header = Buffer.from('header')
+    const payload = crypto.randomBytes(32 * 1024)
+    const trailer = new Uint8Array([0xde, 0xad])
+    const expected = Buffer.concat([header, payload, Buffer.from(trailer)])
+
+    await new Promise((resolve) => {
+      fs.open(filename, 'w', (err, fd) => {
+        if (err) {
+          t.fail(err)
+          return resolve()
+        }
+
+        fs.writev(fd, [header, payload, trailer], 0, (err, bytesWritten) => {
+          if (err) t.fail(err)
+
+          t.equal(bytesWritten, expected.length, 'fs.writev writes every buffer')
+          fs.close(fd, resolve)
+        })
+      })
+    })
+
+    await new Promise((resolve) => {
+      fs.readFile(filename, (err, result) => {
+        if (err) t.fail(err)
+        else t.ok(Buffer.compare(result, expected) === 0, 'buffers are written in order')
+        resolve()
+      })
+    })
+  })
 }
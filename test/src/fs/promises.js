@@ -3,6 +3,7 @@ import path from 'socket:path'
 import fs from 'socket:fs/promises'
 import os from 'socket:os'
 import process from 'socket:process'
+import ipc from 'socket:ipc'
 
 import { FileHandle } from 'socket:fs/handle'
 import { test } from 'socket:test'
@@ -67,6 +68,16 @@ if (process.platform !== 'ios') {
     const data = await fs.readFile(FIXTURES + 'file.txt')
     t.ok(Buffer.isBuffer(data), 'buffer is returned')
     t.equal(data.slice(0, 8).toString(), 'test 123', 'buffer contains file contents')
+
+    const text = await fs.readFile(FIXTURES + 'file.txt', 'utf8')
+    t.equal(text.slice(0, 8), 'test 123', 'string is returned for an encoding')
+
+    try {
+      await fs.readFile(FIXTURES + 'does-not-exist.txt')
+      t.fail('fs.promises.readFile rejects for a missing file')
+    } catch (err) {
+      t.ok(err, 'fs.promises.readFile rejects for a missing file')
+    }
   })
 
   test('fs.promises.stat', async (t) => {
@@ -91,6 +102,76 @@ if (process.platform !== 'ios') {
     t.equal(stats.isCharacterDevice(), false, 'stats are not for a character device')
   })
 
+  test('fs.promises.walk', async (t) => {
+    const root = TMPDIR + 'ssc-socket-walk-' + Math.random().toString(16).slice(2)
+    await fs.mkdir(root + '/sub', { recursive: true })
+    await fs.writeFile(root + '/a.js', 'a')
+    await fs.writeFile(root + '/b.txt', 'bb')
+    await fs.writeFile(root + '/sub/c.js', 'ccc')
+
+    const walk = async (options) => {
+      const entries = []
+      for await (const entry of fs.walk(root, options)) {
+        entries.push(entry)
+      }
+
+      return entries.sort((a, b) => a.name < b.name ? -1 : 1)
+    }
+
+    let entries = await walk()
+    t.deepEqual(
+      entries.map((entry) => entry.name),
+      ['a.js', 'b.txt', 'sub', 'sub/c.js'],
+      'every entry is walked'
+    )
+
+    t.equal(entries[2].isDirectory(), true, 'directories are typed')
+    t.equal(entries[3].isFile(), true, 'files are typed')
+
+    entries = await walk({ include: ['*.js'] })
+    t.deepEqual(
+      entries.map((entry) => entry.name),
+      ['a.js', 'sub/c.js'],
+      'only included entries are walked'
+    )
+
+    entries = await walk({ ignore: ['sub'] })
+    t.deepEqual(
+      entries.map((entry) => entry.name),
+      ['a.js', 'b.txt'],
+      'ignored directories are not read'
+    )
+
+    entries = await walk({ depth: 0 })
+    t.deepEqual(
+      entries.map((entry) => entry.name),
+      ['a.js', 'b.txt', 'sub'],
+      'only entries of the root are walked at depth 0'
+    )
+
+    entries = await walk({ stat: true, include: ['*.js'] })
+    t.deepEqual(
+      entries.map((entry) => entry.stats?.size),
+      [1, 3],
+      'entries are walked with their stats'
+    )
+
+    try {
+      await fs.walk(root + '/missing').next()
+      t.fail('walking a missing path throws')
+    } catch (err) {
+      t.ok(err, 'walking a missing path throws')
+    }
+
+    // `fs.promises.rmdir()` is not implemented yet
+    for (const file of ['a.js', 'b.txt', 'sub/c.js']) {
+      await fs.unlink(root + '/' + file)
+    }
+
+    await ipc.send('fs.rmdir', { path: root + '/sub' })
+    await ipc.send('fs.rmdir', { path: root })
+  })
+
   if (os.platform() !== 'android') {
     test('fs.promises.writeFile', async (t) => {
       const file = FIXTURES + 'write-file.txt'
@@ -99,5 +180,21 @@ if (process.platform !== 'ios') {
       const contents = await fs.readFile(file)
       t.equal(contents.toString(), data, 'file contents are correct')
     })
+
+    test('fs.promises.readFile (large file)', async (t) => {
+      const file = FIXTURES + 'read-file-large.bin'
+      const data = Buffer.alloc(4 * 1024 * 1024 + 3)
+
+      for (let i = 0; i < data.length; ++i) {
+        data[i] = (i * 31 + 7) & 0xff
+      }
+
+      await fs.writeFile(file, data)
+      const contents = await fs.readFile(file)
+      t.equal(contents.length, data.length, 'whole file is read')
+      t.ok(Buffer.compare(contents, data) === 0, 'file contents are correct')
+
+      await fs.unlink(file)
+    })
   }
 }